@@ -0,0 +1,206 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : block-cache.h
+// Purpose     : LRU Block Read Cache for I2C Memories
+// Description : 
+//               This template class keeps a statically allocated set of fixed-size blocks read from a backing
+//               memory, replacing the least recently used block on a miss. Repeated reads of hot regions such as
+//               configuration or lookup tables are then served from RAM without bus transactions.
+//
+//               MEMORY is any class providing:
+//                   uint8_t read(uint16_t addr, uint8_t * data, uint16_t len);
+//                   uint8_t write(uint16_t addr, const uint8_t * data, uint16_t len);
+//                   void    setObserver(MemoryObserver * observer);
+//               Writes made through the backing memory, whether via this cache or not, are reported through the
+//               observer interface and drop any overlapping blocks. For an AT24CXX the backing memory is therefore
+//               its EEPROMWriteCache, the device's sole write path, rather than the AT24CXX driver, which reports no
+//               writes. The native_blockcache scenario (native/block-cache-main.cpp) measures hit rate and bytes
+//               avoided on a skewed table lookup.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h
+//               Custom   : N/A
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _BLOCK_CACHE_H
+#define _BLOCK_CACHE_H
+
+#include <Arduino.h>
+
+namespace Demo
+{
+
+class MemoryObserver
+{
+    public:
+        /**
+         * @brief Destructor; observers may be destroyed through this interface
+        */
+        virtual ~MemoryObserver() { }
+
+        /**
+         * @brief Notification that a range of the backing memory has been written
+         * @param addr First byte address written
+         * @param len Number of bytes written
+        */
+        virtual void invalidate(uint16_t addr, uint16_t len) = 0;
+};
+
+template <typename MEMORY, uint8_t BLOCK_SIZE=32, uint8_t BLOCK_COUNT=8>
+class BlockReadCache : public MemoryObserver
+{
+    public:
+        struct Stats
+        {
+            uint32_t hits;           // Block lookups served from RAM
+            uint32_t misses;         // Block lookups requiring a bus read
+            uint32_t bytes_avoided;  // Bytes served from RAM instead of the bus
+            uint32_t bus_bytes;      // Bytes fetched from the backing memory
+        };
+
+        /**
+         * @brief Constructor for BlockReadCache object
+         * @param memory Backing memory
+        */
+        BlockReadCache(MEMORY& memory)
+        : _memory(memory)
+        , _blocks()
+        , _clock(0)
+        , _stats()
+        {
+            _memory.setObserver(this);
+        }
+
+        /**
+         * @brief Read through the cache
+         * @param addr Byte address
+         * @param data Buffer into which data is read
+         * @param len Number of bytes
+         * @return Zero for success, nonzero for error from the backing memory
+        */
+        uint8_t read(uint16_t addr, uint8_t * data, uint16_t len)
+        {
+            while (len > 0)
+            {
+                uint8_t offset = addr % BLOCK_SIZE;
+                uint8_t chunk  = ((BLOCK_SIZE - offset) < len) ? (BLOCK_SIZE - offset) : (uint8_t)len;
+                Block * block  = lookup(addr - offset);
+
+                if (nullptr == block)
+                {
+                    block = &_blocks[victim()];
+                    block->valid = false;
+
+                    uint8_t error = _memory.read(addr - offset, block->data, BLOCK_SIZE);
+                    if (0 != error) return error;
+
+                    block->base  = addr - offset;
+                    block->valid = true;
+                    ++_stats.misses;
+                    _stats.bus_bytes += BLOCK_SIZE;
+                }
+                else
+                {
+                    ++_stats.hits;
+                    _stats.bytes_avoided += chunk;
+                }
+
+                block->used = ++_clock;
+                memcpy(data, &block->data[offset], chunk);
+
+                addr += chunk;
+                data += chunk;
+                len  -= chunk;
+            }
+
+            return 0;
+        }
+
+        /**
+         * @brief Write to the backing memory; overlapping blocks are invalidated
+         * @param addr Byte address
+         * @param data Data to write
+         * @param len Number of bytes
+         * @return Zero for success, nonzero for error from the backing memory
+        */
+        uint8_t write(uint16_t addr, const uint8_t * data, uint16_t len)
+        {
+            return _memory.write(addr, data, len);
+        }
+
+        /**
+         * @brief Drop blocks overlapping a written range
+         * @param addr First byte address written
+         * @param len Number of bytes written
+        */
+        void invalidate(uint16_t addr, uint16_t len)
+        {
+            for (uint8_t iter = 0; iter < BLOCK_COUNT; ++iter)
+            {
+                Block& block = _blocks[iter];
+
+                if (block.valid && (block.base < (uint32_t)addr + len) && (addr < (uint32_t)block.base + BLOCK_SIZE))
+                    block.valid = false;
+            }
+        }
+
+        /**
+         * @brief Drop all blocks
+        */
+        void clear()
+        {
+            for (uint8_t iter = 0; iter < BLOCK_COUNT; ++iter)
+                _blocks[iter].valid = false;
+        }
+
+        /**
+         * @brief Cache statistics since construction
+         * @return Reference to statistics
+        */
+        const Stats& stats() const { return _stats; }
+
+    private:
+        struct Block
+        {
+            uint16_t base;
+            bool     valid;
+            uint32_t used;
+            uint8_t  data[BLOCK_SIZE];
+        };
+
+        Block * lookup(uint16_t base)
+        {
+            for (uint8_t iter = 0; iter < BLOCK_COUNT; ++iter)
+            {
+                if (_blocks[iter].valid && (_blocks[iter].base == base))
+                    return &_blocks[iter];
+            }
+
+            return nullptr;
+        }
+
+        uint8_t victim() const
+        {
+            uint8_t lru = 0;
+
+            for (uint8_t iter = 0; iter < BLOCK_COUNT; ++iter)
+            {
+                if (!_blocks[iter].valid) return iter;
+                if (_blocks[iter].used < _blocks[lru].used) lru = iter;
+            }
+
+            return lru;
+        }
+
+        MEMORY&  _memory;
+        Block    _blocks[BLOCK_COUNT];
+        uint32_t _clock;
+        Stats    _stats;
+};
+
+}
+
+#endif // _BLOCK_CACHE_H
+
+// EOF
@@ -0,0 +1,135 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : build-time.h
+// Purpose     : Compile-Time Build Timestamp
+// Description : 
+//               These constexpr functions parse the compiler __DATE__ ("Mmm dd yyyy") and __TIME__ ("hh:mm:ss")
+//               strings into a timestamp and calendar fields at compile time, so that no string scanning or
+//               month name lookup is performed at boot. Functions are written to the C++11 constexpr subset.
+//
+//               Results are meant to initialize constexpr constants, which the compiler must evaluate; none of
+//               these functions, nor the month table, is then emitted, and at boot the cost is that of loading the
+//               constants, and sscanf() need not be linked. The checks below hold the parser to known dates.
+//
+//               As with the compiler strings themselves, the result is in the build machine's local time.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h, TimeLib.h
+//               Custom   : N/A
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _BUILD_TIME_H
+#define _BUILD_TIME_H
+
+#include <Arduino.h>
+#include <TimeLib.h>
+
+namespace Demo
+{
+
+namespace BuildTime
+{
+
+// Days preceding each month in a non-leap year, January first
+constexpr uint16_t DAYS_BEFORE_MONTH[12] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+
+constexpr uint8_t digit(char c)
+{
+    return (' ' == c) ? 0 : (uint8_t)(c - '0');
+}
+
+constexpr uint8_t twoDigits(const char *str)
+{
+    return digit(str[0]) * 10 + digit(str[1]);
+}
+
+constexpr uint8_t month(const char *date)
+{
+    return ('J' == date[0]) ? (('a' == date[1]) ? 1 : (('n' == date[2]) ? 6 : 7))
+         : ('F' == date[0]) ? 2
+         : ('M' == date[0]) ? (('r' == date[2]) ? 3 : 5)
+         : ('A' == date[0]) ? (('p' == date[1]) ? 4 : 8)
+         : ('S' == date[0]) ? 9
+         : ('O' == date[0]) ? 10
+         : ('N' == date[0]) ? 11
+         : 12;
+}
+
+constexpr uint8_t day(const char *date)
+{
+    return twoDigits(&date[4]);
+}
+
+constexpr uint16_t year(const char *date)
+{
+    return (uint16_t)twoDigits(&date[7]) * 100 + twoDigits(&date[9]);
+}
+
+constexpr uint8_t hour(const char *time)
+{
+    return twoDigits(&time[0]);
+}
+
+constexpr uint8_t minute(const char *time)
+{
+    return twoDigits(&time[3]);
+}
+
+constexpr uint8_t second(const char *time)
+{
+    return twoDigits(&time[6]);
+}
+
+constexpr bool isLeap(uint16_t y)
+{
+    return (0 == (y % 4)) && ((0 != (y % 100)) || (0 == (y % 400)));
+}
+
+// Leap days from year 1 through year y inclusive
+constexpr uint32_t leapDays(uint16_t y)
+{
+    return y / 4 - y / 100 + y / 400;
+}
+
+constexpr uint32_t daysSinceEpoch(const char *date)
+{
+    return 365UL * (year(date) - 1970) + (leapDays(year(date) - 1) - leapDays(1969))
+         + DAYS_BEFORE_MONTH[month(date) - 1] + (((month(date) > 2) && isLeap(year(date))) ? 1 : 0)
+         + (day(date) - 1);
+}
+
+/**
+ * @brief Timestamp from compiler date and time strings
+ * @param date String in __DATE__ format
+ * @param time String in __TIME__ format
+ * @return Seconds since 1970
+*/
+constexpr time_t timestamp(const char *date, const char *time)
+{
+    return (time_t)(((daysSinceEpoch(date) * 24UL + hour(time)) * 60UL + minute(time)) * 60UL + second(time));
+}
+
+/**
+ * @brief Calendar fields from compiler date and time strings
+ * @param date String in __DATE__ format
+ * @param time String in __TIME__ format
+ * @return Broken-down time; weekday is 1 for Sunday
+*/
+constexpr tmElements_t elements(const char *date, const char *time)
+{
+    return tmElements_t{ second(time), minute(time), hour(time),
+                         (uint8_t)(((daysSinceEpoch(date) + 4) % 7) + 1), // 1970-01-01 was a Thursday
+                         day(date), month(date), (uint8_t)CalendarYrToTm(year(date)) };
+}
+
+static_assert(timestamp("Jan  1 2024", "00:00:00") == 1704067200, "BuildTime: start of year");
+static_assert(timestamp("Feb 29 2024", "12:34:56") == 1709210096, "BuildTime: leap day");
+
+}
+
+}
+
+#endif // _BUILD_TIME_H
+
+// EOF
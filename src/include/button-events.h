@@ -0,0 +1,119 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : button-events.h
+// Purpose     : Edge-Interrupt Button Events
+// Description : 
+//               This class handles a push button through an external interrupt on both edges instead of periodic
+//               polling, so an idle button costs no CPU time. Each accepted edge is timestamped and queued as a
+//               press or release event for the main loop.
+//
+//               Debouncing is time based: the first edge after a quiet period is accepted at once, giving the
+//               lowest possible press latency, and further edges within the debounce window are ignored. Since
+//               contact bounce may end with the pin at a level other than the one last accepted, service() is
+//               called from the main loop to reconcile the pin level once no edge has been seen for a full
+//               debounce window.
+//
+//               Events are posted from both the ISR and service(), so the queue is a HAL::MPSCQueue.
+//
+//               An active low button is read against the internal pull-up; an active high button needs a
+//               pull-down on the board. A single instance is supported since the interrupt handler has no context
+//               argument.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h
+//               Custom   : hal.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _BUTTON_EVENTS_H
+#define _BUTTON_EVENTS_H
+
+#include <Arduino.h>
+#include "hal.h"
+
+namespace Demo
+{
+
+class ButtonEvents
+{
+    public:
+        enum EventType
+        {
+            BUTTON_PRESSED,
+            BUTTON_RELEASED
+        };
+
+        struct Event
+        {
+            EventType type;
+            uint32_t  time_us;
+        };
+
+        /**
+         * @brief Constructor for ButtonEvents object
+         * @param pin Button input pin
+         * @param debounce_us Debounce window in microseconds
+         * @param active_low True if the button pulls the pin low when pressed
+        */
+        ButtonEvents(uint8_t pin, uint32_t debounce_us=5000, bool active_low=true);
+
+        /**
+         * @brief Configure pin and attach edge interrupt
+        */
+        void init();
+
+        /**
+         * @brief Reconcile debounced state with pin level after the debounce window; call from main loop
+        */
+        void service();
+
+        /**
+         * @brief Remove oldest event from queue
+         * @param event Event output
+         * @return True if an event was available
+        */
+        bool pop(Event& event);
+
+        /**
+         * @brief Remove up to max queued events at once
+         * @param events Event output buffer
+         * @param max Capacity of output buffer
+         * @return Number of events removed
+        */
+        uint8_t popBatch(Event * events, uint8_t max);
+
+        /**
+         * @brief Debounced button state
+         * @return True if pressed
+        */
+        bool pressed() const;
+
+        /**
+         * @brief Number of events discarded due to a full queue
+         * @return Overflow count
+        */
+        uint32_t overflows() const;
+
+    private:
+        static const uint8_t QUEUE_SIZE = 8;
+
+        static void edgeISR();
+        void accept(bool pressed, uint32_t now);
+
+        static ButtonEvents * _instance;
+
+        HAL::GPIO         _pin;
+        uint32_t          _debounce_us;
+        bool              _active_low;
+        volatile bool     _pressed;
+        volatile uint32_t _last_edge_us;
+        volatile uint32_t _last_raw_us;
+        HAL::MPSCQueue<Event, QUEUE_SIZE> _queue;
+        volatile uint32_t _overflows;
+};
+
+}
+
+#endif // _BUTTON_EVENTS_H
+
+// EOF
@@ -0,0 +1,137 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : eeprom-cache.h
+// Purpose     : Page-Aware Write-Back Cache for AT24CXX EEPROM
+// Description : 
+//               This class buffers EEPROM writes in page-aligned cache lines so that small writes to the same page
+//               are coalesced into a single page write. Dirty lines are written back on eviction, on flush(), or
+//               from service() once writes have been idle for a while. A line with gaps between dirty bytes is
+//               filled from the device first so that each page costs exactly one write cycle.
+//
+//               After each page write the device is not waited on with a fixed delay. Instead the next access
+//               polls the device address until it acknowledges, which ends as soon as the internal write cycle
+//               completes. Reads through the cache return pending dirty data, so the cache may be used as the
+//               sole access path to the device. An optional MemoryObserver, such as a BlockReadCache, is told of
+//               every write so that it may drop stale data.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h
+//               Custom   : hal.h, block-cache.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _EEPROM_CACHE_H
+#define _EEPROM_CACHE_H
+
+#include <Arduino.h>
+#include "hal.h"
+#include "block-cache.h"
+
+namespace Demo
+{
+
+class EEPROMWriteCache
+{
+    public:
+        static const uint8_t PAGE_SIZE   = 64;
+        static const uint8_t CACHE_LINES = 2;
+
+        struct Stats
+        {
+            uint32_t bytes;          // Bytes accepted from callers
+            uint32_t naive_writes;   // Page writes had each caller write gone straight to the device
+            uint32_t page_writes;    // Page writes actually issued
+            uint32_t fill_reads;     // Reads issued to fill gaps in partially dirty lines
+            uint32_t ack_polls;      // Address polls issued while waiting on write cycles
+            uint32_t bus_us;         // Time spent in page writes and write cycle polling
+        };
+
+        /**
+         * @brief Constructor for EEPROMWriteCache object
+         * @param i2c_bus I2C bus on which the EEPROM resides
+         * @param address I2C address of EEPROM
+         * @param wp_pin Write protect pin; held high except during page writes
+        */
+        EEPROMWriteCache(HAL::I2C& i2c_bus, uint8_t address, uint8_t wp_pin);
+
+        /**
+         * @brief Drive the write protect pin high; call once before any write
+        */
+        void init();
+
+        /**
+         * @brief Write data through the cache
+         * @param addr EEPROM byte address
+         * @param data Data to write
+         * @param len Number of bytes
+         * @return Zero for success, nonzero for error during a required eviction
+        */
+        uint8_t write(uint16_t addr, const uint8_t * data, uint16_t len);
+
+        /**
+         * @brief Read data, including any pending cached writes
+         * @param addr EEPROM byte address
+         * @param data Buffer into which data is read
+         * @param len Number of bytes
+         * @return Zero for success, nonzero for error
+        */
+        uint8_t read(uint16_t addr, uint8_t * data, uint16_t len);
+
+        /**
+         * @brief Write back all dirty lines
+         * @return Zero for success, nonzero for error
+        */
+        uint8_t flush();
+
+        /**
+         * @brief Write back dirty lines that have been idle; call periodically
+         * @param idle_ms Minimum time since a line was last written
+         * @return Zero for success, nonzero for error
+        */
+        uint8_t service(uint32_t idle_ms=1000);
+
+        /**
+         * @brief Wait until any pending internal write cycle completes
+         * @return Zero for success, nonzero on timeout
+        */
+        uint8_t waitReady();
+
+        /**
+         * @brief Register an observer to be notified of writes
+         * @param observer Observer, or nullptr to remove
+        */
+        void setObserver(MemoryObserver * observer);
+
+        /**
+         * @brief Cache statistics since construction
+         * @return Reference to statistics
+        */
+        const Stats& stats() const;
+
+    private:
+        struct Line
+        {
+            uint16_t page;
+            bool     valid;
+            uint64_t dirty;
+            uint32_t touched_ms;
+            uint8_t  data[PAGE_SIZE];
+        };
+
+        Line *  lineFor(uint16_t page, uint8_t * error);
+        uint8_t writeBack(Line& line);
+
+        HAL::I2C&        _i2c_bus;
+        HAL::GPIO        _wp_pin;
+        uint8_t          _address;
+        bool             _write_pending;
+        Line             _lines[CACHE_LINES];
+        MemoryObserver * _observer;
+        Stats            _stats;
+};
+
+}
+
+#endif // _EEPROM_CACHE_H
+
+// EOF
@@ -0,0 +1,143 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : eeprom-log.h
+// Purpose     : Log-Structured Time-Series Store for AT24CXX EEPROM
+// Description : 
+//               This class stores timestamped sensor records in an append-only ring of EEPROM pages. Records are
+//               batched in RAM and written a full 64-byte page at a time, and pages are written strictly in ring
+//               order so that write cycles are spread evenly across the region (wear levelling by rotation).
+//
+//               Page layout (little endian):
+//                   0  seq      uint32  Sequence number; seq % page_count equals the page's ring index
+//                   4  t0       uint32  Timestamp of first record
+//                   8  count    uint8   Number of records in page, 1 to RECORDS_PER_PAGE
+//                   9  crc      uint8   CRC-8 over the page with this byte taken as zero
+//                   10 reserved
+//                   12 records  8 x { uint16 dt, int16 temperature, int16 humidity }
+//                   60 reserved
+//
+//               Pages are written through an EEPROMWriteCache, which waits out the device write cycle by ACK
+//               polling rather than a fixed delay.
+//
+//               A page interrupted by power loss fails its CRC and is treated as unwritten. Since only the page
+//               after the newest can be torn, mount() locates the newest page by binary search over sequence
+//               numbers, and seek() locates a timestamp by binary search over page headers, each in O(log n)
+//               page reads. The search relies on page start times never decreasing, so a record timestamped
+//               before the newest one stored (after the clock is set back, for example) is stored at the newest
+//               time instead.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h
+//               Custom   : hal.h, eeprom-cache.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _EEPROM_LOG_H
+#define _EEPROM_LOG_H
+
+#include <Arduino.h>
+#include "hal.h"
+#include "eeprom-cache.h"
+
+namespace Demo
+{
+
+struct LogRecord
+{
+    uint32_t time;
+    int16_t  temperature;
+    int16_t  humidity;
+};
+
+class EEPROMLog
+{
+    public:
+        static const uint8_t  PAGE_SIZE        = 64;
+        static const uint8_t  RECORDS_PER_PAGE = 8;
+        static const uint16_t NO_PAGE          = 0xFFFF;
+
+        /**
+         * @brief Constructor for EEPROMLog object
+         * @param eeprom Write-back cache through which the EEPROM is accessed
+         * @param first_page First EEPROM page of the log region
+         * @param page_count Number of pages in the log region
+        */
+        EEPROMLog(EEPROMWriteCache& eeprom, uint16_t first_page, uint16_t page_count);
+
+        /**
+         * @brief Recover log state from EEPROM; call once at boot, after the cache's init()
+         * @return Zero for success, nonzero for bus error
+        */
+        uint8_t mount();
+
+        /**
+         * @brief Append a record; a page is written once RECORDS_PER_PAGE records are pending
+         * @param record Record to append; a timestamp before the newest appended is raised to it
+         * @return Zero for success, nonzero for bus error (record is kept pending)
+        */
+        uint8_t append(const LogRecord& record);
+
+        /**
+         * @brief Write any pending records as a partial page
+         * @return Zero for success, nonzero for bus error
+        */
+        uint8_t sync();
+
+        /**
+         * @brief Read stored and pending records at or after a given time, oldest first
+         * @param from Earliest timestamp of interest
+         * @param records Output buffer
+         * @param max Capacity of output buffer
+         * @return Number of records read
+        */
+        uint16_t read(uint32_t from, LogRecord * records, uint16_t max);
+
+        /**
+         * @brief Locate the page holding a given time
+         * @param t Timestamp
+         * @return Logical page index (0 for oldest) of the last page starting at or before t, or NO_PAGE
+        */
+        uint16_t seek(uint32_t t);
+
+        /**
+         * @brief Number of valid pages stored
+         * @return Page count
+        */
+        uint16_t pages() const;
+
+        /**
+         * @brief Number of page writes issued since construction
+         * @return Write count
+        */
+        uint32_t pageWrites() const;
+
+    private:
+        struct Page
+        {
+            uint32_t  seq;
+            uint32_t  t0;
+            uint8_t   count;
+            LogRecord records[RECORDS_PER_PAGE];
+        };
+
+        bool     readPage(uint16_t index, Page * page);
+        uint8_t  writePage(uint16_t index, const Page& page);
+        uint16_t physical(uint16_t logical) const;
+
+        EEPROMWriteCache& _eeprom;
+        uint16_t          _first_page;
+        uint16_t          _page_count;
+        uint16_t          _head;
+        uint16_t          _oldest;
+        uint16_t          _valid_pages;
+        uint32_t          _next_seq;
+        uint32_t          _last_time;
+        uint32_t          _page_writes;
+        Page              _pending;
+};
+
+}
+
+#endif // _EEPROM_LOG_H
+
+// EOF
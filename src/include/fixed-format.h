@@ -0,0 +1,50 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : fixed-format.h
+// Purpose     : Fixed-Point Text Formatting
+// Description : 
+//               These functions convert integer and fixed-point values to text without printf, so that neither
+//               floating point arithmetic nor the float-capable printf family need be linked. Values are passed
+//               as scaled integers (e.g. centi-degrees) along with the number of fractional digits.
+//
+//               Output is written to a caller-supplied buffer suitable for the SSD1306 driver print() or
+//               HAL::UART print(). Buffers must hold at least 12 characters plus any requested padding.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h
+//               Custom   : N/A
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _FIXED_FORMAT_H
+#define _FIXED_FORMAT_H
+
+#include <Arduino.h>
+
+namespace Demo
+{
+
+/**
+ * @brief Format a fixed-point value; equivalent to printf "%0<width>.<frac_digits>f" on value / 10^frac_digits
+ * @param str Output buffer; null-terminated on return
+ * @param value Scaled integer value
+ * @param frac_digits Number of digits after the decimal point
+ * @param width Minimum field width including sign and decimal point; zero padded
+ * @return Number of characters written, excluding terminator
+*/
+uint8_t formatFixed(char *str, int32_t value, uint8_t frac_digits, uint8_t width=0);
+
+/**
+ * @brief Format an unsigned integer; equivalent to printf "%0<width>u"
+ * @param str Output buffer; null-terminated on return
+ * @param value Value to format
+ * @param width Minimum field width; zero padded
+ * @return Number of characters written, excluding terminator
+*/
+uint8_t formatUnsigned(char *str, uint32_t value, uint8_t width=0);
+
+}
+
+#endif // _FIXED_FORMAT_H
+
+// EOF
@@ -0,0 +1,113 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-bench.h
+// Purpose     : HAL Microbenchmark Suite
+// Description :
+//               This class measures the cost of HAL primitives in processor cycles: GPIO and GPIOPort writes, SPI
+//               transfers, every I2C overload and scatter-gather transfers across payload sizes, I2C page transfers
+//               at each device clock and the cost of clock switching, UART printf, timer interrupt interval and
+//               entry latency, formatFixed() against a float snprintf() of the same text, and SPSCQueue and
+//               MPSCQueue push and pop. Each case is sampled individually with HAL::cycles(); the cost of the
+//               measurement itself is calibrated first and subtracted.
+//
+//               Results are printed as CSV lines prefixed "BENCH," between "BENCH_BEGIN" and "BENCH_END" markers
+//               so they can be captured from a serial log and compared run over run (tools/bench-compare.py):
+//
+//                   BENCH,<case>,<size>,<samples>,<min>,<mean>,<max>
+//
+//               Built with HAL_SPI1_SERCOM, a further case transfers one byte on each SPI channel back to back.
+//               Built with HAL_BENCH_TIMELIB, as by the bench env, per-field TimeLib calls, TimeCache (time-cache.h)
+//               and breakTime() are compared on a timestamp advancing a second per sample; the native build has
+//               no TimeLib and omits them.
+//
+//               DMA write cases (writeAsync) report both the cost to the caller of starting a transfer and of
+//               starting it and collecting its completion from dmaPoll(), the latter to within a microsecond.
+//
+//               I2C cases address the EEPROM, which must have its write protect pin held high so that the write
+//               cases are acknowledged but never start an internal write cycle. Its device clock entry is removed
+//               when the suite completes.
+//
+//               On the native backend cycles are virtual time at the nominal core clock, so only bus and delay
+//               costs appear; host execution time is not counted.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : hal.h, fixed-format.h, time-cache.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HAL_BENCH_H
+#define _HAL_BENCH_H
+
+#include <Arduino.h>
+#include "hal.h"
+
+namespace Demo
+{
+
+class HALBench
+{
+    public:
+        /**
+         * @brief Constructor for HALBench object
+         * @param serial Port on which results are printed
+         * @param i2c_bus I2C bus under test
+         * @param spi_bus SPI bus under test
+         * @param timer Timer under test; its ISR is replaced while the suite runs
+         * @param i2c_address Write protected I2C memory on which to run the I2C cases
+        */
+        HALBench(HAL::UART& serial, HAL::I2C& i2c_bus, HAL::SPI& spi_bus, HAL::Timer& timer, uint8_t i2c_address);
+
+        /**
+         * @brief Run all cases and print results
+         * @return Number of cases reported
+        */
+        uint16_t run();
+
+    private:
+        class Sampler
+        {
+            public:
+                Sampler(uint32_t overhead);
+                void begin();
+                void end();
+                void add(uint32_t cycles);
+                void print(HAL::UART& serial, const char * name, uint32_t size) const;
+
+            private:
+                uint32_t _overhead;
+                uint32_t _start;
+                uint32_t _samples;
+                uint32_t _min;
+                uint32_t _max;
+                uint64_t _total;
+        };
+
+        void runGPIO();
+        void runSPI();
+        void runI2C();
+        void runI2CClock();
+        void runUART();
+        void runTimer();
+        void runFormat();
+#if defined(HAL_BENCH_TIMELIB)
+        void runTime();
+#endif
+        void runQueue();
+
+        static void timerISR();
+
+        HAL::UART&  _serial;
+        HAL::I2C&   _i2c_bus;
+        HAL::SPI&   _spi_bus;
+        HAL::Timer& _timer;
+        uint8_t     _i2c_address;
+        uint32_t    _overhead;
+        uint16_t    _cases;
+};
+
+}
+
+#endif // _HAL_BENCH_H
+
+// EOF
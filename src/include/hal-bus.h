@@ -0,0 +1,59 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-bus.h
+// Purpose     : Hardware Abstraction Layer Bus Registry
+// Description : 
+//               These accessors contribute a single shared bus object per physical channel to the HAL of a larger
+//               overall project. Drivers, the GPIOPort implementation and the application all obtain their buses
+//               here rather than constructing their own, so that the in-use flag of an I2C object guards every
+//               user of the hardware, including expander writes from the timer ISR, and that per-object state such
+//               as device clocks and backoff is not split across copies.
+//
+//               Each object is constructed on first use, so references may be taken from static initializers in
+//               any translation unit. A channel the build does not map returns the channel 0 object, as an object
+//               constructed on it would use channel 0. Objects are not initialized here; the application calls
+//               init() once per channel.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : hal-i2c.h, hal-spi.h, hal-uart.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HAL_BUS_H
+#define _HAL_BUS_H
+
+#include <stdint.h>
+#include "hal-i2c.h"
+#include "hal-spi.h"
+#include "hal-uart.h"
+
+namespace HAL
+{
+
+/**
+ * @brief Shared I2C bus object
+ * @param channel Bus channel; unmapped channels return channel 0
+ * @return The one I2C object for the channel
+*/
+I2C& i2cBus(uint8_t channel=0);
+
+/**
+ * @brief Shared SPI bus object
+ * @param channel Bus channel; unmapped channels return channel 0
+ * @return The one SPI object for the channel
+*/
+SPI& spiBus(uint8_t channel=0);
+
+/**
+ * @brief Shared UART object
+ * @param channel Serial channel; unmapped channels return channel 0
+ * @return The one UART object for the channel
+*/
+UART& uartBus(uint8_t channel=0);
+
+}
+
+#endif // _HAL_BUS_H
+
+// EOF
@@ -0,0 +1,123 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-busstats.h
+// Purpose     : Hardware Abstraction Layer Bus Statistics
+// Description : 
+//               These optional counters contribute per-device bus utilization statistics to the HAL of a larger
+//               overall project. With HAL_BUS_STATS defined, every I2C transaction and SPI transfer is accounted to
+//               its bus, channel and device address: transactions, bytes, errors, NACKs, total and maximum busy
+//               time, and a latency histogram with power of two buckets. Bucket 0 counts operations under 1 us,
+//               bucket n those of [2^(n-1), 2^n) us, and the last bucket everything longer.
+//
+//               Up to HAL_BUS_STATS_DEVICES devices are tracked (default 8); operations on further devices are
+//               counted as untracked. Records are passed in by the bus instrumentation hooks (hal-instrument.h).
+//               Without HAL_BUS_STATS these counters are not compiled, so there is no code, RAM or timing cost.
+//
+//               busStatsDump() prints one CSV line per device between "BUS_STATS_BEGIN" and "BUS_STATS_END"
+//               markers; the window is the time since the counters were last cleared:
+//
+//                   BUS_STATS_BEGIN,<devices>,<window_us>,<untracked>
+//                   BUS_STATS,<bus>,<channel>,<addr>,<transactions>,<bytes>,<errors>,<nacks>,<busy_us>,<max_us>,
+//                             <bucket 0>,...,<bucket 15>
+//                   BUS_STATS_END
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : hal-instrument.h, hal-uart.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HAL_BUSSTATS_H
+#define _HAL_BUSSTATS_H
+
+#include <stdint.h>
+
+#if defined(HAL_BUS_STATS)
+
+#include "hal-instrument.h"
+#include "hal-uart.h"
+
+#if !defined(HAL_BUS_STATS_DEVICES)
+#define HAL_BUS_STATS_DEVICES 8
+#endif
+
+namespace HAL
+{
+
+struct DeviceStats
+{
+    static const uint8_t BUCKETS = 16;
+
+    uint8_t  bus;
+    uint8_t  channel;
+    uint8_t  addr;
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t errors;
+    uint32_t nacks;
+    uint32_t busy_us;
+    uint32_t max_us;
+    uint32_t histogram[BUCKETS];
+};
+
+/**
+ * @brief Account an operation to its device; called from instrumentRecord()
+ * @param start_us Start timestamp
+ * @param end_us End timestamp
+ * @param bus Bus type, one of BusType
+ * @param channel Bus channel
+ * @param addr Device address, or 0 where the bus has none
+ * @param bytes Bytes written and read
+ * @param error Error code returned by the operation; 0 on success
+*/
+void busStatsRecord(uint32_t start_us, uint32_t end_us, uint8_t bus, uint8_t channel, uint8_t addr, uint32_t bytes,
+                    uint8_t error);
+
+/**
+ * @brief Copy the counters of one device
+ * @param bus Bus type, one of BusType
+ * @param channel Bus channel
+ * @param addr Device address, or 0 where the bus has none
+ * @param stats Destination
+ * @return True if the device has been seen since the counters were cleared
+*/
+bool busStats(uint8_t bus, uint8_t channel, uint8_t addr, DeviceStats& stats);
+
+/**
+ * @brief Number of devices seen since the counters were cleared
+ * @return Device count
+*/
+uint8_t busStatsDevices();
+
+/**
+ * @brief Copy the counters of a device by index, in order of first appearance
+ * @param index Device index, less than busStatsDevices()
+ * @param stats Destination
+ * @return True on success, false if index is out of range
+*/
+bool busStatsAt(uint8_t index, DeviceStats& stats);
+
+/**
+ * @brief Time covered by the counters
+ * @return Microseconds since the counters were cleared
+*/
+uint32_t busStatsWindow();
+
+/**
+ * @brief Print the counters of all devices
+ * @param serial Port on which to print
+*/
+void busStatsDump(const UART& serial);
+
+/**
+ * @brief Reset all counters and start a new window
+*/
+void busStatsClear();
+
+}
+
+#endif // HAL_BUS_STATS
+
+#endif // _HAL_BUSSTATS_H
+
+// EOF
@@ -0,0 +1,72 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-critical.h
+// Purpose     : Hardware Abstraction Layer Critical Section
+// Description : 
+//               These functions and the scoped CriticalSection class contribute interrupt masking to the HAL of a
+//               larger overall project. Masking nests correctly: the prior interrupt state is saved on entry and
+//               restored on exit rather than unconditionally re-enabled.
+//
+//               compilerBarrier() orders plain memory accesses against a later store that an ISR observes, such
+//               as publishing a filled buffer by a single pointer store. On a single core MCU the CPU does not
+//               reorder them as an ISR sees them, so keeping the compiler from doing so is sufficient.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : N/A
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HAL_CRITICAL_H
+#define _HAL_CRITICAL_H
+
+#include <stdint.h>
+
+namespace HAL
+{
+
+/**
+ * @brief Mask interrupts
+ * @return Prior interrupt state, to be passed to restoreInterrupts()
+*/
+uint32_t disableInterrupts();
+
+/**
+ * @brief Restore interrupt state saved by disableInterrupts()
+ * @param state Prior interrupt state
+*/
+void restoreInterrupts(uint32_t state);
+
+/**
+ * @brief Keep the compiler from moving memory accesses across this point
+*/
+inline void compilerBarrier()
+{
+    __asm__ __volatile__ ("" ::: "memory");
+}
+
+class CriticalSection
+{
+    public:
+        /**
+         * @brief Mask interrupts for the lifetime of this object
+        */
+        CriticalSection() : _state(disableInterrupts()) { }
+
+        /**
+         * @brief Restore prior interrupt state
+        */
+        ~CriticalSection() { restoreInterrupts(_state); }
+
+    private:
+        CriticalSection(const CriticalSection&);
+        CriticalSection& operator=(const CriticalSection&);
+
+        uint32_t _state;
+};
+
+}
+
+#endif // _HAL_CRITICAL_H
+
+// EOF
@@ -0,0 +1,60 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-dma-hw.h
+// Purpose     : Hardware Abstraction Layer DMA Scheduler Backend
+// Description :
+//               This header divides the DMA scheduler of hal-dma.h between its portable part, the job table and
+//               completion queue in hal-dma.cpp, and the part each backend implements: the DMAC itself on target
+//               (hal-dma-hw.cpp), and the simulated transfer in native/hal-dma-hw.cpp. It is included only by the
+//               HAL sources.
+//
+//               A backend starts a job given the DMAC channel hal-dma.cpp claimed for it, and reports its end
+//               through dmaComplete(), from an interrupt, from dmaHwService() or from a simulated event.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : hal-dma.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HAL_DMA_HW_H
+#define _HAL_DMA_HW_H
+
+#include "hal-dma.h"
+
+namespace HAL
+{
+
+/**
+ * @brief Start a job on a DMAC channel claimed for it; implemented by the backend
+ * @param dma_channel DMAC channel, below HAL_DMA_CHANNELS
+ * @param request Request whose segments are all non-empty or skipped, with a valid total length
+*/
+void dmaHwStart(uint8_t dma_channel, const DMARequest& request);
+
+/**
+ * @brief Abort the transfer of a job that outlived its deadline; implemented by the backend
+ * @param dma_channel DMAC channel
+*/
+void dmaHwStop(uint8_t dma_channel);
+
+/**
+ * @brief Move a job towards its end while its bus waits on it, completing it if it has ended; implemented by
+ *        the backend and called with interrupts enabled
+ * @param dma_channel DMAC channel
+*/
+void dmaHwService(uint8_t dma_channel);
+
+/**
+ * @brief Note the end of the job of a DMAC channel if one is running, for dmaPoll() or dmaWait() to settle;
+ *        called by the backend with interrupts masked
+ * @param dma_channel DMAC channel
+ * @param error Zero or a DMA_ERROR_* code; on the native backend the simulated bus result
+*/
+void dmaComplete(uint8_t dma_channel, uint8_t error);
+
+}
+
+#endif // _HAL_DMA_HW_H
+
+// EOF
@@ -0,0 +1,157 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-dma.h
+// Purpose     : Hardware Abstraction Layer DMA Scheduler
+// Description :
+//               This scheduler contributes DMA driven bus writes to the HAL of a larger overall project. The I2C,
+//               SPI and UART classes submit their writeAsync() transfers here; each job claims a free DMAC channel
+//               for its duration, its segments are chained as linked descriptors so that a control byte and a
+//               caller-owned payload go out as one transfer, and the CPU is free until the job completes.
+//
+//               Completions are handed to the main loop as DMAEvent records through an MPSCQueue. The DMAC
+//               interrupt only notes that a job ended and how; its bus is then finished (an I2C STOP, a bus clear
+//               after an error), the job recorded and its event posted by dmaPoll(), which also ends any job that
+//               has outlived its deadline (an I2C device that stopped acknowledging, for example), or by dmaWait().
+//               A job holds its channel and its bus until then, so the main loop should poll while jobs are out.
+//               Segment data must stay untouched until the job's event has been collected.
+//
+//               HAL_DMA_CHANNELS DMAC channels are managed (default 4, from channel 0), each with up to
+//               HAL_DMA_SEGMENTS segments (default 4); HAL_DMA_EVENTS sets the completion queue depth (power of
+//               two, default 8). Events arriving to a full queue are counted and dropped. Jobs are recorded by
+//               the bus instrumentation hooks (hal-instrument.h) at completion.
+//
+//               On the native backend bytes reach the simulated devices when the job is submitted, and the bus
+//               time they take elapses in the background; completion is delivered once it has.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : hal-instrument.h, hal-queue.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HAL_DMA_H
+#define _HAL_DMA_H
+
+#include <stdint.h>
+#include "hal-instrument.h"
+
+#if !defined(HAL_DMA_CHANNELS)
+#define HAL_DMA_CHANNELS 4
+#endif
+
+#if !defined(HAL_DMA_SEGMENTS)
+#define HAL_DMA_SEGMENTS 4
+#endif
+
+#if !defined(HAL_DMA_EVENTS)
+#define HAL_DMA_EVENTS 8
+#endif
+
+namespace HAL
+{
+
+// Submission and completion results; I2C completions carry I2C_ERROR_* codes instead
+static const uint8_t DMA_ERROR_BUSY        = 1; // No DMAC channel free, or the bus already has a job
+static const uint8_t DMA_ERROR_LENGTH      = 2; // No data, too many segments, or a segment too long
+static const uint8_t DMA_ERROR_UNSUPPORTED = 3; // The channel has no SERCOM to serve (USB CDC)
+static const uint8_t DMA_ERROR_TRANSFER    = 4; // The DMAC reported a bus error
+static const uint8_t DMA_ERROR_TIMEOUT     = 5;
+
+// One contiguous source buffer of a DMA write
+struct DMASegment
+{
+    const uint8_t * data;
+    uint32_t        len;
+};
+
+// Completion of a writeAsync() job
+struct DMAEvent
+{
+    uint8_t  bus;     // BusType
+    uint8_t  channel; // Bus channel
+    uint8_t  addr;    // Device address, or 0 where the bus has none
+    uint8_t  tag;     // Caller's tag given to writeAsync()
+    uint8_t  error;   // Zero for success
+    uint32_t len;     // Bytes submitted
+};
+
+/**
+ * @brief Collect one completed job; call from the main loop. Jobs past their deadline are ended here first.
+ * @param event Completion output
+ * @return False if no completion is waiting
+*/
+bool dmaPoll(DMAEvent& event);
+
+/**
+ * @brief Number of DMAC channels not claimed by a job
+ * @return Free channel count
+*/
+uint8_t dmaChannelsFree();
+
+/**
+ * @brief Completions dropped because the event queue was full
+ * @return Dropped event count
+*/
+uint32_t dmaDropped();
+
+// Used by the bus implementations
+
+/**
+ * @brief Called when a job has ended, before its channel is released and its event posted; from dmaPoll() or
+ *        dmaWait() with interrupts enabled, never from the DMAC interrupt
+ * @param ctx Context given with the request
+ * @param error Zero, DMA_ERROR_TRANSFER or DMA_ERROR_TIMEOUT; on the native backend the result of the simulated bus
+ * @return Result reported in the event
+*/
+typedef uint8_t (*DMADone)(void * ctx, uint8_t error);
+
+struct DMARequest
+{
+    uint8_t            bus;        // BusType
+    uint8_t            channel;    // Bus channel
+    uint8_t            addr;       // Device address, or 0
+    uint8_t            tag;        // Caller's tag
+    uint8_t            trigger;    // DMAC trigger source of the peripheral (TRIGSRC)
+    volatile void *    dest;       // Peripheral data register
+    const DMASegment * segs;
+    uint8_t            count;
+    uint32_t           timeout_us; // From submission
+    DMADone            done;
+    void *             ctx;
+};
+
+/**
+ * @brief Check a segment list against the scheduler's limits
+ * @param segs Segments
+ * @param count Number of segments
+ * @return Total length, or zero if empty or over a limit
+*/
+uint32_t dmaLength(const DMASegment * segs, uint8_t count);
+
+/**
+ * @brief Start a job on a free DMAC channel; the peripheral must be ready to raise its trigger
+ * @param request Job description; the segment list itself is not kept
+ * @return Zero, DMA_ERROR_BUSY or DMA_ERROR_LENGTH
+*/
+uint8_t dmaSubmit(const DMARequest& request);
+
+/**
+ * @brief Check whether a bus channel has a job in progress
+ * @param bus BusType
+ * @param channel Bus channel
+ * @return True while a job is in progress
+*/
+bool dmaActive(uint8_t bus, uint8_t channel);
+
+/**
+ * @brief Wait for the job on a bus channel, if any, to end; blocking bus operations call this first
+ * @param bus BusType
+ * @param channel Bus channel
+*/
+void dmaWait(uint8_t bus, uint8_t channel);
+
+}
+
+#endif // _HAL_DMA_H
+
+// EOF
@@ -20,6 +20,10 @@
 #define GPIO_INPUT          INPUT
 #define GPIO_INPUT_PULLUP   INPUT_PULLUP
 
+#define GPIO_RISING         RISING
+#define GPIO_FALLING        FALLING
+#define GPIO_CHANGE         CHANGE
+
 namespace HAL
 {
 
@@ -56,6 +60,18 @@ class GPIO
         */
         uint8_t digitalRead() const;
 
+        /**
+         * @brief Attach external interrupt to pin
+         * @param isr Function to be called on each qualifying edge
+         * @param mode Edge selection; imitates Arduino framework in terms of mode value to behavior
+        */
+        void attachInterrupt(void (*isr)(), uint8_t mode) const;
+
+        /**
+         * @brief Detach external interrupt from pin
+        */
+        void detachInterrupt() const;
+
     private:
         uint8_t _pin_number;
 };
@@ -0,0 +1,91 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-i2c-hw.h
+// Purpose     : Hardware Abstraction Layer I2C Backend
+// Description :
+//               This header divides the I2C class of hal-i2c.h between its portable part in hal-i2c.cpp, which
+//               holds the device clock, backoff and recovery policy and makes its transactions through TwoWire,
+//               and the part each backend implements: the SERCOM behind each TwoWire on target (hal-i2c-hw.cpp),
+//               and the simulated bus in native/hal-i2c-hw.cpp, whose TwoWire stands in for the framework's. It is
+//               included only by the HAL sources.
+//
+//               Channel 1 exists when HAL_I2C1_SERCOM is defined, on either backend.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Arduino
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h, Wire.h
+//               Custom   : hal-dma.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HAL_I2C_HW_H
+#define _HAL_I2C_HW_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "hal-dma.h"
+
+namespace HAL
+{
+
+#if defined(HAL_I2C1_SERCOM)
+static const uint8_t I2C_CHANNELS = 2;
+#else
+static const uint8_t I2C_CHANNELS = 1;
+#endif
+
+/**
+ * @brief Framework bus object of a channel
+ * @param channel Bus channel, below I2C_CHANNELS
+ * @return TwoWire of the channel
+*/
+TwoWire& i2cHwWire(uint8_t channel);
+
+/**
+ * @brief Start the peripheral of a channel and hand it its pins
+ * @param channel Bus channel
+*/
+void i2cHwBegin(uint8_t channel);
+
+/**
+ * @brief Set the bus clock of a channel, with the bus timeouts that bound a stalled transfer
+ * @param channel Bus channel
+ * @param hz Bus clock
+*/
+void i2cHwClock(uint8_t channel, uint32_t hz);
+
+/**
+ * @brief Clock out a device holding SDA low, generate a stop, then restart the peripheral at a clock
+ * @param channel Bus channel
+ * @param hz Bus clock to restart at
+ * @return Zero if both lines are released, I2C_ERROR_BUS otherwise
+*/
+uint8_t i2cHwClear(uint8_t channel, uint32_t hz);
+
+/**
+ * @brief Fill in the DMAC trigger and destination of a DMA write request
+ * @param channel Bus channel
+ * @param request Request
+*/
+void i2cHwWriteRequest(uint8_t channel, DMARequest& request);
+
+/**
+ * @brief Address the device once a DMA write has been submitted, starting its data phase
+ * @param channel Bus channel
+ * @param addr Target I2C address
+ * @param len Length of the write, up to 255
+*/
+void i2cHwWriteStart(uint8_t channel, uint8_t addr, uint32_t len);
+
+/**
+ * @brief End a DMA write: wait for its last acknowledge, issue the stop and map its outcome to a result
+ * @param channel Bus channel
+ * @param error Completion error given by the DMA scheduler
+ * @return Zero or an I2C_ERROR_* code
+*/
+uint8_t i2cHwWriteEnd(uint8_t channel, uint8_t error);
+
+}
+
+#endif // _HAL_I2C_HW_H
+
+// EOF
@@ -4,27 +4,76 @@
 // Description : 
 //               This multi-instance HAL I2C class definition contributes to the HAL of a larger overall project.
 //
+//               Each channel is its own bus, fixed at compile time: channel 0 is the variant's Wire (SERCOM2 on the
+//               Xiao, or HAL_I2C_SERCOM), and channel 1 is a further TwoWire when HAL_I2C1_SERCOM gives a SERCOM
+//               number with HAL_I2C1_SDA and HAL_I2C1_SCL on its pads 0 and 1 (HAL_I2C1_PIO selects the pin mux,
+//               PIO_SERCOM_ALT by default). Objects on an unmapped channel use channel 0. Device clocks, backoff
+//               and statistics are kept per channel; blocking transfers on two channels separate traffic but do
+//               not overlap it.
+//
+//               No transaction waits indefinitely: waits on the bus are bounded by deadlines, and a bus error or
+//               timeout is followed by a bus clear. On target the SERCOM's SCL low timeout ends any transfer during
+//               which SCL is held low for 25-35 ms, so devices stretching the clock for longer (such as the HTU21D
+//               in hold master mode) are not supported and must be used in a mode that releases the bus.
+//
+//               A device that fails to acknowledge its address (or times out) I2C_BACKOFF_THRESHOLD times in a
+//               row is skipped for an exponentially growing interval, returning I2C_ERROR_BACKOFF without touching
+//               the bus, with a single attempt let through as each interval ends. Any success clears the backoff;
+//               other errors (a data NACK, a bus error) neither count nor clear it. probe() is never skipped and
+//               its NACKs are not counted, so acknowledge polling of a busy memory is unaffected.
+//
+//               transfer() takes a transaction as lists of segments, so that a register address and a caller-owned
+//               payload, or a read spread across several caller structures, go out under one address without the
+//               caller assembling them in a staging buffer. Unlike the fixed shape overloads it issues no
+//               address-only write around the read. Wire still copies the write segments into its transmit buffer,
+//               and a read longer than Wire's 32 byte receive buffer is made as several reads, each a separate
+//               transaction ended by a stop, so only a read of up to 32 bytes follows the write in one transaction.
+//
+//               writeAsync() sends a write by DMA (hal-dma.h) under the SERCOM's own length counter, up to 255
+//               bytes, while the CPU continues; the completion event carries the I2C_ERROR_* result, which is
+//               accounted to the device as for any transaction. HAL_I2C_DMAC_TX names the DMAC trigger of the
+//               SERCOM behind channel 0. The STOP ending the write, and any bus clear after an error, are issued
+//               when dmaPoll() collects the completion rather than from the DMAC interrupt, so the bus stays held
+//               until then (at most the SCL low timeout on target). Blocking transactions first wait for the
+//               channel's job to end.
+//
 // Language    : C++
 // Platform    : Portable
 // Framework   : Portable
 // Copyright   : MIT License 2024, John Greenwell
 // Requires    : External : Arduino.h
-//               Custom   : N/A
+//               Custom   : hal-dma.h
 //--------------------------------------------------------------------------------------------------------------------
 #ifndef _HAL_I2C_H
 #define _HAL_I2C_H
 
 #include <Arduino.h>
+#include "hal-dma.h"
 
 namespace HAL
 {
 
+// Transaction results; 1 to 4 as returned by Wire.endTransmission()
+static const uint8_t I2C_ERROR_LENGTH    = 1; // Also returned when the bus object is in use
+static const uint8_t I2C_ERROR_NACK_ADDR = 2;
+static const uint8_t I2C_ERROR_NACK_DATA = 3;
+static const uint8_t I2C_ERROR_BUS       = 4;
+static const uint8_t I2C_ERROR_TIMEOUT   = 5;
+static const uint8_t I2C_ERROR_BACKOFF   = 6;
+
+// One contiguous buffer of a scatter-gather transaction
+struct I2CSegment
+{
+    uint8_t * data; // In a read segment, nullptr drops its bytes
+    uint32_t  len;
+};
+
 class I2C
 {
     public:
         /**
          * @brief Constructor for I2C object
-         * @param i2c_channel Identifier value in case multiple I2C channels used
+         * @param i2c_channel Bus channel, 0 or a channel mapped at compile time
         */
         I2C(uint8_t i2c_channel=0);
 
@@ -137,12 +186,94 @@ class I2C
         */
         uint8_t writeRead(uint8_t addr, uint16_t reg, uint8_t * data, uint32_t len);
 
+        /**
+         * @brief Scatter-gather transaction: the write segments back to back under one address, then, if there are
+         *        read segments, a repeated start and a read filled segment by segment. Without write segments only
+         *        the read is made. Write segments are copied into the Wire transmit buffer and together must fit
+         *        it. Reads are made in chunks of up to 32 bytes, the Wire receive buffer; each chunk after the first
+         *        is a separate read transaction, since Wire ends every read with a stop.
+         * @param addr Target I2C address
+         * @param wr_segs Write segments; may be nullptr if wr_count is zero
+         * @param wr_count Number of write segments
+         * @param r_segs Read segments; may be nullptr if r_count is zero
+         * @param r_count Number of read segments
+         * @param stopbit Default/False: repeated start, True: stop, restart
+         * @return Zero for success, nonzero for error; I2C_ERROR_LENGTH if the write segments do not fit
+        */
+        uint8_t transfer(uint8_t addr, const I2CSegment * wr_segs, uint8_t wr_count,
+                         const I2CSegment * r_segs=nullptr, uint8_t r_count=0, bool stopbit=false);
+
+        /**
+         * @brief Write by DMA; returns once the transfer is started, and its completion is collected with dmaPoll()
+         * @param addr Target I2C address
+         * @param segs Segments sent back to back under one address; list and data must stay valid until completion
+         * @param count Number of segments, up to HAL_DMA_SEGMENTS
+         * @param tag Caller's value returned in the completion event
+         * @return Zero if started, I2C_ERROR_BACKOFF, DMA_ERROR_BUSY or DMA_ERROR_LENGTH
+        */
+        uint8_t writeAsync(uint8_t addr, const DMASegment * segs, uint8_t count, uint8_t tag=0);
+
+        /**
+         * @brief Address-only transaction to check whether a device acknowledges
+         * @param addr Target I2C address
+         * @return True if the device acknowledged its address
+        */
+        bool probe(uint8_t addr);
+
         /**
          * @brief Check whether I2C bus is currently in use
          * @return True for busy, false for available
         */
         bool busy() const;
 
+        /**
+         * @brief Set the maximum clock of one device; the bus is switched to it when that device is addressed
+         *        and back to the init() baudrate for devices without an entry. Entries are shared by all I2C
+         *        objects on the channel.
+         * @param addr Target I2C address
+         * @param max_hz Device maximum clock, up to 1000000 (Fast-mode Plus); zero returns it to the bus clock
+         * @return True on success, false if the device table is full
+        */
+        bool setDeviceClock(uint8_t addr, uint32_t max_hz);
+
+        /**
+         * @brief Current bus clock
+         * @return Clock in Hz
+        */
+        uint32_t clock() const;
+
+        /**
+         * @brief Number of bus clock changes made when the addressed device changed
+         * @return Switch count
+        */
+        uint32_t clockSwitches() const;
+
+        /**
+         * @brief Processor cycles spent changing the bus clock, for comparison against transaction time
+         * @return Total cycles across all switches
+        */
+        uint32_t clockSwitchCycles() const;
+
+        /**
+         * @brief Clear a stuck bus: clock SCL until a device holding SDA low releases it, generate a stop and
+         *        reinitialize the peripheral at the current clock
+         * @return Zero if both lines are released, I2C_ERROR_BUS otherwise
+        */
+        uint8_t recover();
+
+        /**
+         * @brief Number of bus clears, whether requested or made after a bus error or timeout
+         * @return Recovery count
+        */
+        uint32_t recoveries() const;
+
+        /**
+         * @brief Check whether transactions to a device are currently being skipped after repeated failures
+         * @param addr Target I2C address
+         * @return True while the device is backing off
+        */
+        bool backingOff(uint8_t addr) const;
+
     private:
         uint8_t _i2c_channel;
         uint8_t _i2c_error;
@@ -0,0 +1,73 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-instrument.h
+// Purpose     : Hardware Abstraction Layer Bus Instrumentation
+// Description : 
+//               These hooks mark the start and end of each I2C transaction, SPI transfer and UART read or write in
+//               the HAL bus implementations. Completed operations are passed to the bus trace recorder
+//               (hal-trace.h, enabled by HAL_TRACE) and the per-device bus statistics (hal-busstats.h, enabled by
+//               HAL_BUS_STATS). With neither defined the hooks expand to nothing.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : N/A
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HAL_INSTRUMENT_H
+#define _HAL_INSTRUMENT_H
+
+#include <stdint.h>
+
+namespace HAL
+{
+
+enum BusType : uint8_t
+{
+    BUS_I2C  = 0,
+    BUS_SPI  = 1,
+    BUS_UART = 2
+};
+
+}
+
+#if defined(HAL_TRACE) || defined(HAL_BUS_STATS)
+
+namespace HAL
+{
+
+/**
+ * @brief Timestamp for the start of an instrumented operation
+ * @return Time in microseconds
+*/
+uint32_t instrumentStamp();
+
+/**
+ * @brief Report an operation ending now; safe from interrupt context
+ * @param start_us Start timestamp from instrumentStamp()
+ * @param bus Bus type, one of BusType
+ * @param channel Bus channel
+ * @param addr Device address, or 0 where the bus has none
+ * @param wr_len Bytes written
+ * @param rd_len Bytes read
+ * @param error Error code returned by the operation; 0 on success
+*/
+void instrumentRecord(uint32_t start_us, uint8_t bus, uint8_t channel, uint8_t addr, uint16_t wr_len,
+                      uint16_t rd_len, uint8_t error);
+
+}
+
+#define HAL_BUS_START(stamp)                                              uint32_t stamp = HAL::instrumentStamp()
+#define HAL_BUS_RECORD(stamp, bus, channel, addr, wr_len, rd_len, error)  \
+    HAL::instrumentRecord(stamp, bus, channel, addr, wr_len, rd_len, error)
+
+#else
+
+#define HAL_BUS_START(stamp)
+#define HAL_BUS_RECORD(stamp, bus, channel, addr, wr_len, rd_len, error)
+
+#endif // HAL_TRACE || HAL_BUS_STATS
+
+#endif // _HAL_INSTRUMENT_H
+
+// EOF
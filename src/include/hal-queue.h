@@ -0,0 +1,148 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-queue.h
+// Purpose     : Hardware Abstraction Layer Event Queues
+// Description : 
+//               These allocation-free ring buffer templates contribute ISR-to-main-loop handoff to the HAL of a
+//               larger overall project.
+//
+//               SPSCQueue is lock-free for exactly one producer (e.g. one ISR) and one consumer (e.g. the main
+//               loop). Indices are free-running and only ever written by one side. The producer publishes an
+//               element with a release store of the head index after writing the slot, and the consumer reads
+//               the head with an acquire load before reading the slot (and symmetrically for the tail), so slot
+//               contents are never observed before they are complete. On Cortex-M these compile to plain loads
+//               and stores separated by DMB barriers; no exclusive access instructions are needed, which the
+//               Cortex-M0+ lacks.
+//
+//               MPSCQueue permits any number of producers, such as ISRs at different priorities or an ISR and
+//               the main loop. Without exclusive access instructions a lock-free multi-producer reservation is
+//               not possible on the Cortex-M0+, so each push masks interrupts for the few instructions needed
+//               to claim and fill a slot. The consumer side is identical to SPSCQueue and never masks.
+//
+//               N must be a power of two.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : hal-critical.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HAL_QUEUE_H
+#define _HAL_QUEUE_H
+
+#include <stdint.h>
+#include "hal-critical.h"
+
+namespace HAL
+{
+
+template <typename T, uint32_t N>
+class SPSCQueue
+{
+    static_assert((N >= 2) && (0 == (N & (N - 1))), "Queue size must be a power of two");
+
+    public:
+        /**
+         * @brief Constructor for SPSCQueue object
+        */
+        SPSCQueue() : _head(0), _tail(0), _buffer() { }
+
+        /**
+         * @brief Add an element; producer side only
+         * @param val Element to add
+         * @return False if the queue was full
+        */
+        bool push(const T& val)
+        {
+            uint32_t head = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+
+            if ((head - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE)) >= N) return false;
+
+            _buffer[head & (N - 1)] = val;
+            __atomic_store_n(&_head, head + 1, __ATOMIC_RELEASE);
+
+            return true;
+        }
+
+        /**
+         * @brief Remove oldest element; consumer side only
+         * @param val Element output
+         * @return False if the queue was empty
+        */
+        bool pop(T& val)
+        {
+            uint32_t tail = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+
+            if (tail == __atomic_load_n(&_head, __ATOMIC_ACQUIRE)) return false;
+
+            val = _buffer[tail & (N - 1)];
+            __atomic_store_n(&_tail, tail + 1, __ATOMIC_RELEASE);
+
+            return true;
+        }
+
+        /**
+         * @brief Remove up to max elements with a single index update; consumer side only
+         * @param vals Element output buffer
+         * @param max Capacity of output buffer
+         * @return Number of elements removed
+        */
+        uint32_t popBatch(T * vals, uint32_t max)
+        {
+            uint32_t tail  = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+            uint32_t avail = __atomic_load_n(&_head, __ATOMIC_ACQUIRE) - tail;
+            uint32_t count = (avail < max) ? avail : max;
+
+            for (uint32_t iter = 0; iter < count; ++iter)
+                vals[iter] = _buffer[(tail + iter) & (N - 1)];
+
+            __atomic_store_n(&_tail, tail + count, __ATOMIC_RELEASE);
+
+            return count;
+        }
+
+        /**
+         * @brief Number of queued elements; exact only when called from one side with the other idle
+         * @return Element count
+        */
+        uint32_t size() const
+        {
+            return __atomic_load_n(&_head, __ATOMIC_ACQUIRE) - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+        }
+
+        /**
+         * @brief Check whether queue is empty
+         * @return True if no elements are queued
+        */
+        bool empty() const
+        {
+            return (0 == size());
+        }
+
+    protected:
+        uint32_t _head;
+        uint32_t _tail;
+        T        _buffer[N];
+};
+
+template <typename T, uint32_t N>
+class MPSCQueue : public SPSCQueue<T, N>
+{
+    public:
+        /**
+         * @brief Add an element; safe from any number of producers
+         * @param val Element to add
+         * @return False if the queue was full
+        */
+        bool push(const T& val)
+        {
+            CriticalSection lock;
+            return SPSCQueue<T, N>::push(val);
+        }
+};
+
+}
+
+#endif // _HAL_QUEUE_H
+
+// EOF
@@ -0,0 +1,218 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-samplering.h
+// Purpose     : Hardware Abstraction Layer Sample Ring
+// Description : 
+//               This template class contributes a fixed-capacity, allocation-free sample buffer with incremental
+//               statistics to the HAL of a larger overall project. Each push() updates, in amortized O(1) (see
+//               below for the worst case):
+//
+//                 - moving sum and mean over the last N samples
+//                 - moving minimum and maximum over the last N samples (monotonic wedges)
+//                 - exponentially weighted moving average with weight 1/2^shift
+//                 - decimated history: the mean of every D samples is stored in a ring of HISTORY entries
+//
+//               T is the sample type (typically a scaled integer) and ACC an accumulator type wide enough to hold
+//               the sum of N samples, or of 2^shift times the largest sample for the EWMA. The class depends
+//               only on standard integer types so that it may be exercised on a host with synthetic data, as by
+//               the native_samplering scenario (native/samplering-main.cpp).
+//
+//               The min/max wedges are amortized O(1) per push, since each sample enters and leaves a wedge at
+//               most once, but a single push is O(N) worst case: a sample below (or above) every queued one
+//               empties the whole wedge, e.g. the drop after a rise spanning the window. Everything else in push()
+//               is O(1). An ISR calling push() should budget for the worst case.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : N/A
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HAL_SAMPLERING_H
+#define _HAL_SAMPLERING_H
+
+#include <stdint.h>
+
+namespace HAL
+{
+
+template <typename T, uint16_t N, uint16_t HISTORY=8, typename ACC=int32_t>
+class SampleRing
+{
+    public:
+        /**
+         * @brief Constructor for SampleRing object
+         * @param ewma_shift EWMA weight exponent; each sample contributes 1/2^ewma_shift
+         * @param decimation Number of samples averaged into each history entry; zero selects N
+        */
+        SampleRing(uint8_t ewma_shift=3, uint16_t decimation=0)
+        : _data()
+        , _min_q()
+        , _max_q()
+        , _history()
+        , _count(0)
+        , _head(0)
+        , _min_front(0)
+        , _min_size(0)
+        , _max_front(0)
+        , _max_size(0)
+        , _sum(0)
+        , _ewma(0)
+        , _ewma_shift(ewma_shift)
+        , _ewma_seeded(false)
+        , _decimation(decimation ? decimation : N)
+        , _dec_count(0)
+        , _dec_sum(0)
+        , _hist_head(0)
+        , _hist_count(0)
+        { }
+
+        /**
+         * @brief Discard all samples and statistics
+        */
+        void clear()
+        {
+            _count = _head = 0;
+            _min_size = _max_size = 0;
+            _sum = _ewma = _dec_sum = 0;
+            _dec_count = _hist_head = _hist_count = 0;
+            _ewma_seeded = false;
+        }
+
+        /**
+         * @brief Add a sample; amortized O(1), O(N) worst case when a sample empties a min/max wedge
+         * @param val Sample value
+        */
+        void push(T val)
+        {
+            uint16_t slot = _head;
+
+            // Oldest sample leaves the window when full
+            if (N == _count)
+            {
+                _sum -= _data[slot];
+                if (_min_size && (_min_q[_min_front] == slot)) { _min_front = next(_min_front); --_min_size; }
+                if (_max_size && (_max_q[_max_front] == slot)) { _max_front = next(_max_front); --_max_size; }
+            }
+            else
+            {
+                ++_count;
+            }
+
+            _data[slot] = val;
+            _sum += val;
+            _head = next(_head);
+
+            // Monotonic wedges: drop queued samples that can no longer be the extreme
+            while (_min_size && !(_data[_min_q[back(_min_front, _min_size)]] < val)) --_min_size;
+            _min_q[(uint16_t)((_min_front + _min_size++) % N)] = slot;
+            while (_max_size && !(val < _data[_max_q[back(_max_front, _max_size)]])) --_max_size;
+            _max_q[(uint16_t)((_max_front + _max_size++) % N)] = slot;
+
+            // EWMA kept scaled by 2^shift; seeded with the first sample
+            if (_ewma_seeded)
+            {
+                _ewma += (ACC)val - (_ewma >> _ewma_shift);
+            }
+            else
+            {
+                _ewma = (ACC)val << _ewma_shift;
+                _ewma_seeded = true;
+            }
+
+            _dec_sum += val;
+            if (++_dec_count >= _decimation)
+            {
+                _history[_hist_head] = (T)(_dec_sum / (ACC)_decimation);
+                _hist_head = (uint16_t)((_hist_head + 1) % HISTORY);
+                if (_hist_count < HISTORY) ++_hist_count;
+                _dec_sum   = 0;
+                _dec_count = 0;
+            }
+        }
+
+        /**
+         * @brief Number of samples in the moving window
+         * @return Sample count, at most N
+        */
+        uint16_t count() const { return _count; }
+
+        /**
+         * @brief Most recent sample; undefined if empty
+         * @return Sample value
+        */
+        T latest() const { return _data[(uint16_t)((_head + N - 1) % N)]; }
+
+        /**
+         * @brief Sum of samples in the moving window
+         * @return Window sum
+        */
+        ACC sum() const { return _sum; }
+
+        /**
+         * @brief Mean of samples in the moving window; zero if empty
+         * @return Window mean, truncated toward zero
+        */
+        T mean() const { return _count ? (T)(_sum / (ACC)_count) : T(); }
+
+        /**
+         * @brief Minimum of samples in the moving window; undefined if empty
+         * @return Window minimum
+        */
+        T min() const { return _data[_min_q[_min_front]]; }
+
+        /**
+         * @brief Maximum of samples in the moving window; undefined if empty
+         * @return Window maximum
+        */
+        T max() const { return _data[_max_q[_max_front]]; }
+
+        /**
+         * @brief Exponentially weighted moving average
+         * @return EWMA value
+        */
+        T ewma() const { return (T)(_ewma >> _ewma_shift); }
+
+        /**
+         * @brief Number of decimated history entries available
+         * @return Entry count, at most HISTORY
+        */
+        uint16_t historyCount() const { return _hist_count; }
+
+        /**
+         * @brief Decimated history entry
+         * @param age Zero for the most recent entry, up to historyCount() - 1
+         * @return Mean of the decimation block
+        */
+        T history(uint16_t age) const { return _history[(uint16_t)((_hist_head + HISTORY - 1 - age) % HISTORY)]; }
+
+    private:
+        static uint16_t next(uint16_t idx) { return (uint16_t)((idx + 1) % N); }
+        static uint16_t back(uint16_t front, uint16_t size) { return (uint16_t)((front + size - 1) % N); }
+
+        T        _data[N];
+        uint16_t _min_q[N];
+        uint16_t _max_q[N];
+        T        _history[HISTORY];
+        uint16_t _count;
+        uint16_t _head;
+        uint16_t _min_front;
+        uint16_t _min_size;
+        uint16_t _max_front;
+        uint16_t _max_size;
+        ACC      _sum;
+        ACC      _ewma;
+        uint8_t  _ewma_shift;
+        bool     _ewma_seeded;
+        uint16_t _decimation;
+        uint16_t _dec_count;
+        ACC      _dec_sum;
+        uint16_t _hist_head;
+        uint16_t _hist_count;
+};
+
+}
+
+#endif // _HAL_SAMPLERING_H
+
+// EOF
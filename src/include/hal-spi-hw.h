@@ -0,0 +1,59 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-spi-hw.h
+// Purpose     : Hardware Abstraction Layer SPI Backend
+// Description :
+//               This header divides the SPI class of hal-spi.h between its portable part in hal-spi.cpp, which
+//               makes its transfers through SPIClass, and the part each backend implements: the SERCOM behind each
+//               SPIClass on target (hal-spi-hw.cpp), and the simulated bus in native/hal-spi-hw.cpp, whose SPIClass
+//               stands in for the framework's. It is included only by the HAL sources.
+//
+//               Channel 1 exists when HAL_SPI1_SERCOM is defined, on either backend.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Arduino
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h, SPI.h
+//               Custom   : hal-dma.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HAL_SPI_HW_H
+#define _HAL_SPI_HW_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "hal-dma.h"
+
+namespace HAL
+{
+
+#if defined(HAL_SPI1_SERCOM)
+static const uint8_t SPI_CHANNELS = 2;
+#else
+static const uint8_t SPI_CHANNELS = 1;
+#endif
+
+/**
+ * @brief Framework bus object of a channel
+ * @param channel Bus channel, below SPI_CHANNELS
+ * @return SPIClass of the channel
+*/
+SPIClass& spiHwPort(uint8_t channel);
+
+/**
+ * @brief Start the peripheral of a channel and hand it its pins
+ * @param channel Bus channel
+*/
+void spiHwBegin(uint8_t channel);
+
+/**
+ * @brief Fill in the DMAC trigger, destination and completion of a DMA write request
+ * @param channel Bus channel
+ * @param request Request
+*/
+void spiHwWriteRequest(uint8_t channel, DMARequest& request);
+
+}
+
+#endif // _HAL_SPI_HW_H
+
+// EOF
@@ -4,17 +4,28 @@
 // Description : 
 //               This multi-instance HAL SPI class definition contributes to the HAL of a larger overall project.
 //
+//               Each channel is its own bus, fixed at compile time: channel 0 is the variant's SPI, and channel 1 is
+//               a further SPIClass when HAL_SPI1_SERCOM gives a SERCOM number with HAL_SPI1_MOSI, HAL_SPI1_SCK and
+//               HAL_SPI1_MISO (HAL_SPI1_TX_PAD, HAL_SPI1_RX_PAD and HAL_SPI1_PIO select the pads and pin mux; pads 0
+//               and 1 for MOSI and SCK with the alternate mux by default). A transmit-only bus may give MISO the
+//               MOSI pin with an unconnected RX pad. Objects on an unmapped channel use channel 0.
+//
+//               writeAsync() sends segments by DMA (hal-dma.h) while the CPU continues; what the device returns
+//               is discarded. HAL_SPI_SERCOM and HAL_SPI_DMAC_TX name the SERCOM behind channel 0 and its DMAC
+//               trigger (SERCOM0 on the Xiao). A blocking transfer() first waits for the channel's job to end.
+//
 // Language    : C++
 // Platform    : Portable
 // Framework   : Portable
 // Copyright   : MIT License 2024, John Greenwell
 // Requires    : External : Arduino.h
-//               Custom   : N/A
+//               Custom   : hal-dma.h
 //--------------------------------------------------------------------------------------------------------------------
 #ifndef _HAL_SPI_H
 #define _HAL_SPI_H
 
 #include <Arduino.h>
+#include "hal-dma.h"
 
 namespace HAL
 {
@@ -24,7 +35,7 @@ class SPI
     public:
         /**
          * @brief Constructor for SPI object
-         * @param spi_channel Identifier value in case multiple SPI channels used
+         * @param spi_channel Bus channel, 0 or a channel mapped at compile time
         */
         SPI(uint8_t spi_channel=0);
 
@@ -40,6 +51,15 @@ class SPI
         */
         uint8_t transfer(uint8_t val) const;
 
+        /**
+         * @brief Write by DMA; returns once the transfer is started, and its completion is collected with dmaPoll()
+         * @param segs Segments sent back to back; list and data must stay valid until completion
+         * @param count Number of segments, up to HAL_DMA_SEGMENTS
+         * @param tag Caller's value returned in the completion event
+         * @return Zero if started, DMA_ERROR_BUSY or DMA_ERROR_LENGTH
+        */
+        uint8_t writeAsync(const DMASegment * segs, uint8_t count, uint8_t tag=0) const;
+
     private:
         uint8_t _spi_channel;
 };
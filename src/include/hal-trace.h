@@ -0,0 +1,88 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-trace.h
+// Purpose     : Hardware Abstraction Layer Bus Trace
+// Description : 
+//               This optional recorder contributes per-transaction bus tracing to the HAL of a larger overall
+//               project. With HAL_TRACE defined, each I2C transaction, SPI transfer and UART read or write appends
+//               a record of bus, channel, address, write and read lengths, start and end timestamps and error code
+//               to a fixed RAM ring; the oldest records are overwritten. HAL_TRACE_DEPTH sets the ring size (power
+//               of two, default 64 records of 16 bytes).
+//
+//               Records are passed in by the bus instrumentation hooks (hal-instrument.h). Without HAL_TRACE this
+//               recorder is not compiled, so there is no code, RAM or timing cost.
+//
+//               traceDump() prints the ring as CSV lines between "TRACE_BEGIN" and "TRACE_END" markers for
+//               conversion to Chrome trace JSON or VCD by tools/trace-convert.py:
+//
+//                   TRACE_BEGIN,<records>,<overwritten>
+//                   TRACE,<bus>,<channel>,<addr>,<start_us>,<end_us>,<wr_len>,<rd_len>,<error>
+//                   TRACE_END
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : hal-instrument.h, hal-uart.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HAL_TRACE_H
+#define _HAL_TRACE_H
+
+#include <stdint.h>
+
+#if defined(HAL_TRACE)
+
+#include "hal-instrument.h"
+#include "hal-uart.h"
+
+#if !defined(HAL_TRACE_DEPTH)
+#define HAL_TRACE_DEPTH 64
+#endif
+
+namespace HAL
+{
+
+struct TraceRecord
+{
+    uint32_t start_us;
+    uint32_t end_us;
+    uint16_t wr_len;
+    uint16_t rd_len;
+    uint8_t  bus;
+    uint8_t  channel;
+    uint8_t  addr;
+    uint8_t  error;
+};
+
+/**
+ * @brief Append a record to the trace ring; called from instrumentRecord()
+ * @param start_us Start timestamp
+ * @param end_us End timestamp
+ * @param bus Bus type, one of BusType
+ * @param channel Bus channel
+ * @param addr Device address, or 0 where the bus has none
+ * @param wr_len Bytes written
+ * @param rd_len Bytes read
+ * @param error Error code returned by the operation; 0 on success
+*/
+void traceRecord(uint32_t start_us, uint32_t end_us, uint8_t bus, uint8_t channel, uint8_t addr, uint16_t wr_len,
+                 uint16_t rd_len, uint8_t error);
+
+/**
+ * @brief Print the trace ring oldest first and clear it; recording is suspended while printing
+ * @param serial Port on which to print
+*/
+void traceDump(const UART& serial);
+
+/**
+ * @brief Discard all records
+*/
+void traceClear();
+
+}
+
+#endif // HAL_TRACE
+
+#endif // _HAL_TRACE_H
+
+// EOF
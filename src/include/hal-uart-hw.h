@@ -0,0 +1,61 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-uart-hw.h
+// Purpose     : Hardware Abstraction Layer UART Backend
+// Description :
+//               This header divides the UART class of hal-uart.h between its portable part in hal-uart.cpp, which
+//               makes its transfers through the channel's Stream, and the part each backend implements: the
+//               framework's Serial ports and the SERCOM behind a hardware UART on target (hal-uart-hw.cpp), and the
+//               simulated ports in native/hal-uart-hw.cpp. It is included only by the HAL sources.
+//
+//               Channel 1 exists when HAL_UART1_PORT is defined, on either backend, and is served by DMA when
+//               HAL_UART1_SERCOM is defined as well.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Arduino
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h
+//               Custom   : hal-dma.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HAL_UART_HW_H
+#define _HAL_UART_HW_H
+
+#include <Arduino.h>
+#include "hal-dma.h"
+
+namespace HAL
+{
+
+#if defined(HAL_UART1_PORT)
+static const uint8_t UART_CHANNELS = 2;
+#else
+static const uint8_t UART_CHANNELS = 1;
+#endif
+
+/**
+ * @brief Framework port object of a channel
+ * @param channel Port channel, below UART_CHANNELS
+ * @return Stream of the channel
+*/
+Stream& uartHwPort(uint8_t channel);
+
+/**
+ * @brief Start the port of a channel
+ * @param channel Port channel
+ * @param baud Line rate
+*/
+void uartHwBegin(uint8_t channel, uint32_t baud);
+
+/**
+ * @brief Fill in the DMAC trigger, destination and completion of a DMA write request
+ * @param channel Port channel
+ * @param request Request
+ * @return False if the channel has no SERCOM to serve
+*/
+bool uartHwWriteRequest(uint8_t channel, DMARequest& request);
+
+}
+
+#endif // _HAL_UART_HW_H
+
+// EOF
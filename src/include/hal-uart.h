@@ -4,17 +4,27 @@
 // Description : 
 //               This multi-instance HAL UART class definition contributes to the HAL of a larger overall project.
 //
+//               Channel 0 is the USB CDC Serial. Channel 1 is the hardware UART named by HAL_UART1_PORT (Serial1 on
+//               the Xiao, SERCOM4 on D6/D7); give its SERCOM number as HAL_UART1_SERCOM to have a clash with
+//               HAL_I2C1_SERCOM or HAL_SPI1_SERCOM rejected at compile time. Objects on an unmapped channel use
+//               channel 0.
+//
+//               writeAsync() sends segments by DMA (hal-dma.h) while the CPU continues, on channel 1 only when
+//               HAL_UART1_SERCOM is given; USB CDC has no SERCOM to serve. Bytes already queued by the blocking
+//               writes are sent first, and those writes wait for the channel's job to end.
+//
 // Language    : C++
 // Platform    : Portable
 // Framework   : Portable
 // Copyright   : MIT License 2024, John Greenwell
 // Requires    : External : Arduino.h
-//               Custom   : N/A
+//               Custom   : hal-dma.h
 //--------------------------------------------------------------------------------------------------------------------
 #ifndef _HAL_UART_H
 #define _HAL_UART_H
 
 #include <Arduino.h>
+#include "hal-dma.h"
 
 namespace HAL
 {
@@ -24,7 +34,7 @@ class UART
     public:
         /**
          * @brief Constructor for serial object
-         * @param serial_channel Identifier integer in case multiple serial objects used
+         * @param serial_channel Port channel, 0 or a channel mapped at compile time
         */
         UART(uint8_t serial_channel=0);
 
@@ -84,6 +94,15 @@ class UART
         */
         uint32_t println(const char *str) const;
 
+        /**
+         * @brief Write by DMA; returns once the transfer is started, and its completion is collected with dmaPoll()
+         * @param segs Segments sent back to back; list and data must stay valid until completion
+         * @param count Number of segments, up to HAL_DMA_SEGMENTS
+         * @param tag Caller's value returned in the completion event
+         * @return Zero if started, DMA_ERROR_BUSY, DMA_ERROR_LENGTH or DMA_ERROR_UNSUPPORTED
+        */
+        uint8_t writeAsync(const DMASegment * segs, uint8_t count, uint8_t tag=0) const;
+
         /**
          * @brief Check whether data is ready to be read from serial device
         */
@@ -35,9 +35,14 @@
 #define _HAL_H
 
 #include <Arduino.h>
+#include "hal-bus.h"
+#include "hal-critical.h"
+#include "hal-dma.h"
 #include "hal-gpio.h"
 #include "hal-gpioport.h"
 #include "hal-i2c.h"
+#include "hal-queue.h"
+#include "hal-samplering.h"
 #include "hal-spi.h"
 #include "hal-timer.h"
 #include "hal-uart.h"
@@ -75,6 +80,18 @@ uint32_t millis();
 */
 uint32_t micros();
 
+/**
+ * @brief Free-running processor cycle count for measuring short intervals; wraps around
+ * @return Processor cycles since start of timing, modulo 2^32
+*/
+uint32_t cycles();
+
+/**
+ * @brief Processor clock frequency against which cycles() counts
+ * @return Cycles per second
+*/
+uint32_t cpuFrequency();
+
 }
 
 #endif // _HAL_H
@@ -0,0 +1,117 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : htu21d-fixed.h
+// Purpose     : HTU21D Fixed-Point Measurement
+// Description : 
+//               This class reads the HTU21D temperature and humidity sensor over the HAL I2C port and converts
+//               raw readings with integer arithmetic only. Temperature is reported in centi-degrees Celsius and
+//               relative humidity in centi-percent, so that no soft-float routines are required on processors
+//               without an FPU. Use formatFixed() from fixed-format.h with two fractional digits for display.
+//
+//               Measurements may be taken either blocking, with measure(), or pipelined, by calling service()
+//               periodically. Neither uses hold master mode, in which the sensor stretches SCL for up to 50 ms
+//               and so would exceed the HAL's SCL low timeout (hal-i2c.h). The pipelined engine triggers a
+//               conversion, releases the bus for the datasheet conversion time, then collects the result and
+//               immediately triggers the next conversion, alternating temperature and humidity. The most recent
+//               values are always available from the getters without waiting.
+//
+//               Conversions follow the datasheet formulas:
+//                   T  = -46.85 + 175.72 * S_T  / 2^16
+//                   RH = -6     + 125    * S_RH / 2^16
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h
+//               Custom   : hal.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _HTU21D_FIXED_H
+#define _HTU21D_FIXED_H
+
+#include <Arduino.h>
+#include "hal.h"
+
+namespace Demo
+{
+
+class HTU21DFixed
+{
+    public:
+        static const uint8_t HTU21D_ADDRESS = 0x40;
+
+        /**
+         * @brief Constructor for HTU21DFixed object
+         * @param i2c_bus I2C bus on which the sensor resides
+         * @param address I2C address of sensor
+        */
+        HTU21DFixed(HAL::I2C& i2c_bus, uint8_t address=HTU21D_ADDRESS);
+
+        /**
+         * @brief Measure temperature and humidity, blocking for both conversion times (about 66 ms)
+         * @return Zero for success, nonzero for bus or checksum error
+        */
+        uint8_t measure();
+
+        /**
+         * @brief Advance the pipelined measurement engine; call periodically
+         * @return True if a new temperature or humidity value was collected
+        */
+        bool service();
+
+        /**
+         * @brief Temperature from last successful measurement
+         * @return Temperature in hundredths of a degree Celsius
+        */
+        int16_t getTemperature() const;
+
+        /**
+         * @brief Relative humidity from last successful measurement
+         * @return Relative humidity in hundredths of a percent, clamped to 0 to 10000
+        */
+        int16_t getHumidity() const;
+
+        /**
+         * @brief Convert raw temperature reading
+         * @param raw Raw 16-bit sensor value; status bits are ignored
+         * @return Temperature in hundredths of a degree Celsius
+        */
+        static int16_t convertTemperature(uint16_t raw);
+
+        /**
+         * @brief Convert raw humidity reading
+         * @param raw Raw 16-bit sensor value; status bits are ignored
+         * @return Relative humidity in hundredths of a percent, clamped to 0 to 10000
+        */
+        static int16_t convertHumidity(uint16_t raw);
+
+        /**
+         * @brief Validate sensor reply checksum
+         * @param data Three byte sensor reply: MSB, LSB, CRC
+         * @return True if checksum matches
+        */
+        static bool checkCRC(const uint8_t * data);
+
+    private:
+        enum State
+        {
+            STATE_IDLE,
+            STATE_TEMP,
+            STATE_HUMID
+        };
+
+        uint8_t readRaw(uint8_t command, uint32_t conv_ms, uint16_t * raw);
+        uint8_t trigger(State state);
+
+        HAL::I2C& _i2c_bus;
+        uint8_t   _address;
+        int16_t   _temperature;
+        int16_t   _humidity;
+        State     _state;
+        uint32_t  _trigger_ms;
+};
+
+}
+
+#endif // _HTU21D_FIXED_H
+
+// EOF
@@ -0,0 +1,133 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : oled-compositor.h
+// Purpose     : Retained-Mode OLED Field Compositor
+// Description : 
+//               This class keeps a small set of named text fields on top of the SSD1306 driver. Each field has a
+//               position, a width in characters, an optional printf-style format and its last rendered value. A
+//               field is redrawn into the driver frame buffer only when its value changes, and only the columns
+//               and pages touched by redrawn fields are pushed to the panel through OLEDIO.
+//
+//               Render cost is recorded per field so that expensive widgets may be identified.
+//
+//               Fields assume the default 6x8 pixel font at text size 1.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h
+//               Custom   : hal.h, ssd1306.h, oled-io.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _OLED_COMPOSITOR_H
+#define _OLED_COMPOSITOR_H
+
+#include <Arduino.h>
+#include "hal.h"
+#include "ssd1306.h"
+#include "oled-io.h"
+
+namespace Demo
+{
+
+class OLEDCompositor
+{
+    public:
+        static const uint8_t MAX_FIELDS      = 8;
+        static const uint8_t MAX_FIELD_CHARS = 21;  // 128 pixel panel at 6 pixels per character
+        static const uint8_t MAX_PAGES       = 8;   // 64 pixel panel at 8 pixels per page
+        static const uint8_t INVALID_FIELD   = 0xFF;
+
+        /**
+         * @brief Constructor for OLEDCompositor object
+         * @param display Initialized SSD1306 driver whose frame buffer is drawn into
+         * @param oled Partial addressing interface to the same display
+        */
+        OLEDCompositor(PeripheralIO::SSD1306& display, OLEDIO& oled);
+
+        /**
+         * @brief Register a field
+         * @param name Field name; must remain valid for the lifetime of the compositor
+         * @param x Column of field in pixels
+         * @param y Row of field in pixels
+         * @param width Width of field in characters; text beyond this is truncated
+         * @param format Optional printf-style format used by update(); must remain valid
+         * @return Field handle, or INVALID_FIELD if no slots remain
+        */
+        uint8_t addField(const char * name, uint8_t x, uint8_t y, uint8_t width, const char * format=nullptr);
+
+        /**
+         * @brief Look up field handle by name
+         * @param name Field name
+         * @return Field handle, or INVALID_FIELD if not found
+        */
+        uint8_t find(const char * name) const;
+
+        /**
+         * @brief Set field text directly
+         * @param field Field handle
+         * @param text Null-terminated text
+         * @return True if the value changed and the field is now pending redraw
+        */
+        bool set(uint8_t field, const char * text);
+
+        /**
+         * @brief Set field text using the format given when the field was added
+         * @param field Field handle; unsigned rather than uint8_t, as va_start() on a parameter subject to
+         *        promotion is undefined
+         * @return True if the value changed and the field is now pending redraw
+        */
+        bool update(unsigned field, ...);
+
+        /**
+         * @brief Force all fields to be redrawn on the next render
+        */
+        void invalidate();
+
+        /**
+         * @brief Redraw changed fields and push only the affected display regions
+         * @return Number of fields redrawn
+        */
+        uint8_t render();
+
+        /**
+         * @brief Time taken to draw a field into the frame buffer on its last redraw
+         * @param field Field handle
+         * @return Time in microseconds
+        */
+        uint32_t renderTime(uint8_t field) const;
+
+        /**
+         * @brief Time taken by the last flush of dirty regions to the panel
+         * @return Time in microseconds
+        */
+        uint32_t flushTime() const;
+
+    private:
+        struct Field
+        {
+            const char * name;
+            const char * format;
+            uint8_t      x;
+            uint8_t      y;
+            uint8_t      width;
+            bool         dirty;
+            uint32_t     render_us;
+            char         value[MAX_FIELD_CHARS + 1];
+        };
+
+        void markDirty(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+
+        PeripheralIO::SSD1306& _display;
+        OLEDIO&                _oled;
+        Field                  _fields[MAX_FIELDS];
+        uint8_t                _n_fields;
+        uint8_t                _dirty_col_start[MAX_PAGES];
+        uint8_t                _dirty_col_end[MAX_PAGES];
+        uint32_t               _flush_us;
+};
+
+}
+
+#endif // _OLED_COMPOSITOR_H
+
+// EOF
@@ -0,0 +1,85 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : oled-io.h
+// Purpose     : SSD1306 Partial Addressing
+// Description : 
+//               This class provides direct command and windowed GDDRAM writes to an SSD1306 controller over the
+//               HAL I2C port. It allows a subset of the display frame buffer (a column range across a page range)
+//               to be pushed to the panel without resending the entire frame as the driver display() call does.
+//
+//               The controller is expected to be in horizontal addressing mode, as set by the SSD1306 driver
+//               begin() call. Since the driver resets the column and page windows on every display() call, the
+//               two may be freely mixed.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h
+//               Custom   : hal.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _OLED_IO_H
+#define _OLED_IO_H
+
+#include <Arduino.h>
+#include "hal.h"
+
+namespace Demo
+{
+
+class OLEDIO
+{
+    public:
+        /**
+         * @brief Constructor for OLEDIO object
+         * @param i2c_bus I2C bus on which the display resides
+         * @param address I2C address of the display
+         * @param width Width of display in pixels (columns)
+        */
+        OLEDIO(HAL::I2C& i2c_bus, uint8_t address, uint8_t width=128);
+
+        /**
+         * @brief Send a sequence of commands in a single I2C transaction
+         * @param cmds Command buffer
+         * @param len Number of command bytes
+         * @return Zero for success, nonzero for error
+        */
+        uint8_t command(const uint8_t * cmds, uint32_t len);
+
+        /**
+         * @brief Write a rectangular window of the frame buffer to display RAM
+         * @param buffer Frame buffer laid out as horizontal pages of width bytes
+         * @param col_start First column to write
+         * @param col_end Last column to write (inclusive)
+         * @param page_start First page to write
+         * @param page_end Last page to write (inclusive)
+         * @return Zero for success, nonzero for error
+        */
+        uint8_t writeWindow(const uint8_t * buffer, uint8_t col_start, uint8_t col_end,
+                            uint8_t page_start, uint8_t page_end);
+
+        /**
+         * @brief Total bytes placed on the bus by this object, including control and command bytes
+         * @return Byte count
+        */
+        uint32_t bytesSent() const;
+
+        /**
+         * @brief Reset byte counter
+        */
+        void clearBytesSent();
+
+    private:
+        // Maximum GDDRAM payload per I2C transaction, matching the Wire buffer used by the driver
+        static const uint8_t OLED_DATA_CHUNK = 32;
+
+        HAL::I2C& _i2c_bus;
+        uint8_t   _address;
+        uint8_t   _width;
+        uint32_t  _bytes_sent;
+};
+
+}
+
+#endif // _OLED_IO_H
+
+// EOF
@@ -0,0 +1,74 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : oled-ticker.h
+// Purpose     : Streaming Text Ticker for SSD1306
+// Description : 
+//               This class implements a scrolling log/status mode on the SSD1306 using the controller's display
+//               start line register. Each new line of text is drawn into the oldest page of the frame buffer and
+//               only that page is written to display RAM, after which the start line is advanced by one page so
+//               that the new line appears at the bottom of the panel. A new line therefore costs one page write
+//               plus a single register update rather than a full frame transfer.
+//
+//               The start line register shifts the entire panel, so the ticker owns the whole display while
+//               active. Call end() before returning to normal frame buffer drawing.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h
+//               Custom   : hal.h, ssd1306.h, oled-io.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _OLED_TICKER_H
+#define _OLED_TICKER_H
+
+#include <Arduino.h>
+#include "hal.h"
+#include "ssd1306.h"
+#include "oled-io.h"
+
+namespace Demo
+{
+
+class OLEDTicker
+{
+    public:
+        /**
+         * @brief Constructor for OLEDTicker object
+         * @param display Initialized SSD1306 driver used for glyph rendering
+         * @param oled Partial addressing interface to the same display
+        */
+        OLEDTicker(PeripheralIO::SSD1306& display, OLEDIO& oled);
+
+        /**
+         * @brief Enter ticker mode; stops any hardware scroll and clears the panel
+         * @return Zero for success, nonzero for error
+        */
+        uint8_t begin();
+
+        /**
+         * @brief Append a line of text at the bottom of the panel, scrolling older lines up
+         * @param str Text to append; truncated to panel width
+         * @return Zero for success, nonzero for error, including a call before begin()
+        */
+        uint8_t println(const char * str);
+
+        /**
+         * @brief Leave ticker mode; restores start line zero so the frame buffer maps directly to the panel
+         * @return Zero for success, nonzero for error
+        */
+        uint8_t end();
+
+    private:
+        uint8_t setStartLine(uint8_t line);
+
+        PeripheralIO::SSD1306& _display;
+        OLEDIO&                _oled;
+        uint8_t                _pages;
+        uint8_t                _head;
+};
+
+}
+
+#endif // _OLED_TICKER_H
+
+// EOF
@@ -0,0 +1,99 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : rtc-tick.h
+// Purpose     : RTC Square-Wave Second Tick
+// Description : 
+//               This class configures the DS3232 INT/SQW output for a 1 Hz square wave and counts its falling
+//               edges on an external interrupt pin, keeping a local seconds counter. The current time is then
+//               available without any bus traffic; the RTC need only be read at boot and at periodic resync.
+//
+//               The SQW output is open drain, so the input pin is configured with its pull-up enabled. A single
+//               instance is supported since the interrupt handler has no context argument.
+//
+//               If no edge arrives for RTC_EDGE_TIMEOUT_MS, because SQW is not wired or begin() failed, seconds
+//               are counted from millis() instead until edges resume; an edge ending such a gap accounts for the
+//               whole gap, so local time never steps backwards.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h, TimeLib.h
+//               Custom   : hal.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _RTC_TICK_H
+#define _RTC_TICK_H
+
+#include <Arduino.h>
+#include <TimeLib.h>
+#include "hal.h"
+
+namespace Demo
+{
+
+class RTCTick
+{
+    public:
+        static const uint8_t  DS3232_ADDRESS      = 0x68;
+        static const uint32_t RTC_EDGE_TIMEOUT_MS = 2000;
+
+        /**
+         * @brief Constructor for RTCTick object
+         * @param i2c_bus I2C bus on which the RTC resides
+         * @param sqw_pin Pin wired to the RTC INT/SQW output
+         * @param address I2C address of RTC
+        */
+        RTCTick(HAL::I2C& i2c_bus, uint8_t sqw_pin, uint8_t address=DS3232_ADDRESS);
+
+        /**
+         * @brief Enable 1 Hz square wave output and start counting seconds
+         * @param t Current RTC time; treated as unaligned until the next sync()
+         * @return Zero for success, nonzero if the square wave could not be enabled; time then runs on millis()
+        */
+        uint8_t begin(time_t t);
+
+        /**
+         * @brief Realign local time to RTC time; call shortly after a second boundary
+         * @param t Current RTC time
+         * @param aligned True if t was read just after a square wave edge
+        */
+        void sync(time_t t, bool aligned=true);
+
+        /**
+         * @brief Check whether local time has been synced just after a second boundary
+         * @return True if aligned to the RTC second
+        */
+        bool aligned() const;
+
+        /**
+         * @brief Local time maintained from the square wave, or from millis() while no edges arrive
+         * @return Timestamp in seconds since 1970
+        */
+        time_t now() const;
+
+        /**
+         * @brief Seconds elapsed since the last sync
+         * @return Elapsed seconds
+        */
+        uint32_t sinceSync() const;
+
+    private:
+        static void tickISR();
+
+        uint32_t elapsed() const;
+
+        static volatile uint32_t _ticks;
+        static volatile uint32_t _edge_ms;
+
+        HAL::I2C& _i2c_bus;
+        HAL::GPIO _sqw_pin;
+        uint8_t   _address;
+        time_t    _base_time;
+        uint32_t  _base_ticks;
+        bool      _aligned;
+};
+
+}
+
+#endif // _RTC_TICK_H
+
+// EOF
@@ -0,0 +1,73 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : seg-frames.h
+// Purpose     : Precomputed 7-Segment Multiplex Frames
+// Description : 
+//               This class drives a four digit multiplexed 7-segment display from a table of precomputed frames.
+//               Each frame holds the segment pattern in its low byte and the digit select mask in its high byte,
+//               and is encoded once when write() changes the displayed value. The periodic refresh() then only
+//               emits the next frame to the display port and advances an index, so it is suitable for an ISR.
+//
+//               Frames are double buffered and published by a single pointer store after a compiler barrier, so
+//               the ISR never observes a partially encoded value.
+//
+//               The display port is a HAL::GPIOPort of 12 bits (8 segment bits, LSB segment A, followed by 4
+//               digit selects, LSB leftmost digit). How a frame reaches the hardware is decided in the HAL.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h
+//               Custom   : hal.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _SEG_FRAMES_H
+#define _SEG_FRAMES_H
+
+#include <Arduino.h>
+#include "hal.h"
+
+namespace Demo
+{
+
+class SegmentFrames
+{
+    public:
+        static const uint8_t  DIGITS    = 4;
+        static const uint16_t MAX_VALUE = 9999;
+
+        /**
+         * @brief Constructor for SegmentFrames object
+         * @param port Combined segment and digit select port
+        */
+        SegmentFrames(HAL::GPIOPort& port);
+
+        /**
+         * @brief Initialize display port
+        */
+        void init();
+
+        /**
+         * @brief Encode a value into display frames; no effect if unchanged
+         * @param val Value to display; leading zeros are blanked, and values above MAX_VALUE show as MAX_VALUE
+        */
+        void write(uint16_t val);
+
+        /**
+         * @brief Emit the next digit frame; call periodically from timer ISR
+        */
+        void refresh();
+
+    private:
+        HAL::GPIOPort&     _port;
+        uint16_t           _frames[2][DIGITS];
+        const uint16_t * volatile _active;
+        uint8_t            _back;
+        uint8_t            _digit;
+        uint16_t           _value;
+};
+
+}
+
+#endif // _SEG_FRAMES_H
+
+// EOF
@@ -0,0 +1,78 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : time-cache.h
+// Purpose     : Cached Broken-Down Time
+// Description : 
+//               This class holds the calendar breakdown of a timestamp so that date and time fields may be read
+//               as plain loads. When the timestamp advances by exactly one second the fields are stepped forward
+//               with carries; any other change falls back to a full breakTime() recomputation.
+//
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : Arduino.h, TimeLib.h
+//               Custom   : N/A
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _TIME_CACHE_H
+#define _TIME_CACHE_H
+
+#include <Arduino.h>
+#include <TimeLib.h>
+
+namespace Demo
+{
+
+class TimeCache
+{
+    public:
+        /**
+         * @brief Constructor for TimeCache object
+        */
+        TimeCache();
+
+        /**
+         * @brief Bring cached fields up to date with the given timestamp
+         * @param t Timestamp in seconds since 1970
+         * @return True if the timestamp changed
+        */
+        bool update(time_t t);
+
+        /**
+         * @brief Cached broken-down time
+         * @return Reference to calendar fields of last timestamp
+        */
+        const tmElements_t& fields() const;
+
+        /**
+         * @brief Cached timestamp
+         * @return Timestamp of last update
+        */
+        time_t time() const;
+
+        /**
+         * @brief Number of full breakTime() recomputations performed
+         * @return Count since construction
+        */
+        uint32_t fullUpdates() const;
+
+        /**
+         * @brief Number of single-second incremental updates performed
+         * @return Count since construction
+        */
+        uint32_t incrementalUpdates() const;
+
+    private:
+        void advance();
+
+        tmElements_t _tm;
+        time_t       _time;
+        bool         _valid;
+        uint32_t     _full_updates;
+        uint32_t     _incremental_updates;
+};
+
+}
+
+#endif // _TIME_CACHE_H
+
+// EOF
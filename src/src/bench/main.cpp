@@ -0,0 +1,106 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : main.cpp
+// Purpose     : HAL Microbenchmark Entry
+// Description : This main source file runs the HAL microbenchmark suite on target. The suite runs once at boot
+//               and again whenever a character is received on the serial port; capture the output between the
+//               BENCH_BEGIN and BENCH_END markers and compare captures with tools/bench-compare.py.
+//               Build with `pio run -e bench`.
+// Platform    : Multiple
+// Framework   : Arduino
+// Language    : C++
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "hal.h"
+#include "hal-bench.h"
+
+// Baud settings, as in the application
+const uint32_t SERIAL_BAUDRATE = 1000000;
+const uint32_t I2C_BAUDRATE    = 100000;
+const uint32_t SPI_BAUDRATE    = 1000000;
+
+// EEPROM under test; held write protected so write cases never start a write cycle
+const uint8_t  EEPROM_ADDRESS = 0x50;
+const uint8_t  EEPROM_WP_PIN  = PIN_A6;
+
+// HAL-mediated utility
+HAL::Timer timer;
+
+// Peripheral buses
+HAL::I2C&  i2c_bus    = HAL::i2cBus(0);
+HAL::SPI&  spi_bus    = HAL::spiBus(0);
+HAL::UART& serial_bus = HAL::uartBus(0);
+
+// Peripheral objects
+HAL::GPIO      eeprom_wp(EEPROM_WP_PIN);
+Demo::HALBench bench(serial_bus, i2c_bus, spi_bus, timer, EEPROM_ADDRESS);
+
+// C library initialization
+extern "C" void __libc_init_array(void);
+
+// Weak empty variant initialization function
+// May be redefined by variant files
+void initVariant() __attribute__((weak));
+void initVariant() {}
+
+// Function prototypes
+void initFramework();
+void yieldToTasks();
+
+int main()
+{
+    initFramework();
+
+    // Bus initialization
+    serial_bus.init(SERIAL_BAUDRATE);
+    i2c_bus.init(I2C_BAUDRATE);
+    spi_bus.init(SPI_BAUDRATE);
+
+    eeprom_wp.pinMode(GPIO_OUTPUT);
+    eeprom_wp.digitalWrite(HIGH);
+
+    // Allow the host to open the USB serial port before the first run
+    HAL::delay_ms(2000);
+
+    bench.run();
+
+    for (;;)
+    {
+        if (serial_bus.available())
+        {
+            while (serial_bus.available())
+                serial_bus.read();
+
+            bench.run();
+        }
+
+        yieldToTasks();
+    }
+
+    return 0;
+}
+
+// Initialize framework
+void initFramework()
+{
+    init();
+    __libc_init_array();
+    initVariant();
+
+#if defined(USBCON)
+    USBDevice.init();
+    USBDevice.attach();
+#endif
+}
+
+// Yield to framework USB background task
+void yieldToTasks()
+{
+    yield();
+    if (serialEventRun)
+    {
+        serialEventRun();
+    }
+}
+
+// EOF
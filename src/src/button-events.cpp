@@ -0,0 +1,102 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : button-events.cpp
+// Purpose     : Edge-Interrupt Button Events
+// Description : This source file implements header file button-events.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "button-events.h"
+
+namespace Demo
+{
+
+ButtonEvents * ButtonEvents::_instance = nullptr;
+
+ButtonEvents::ButtonEvents(uint8_t pin, uint32_t debounce_us, bool active_low)
+: _pin(pin)
+, _debounce_us(debounce_us)
+, _active_low(active_low)
+, _pressed(false)
+, _last_edge_us(0)
+, _last_raw_us(0)
+, _queue()
+, _overflows(0)
+{ }
+
+void ButtonEvents::init()
+{
+    _instance = this;
+    _pin.pinMode(_active_low ? GPIO_INPUT_PULLUP : GPIO_INPUT);
+    _pressed      = (_pin.digitalRead() == (_active_low ? LOW : HIGH));
+    _last_edge_us = HAL::micros();
+    _last_raw_us  = _last_edge_us;
+    _pin.attachInterrupt(edgeISR, GPIO_CHANGE);
+}
+
+void ButtonEvents::service()
+{
+    uint32_t now = HAL::micros();
+    bool     level;
+
+    if ((now - _last_raw_us) < _debounce_us) return;
+
+    level = (_pin.digitalRead() == (_active_low ? LOW : HIGH));
+
+    // Interrupt is masked so that an edge arriving now cannot queue a duplicate
+    HAL::CriticalSection lock;
+    if (level != _pressed)
+        accept(level, now);
+}
+
+bool ButtonEvents::pop(Event& event)
+{
+    return _queue.pop(event);
+}
+
+uint8_t ButtonEvents::popBatch(Event * events, uint8_t max)
+{
+    return (uint8_t)_queue.popBatch(events, max);
+}
+
+bool ButtonEvents::pressed() const
+{
+    return _pressed;
+}
+
+uint32_t ButtonEvents::overflows() const
+{
+    return _overflows;
+}
+
+void ButtonEvents::edgeISR()
+{
+    ButtonEvents * self = _instance;
+    uint32_t       now  = HAL::micros();
+    uint32_t       last = self->_last_edge_us;
+
+    self->_last_raw_us = now;
+
+    if ((now - last) < self->_debounce_us) return;
+
+    // First edge after a quiet period flips the debounced state
+    self->accept(!self->_pressed, now);
+}
+
+void ButtonEvents::accept(bool pressed, uint32_t now)
+{
+    Event event = { pressed ? BUTTON_PRESSED : BUTTON_RELEASED, now };
+
+    _pressed      = pressed;
+    _last_edge_us = now;
+
+    if (!_queue.push(event))
+        _overflows = _overflows + 1;
+}
+
+}
+
+// EOF
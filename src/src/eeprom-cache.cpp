@@ -0,0 +1,248 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : eeprom-cache.cpp
+// Purpose     : Page-Aware Write-Back Cache for AT24CXX EEPROM
+// Description : This source file implements header file eeprom-cache.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "eeprom-cache.h"
+
+namespace Demo
+{
+
+// Limit on ACK polling; datasheet maximum write cycle is 5 ms
+static const uint32_t EEPROM_WRITE_TIMEOUT_US = 10000;
+
+static uint64_t byteMask(uint8_t offset, uint8_t len)
+{
+    return ((len >= 64) ? ~(uint64_t)0 : (((uint64_t)1 << len) - 1)) << offset;
+}
+
+// Random read: memory address, repeated start, then the caller's buffer filled in place
+static uint8_t readMemory(HAL::I2C& i2c_bus, uint8_t address, uint16_t addr, uint8_t * data, uint32_t len)
+{
+    uint8_t               mem_addr[2] = { (uint8_t)(addr >> 8), (uint8_t)(addr) };
+    const HAL::I2CSegment wr_seg      = { mem_addr, sizeof(mem_addr) };
+    const HAL::I2CSegment r_seg       = { data, len };
+
+    return i2c_bus.transfer(address, &wr_seg, 1, &r_seg, 1);
+}
+
+EEPROMWriteCache::EEPROMWriteCache(HAL::I2C& i2c_bus, uint8_t address, uint8_t wp_pin)
+: _i2c_bus(i2c_bus)
+, _wp_pin(wp_pin)
+, _address(address)
+, _write_pending(false)
+, _lines()
+, _observer(nullptr)
+, _stats()
+{ }
+
+void EEPROMWriteCache::init()
+{
+    _wp_pin.pinMode(GPIO_OUTPUT);
+    _wp_pin.digitalWrite(HIGH);
+}
+
+uint8_t EEPROMWriteCache::write(uint16_t addr, const uint8_t * data, uint16_t len)
+{
+    uint8_t error = 0;
+
+    _stats.bytes += len;
+
+    if (nullptr != _observer)
+        _observer->invalidate(addr, len);
+
+    while (len > 0)
+    {
+        uint8_t offset = addr % PAGE_SIZE;
+        uint8_t chunk  = ((PAGE_SIZE - offset) < len) ? (PAGE_SIZE - offset) : (uint8_t)len;
+        Line *  line   = lineFor(addr / PAGE_SIZE, &error);
+
+        if (nullptr == line) return error;
+
+        memcpy(&line->data[offset], data, chunk);
+        line->dirty     |= byteMask(offset, chunk);
+        line->touched_ms = HAL::millis();
+
+        ++_stats.naive_writes;
+        addr += chunk;
+        data += chunk;
+        len  -= chunk;
+    }
+
+    return 0;
+}
+
+uint8_t EEPROMWriteCache::read(uint16_t addr, uint8_t * data, uint16_t len)
+{
+    uint8_t error = waitReady();
+
+    if (0 == error)
+        error = readMemory(_i2c_bus, _address, addr, data, (uint32_t)len);
+
+    if (0 != error) return error;
+
+    // Overlay bytes not yet written back
+    for (uint8_t iter = 0; iter < CACHE_LINES; ++iter)
+    {
+        const Line& line = _lines[iter];
+        uint16_t    base = line.page * PAGE_SIZE;
+
+        if (!line.valid || (0 == line.dirty)) continue;
+        if ((base >= (uint32_t)addr + len) || ((uint32_t)base + PAGE_SIZE <= addr)) continue;
+
+        for (uint8_t offset = 0; offset < PAGE_SIZE; ++offset)
+        {
+            uint16_t byte_addr = base + offset;
+
+            if ((line.dirty & byteMask(offset, 1)) && (byte_addr >= addr) && (byte_addr < (uint32_t)addr + len))
+                data[byte_addr - addr] = line.data[offset];
+        }
+    }
+
+    return 0;
+}
+
+uint8_t EEPROMWriteCache::flush()
+{
+    uint8_t error = 0;
+
+    for (uint8_t iter = 0; (iter < CACHE_LINES) && (0 == error); ++iter)
+        error = writeBack(_lines[iter]);
+
+    return error;
+}
+
+uint8_t EEPROMWriteCache::service(uint32_t idle_ms)
+{
+    uint8_t error = 0;
+
+    for (uint8_t iter = 0; (iter < CACHE_LINES) && (0 == error); ++iter)
+    {
+        if ((0 != _lines[iter].dirty) && ((HAL::millis() - _lines[iter].touched_ms) >= idle_ms))
+            error = writeBack(_lines[iter]);
+    }
+
+    return error;
+}
+
+uint8_t EEPROMWriteCache::waitReady()
+{
+    uint32_t start = HAL::micros();
+
+    if (!_write_pending) return 0;
+
+    // Device does not acknowledge its address until the internal write cycle completes
+    do
+    {
+        ++_stats.ack_polls;
+
+        if ((HAL::micros() - start) > EEPROM_WRITE_TIMEOUT_US)
+        {
+            _stats.bus_us += HAL::micros() - start;
+            return 1;
+        }
+    } while (!_i2c_bus.probe(_address));
+
+    _write_pending = false;
+    _stats.bus_us += HAL::micros() - start;
+
+    return 0;
+}
+
+void EEPROMWriteCache::setObserver(MemoryObserver * observer)
+{
+    _observer = observer;
+}
+
+const EEPROMWriteCache::Stats& EEPROMWriteCache::stats() const
+{
+    return _stats;
+}
+
+EEPROMWriteCache::Line * EEPROMWriteCache::lineFor(uint16_t page, uint8_t * error)
+{
+    Line * victim = &_lines[0];
+
+    for (uint8_t iter = 0; iter < CACHE_LINES; ++iter)
+    {
+        Line& line = _lines[iter];
+
+        if (line.valid && (line.page == page)) return &line;
+
+        // Prefer an unused or clean line, otherwise the least recently written
+        if (!line.valid || (0 == line.dirty))
+            victim = &line;
+        else if ((0 != victim->dirty) && ((int32_t)(line.touched_ms - victim->touched_ms) < 0))
+            victim = &line;
+    }
+
+    *error = writeBack(*victim);
+
+    if (0 != *error) return nullptr;
+
+    victim->page  = page;
+    victim->valid = true;
+    victim->dirty = 0;
+
+    return victim;
+}
+
+uint8_t EEPROMWriteCache::writeBack(Line& line)
+{
+    uint8_t  first = 0;
+    uint8_t  last  = PAGE_SIZE - 1;
+    uint8_t  fill[PAGE_SIZE];
+    uint64_t span;
+    uint32_t start;
+    uint8_t  error;
+
+    if (!line.valid || (0 == line.dirty)) return 0;
+
+    while (0 == (line.dirty & byteMask(first, 1))) ++first;
+    while (0 == (line.dirty & byteMask(last, 1))) --last;
+
+    span  = byteMask(first, last - first + 1);
+    error = waitReady();
+
+    // Fill gaps from the device so the span goes out as a single page write
+    if ((0 == error) && ((line.dirty & span) != span))
+    {
+        error = readMemory(_i2c_bus, _address, (uint16_t)(line.page * PAGE_SIZE + first), fill,
+                           (uint32_t)(last - first + 1));
+        ++_stats.fill_reads;
+
+        for (uint8_t offset = first; (0 == error) && (offset <= last); ++offset)
+        {
+            if (0 == (line.dirty & byteMask(offset, 1)))
+                line.data[offset] = fill[offset - first];
+        }
+    }
+
+    if (0 != error) return error;
+
+    start = HAL::micros();
+    _wp_pin.digitalWrite(LOW);
+    error = _i2c_bus.write(_address, (uint16_t)(line.page * PAGE_SIZE + first), &line.data[first],
+                           (uint32_t)(last - first + 1));
+    _wp_pin.digitalWrite(HIGH);
+    _stats.bus_us += HAL::micros() - start;
+
+    if (0 == error)
+    {
+        ++_stats.page_writes;
+        line.dirty     = 0;
+        _write_pending = true;
+    }
+
+    return error;
+}
+
+}
+
+// EOF
@@ -0,0 +1,322 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : eeprom-log.cpp
+// Purpose     : Log-Structured Time-Series Store for AT24CXX EEPROM
+// Description : This source file implements header file eeprom-log.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "eeprom-log.h"
+
+namespace Demo
+{
+
+// Page field offsets
+static const uint8_t LOG_SEQ_OFFSET     = 0;
+static const uint8_t LOG_T0_OFFSET      = 4;
+static const uint8_t LOG_COUNT_OFFSET   = 8;
+static const uint8_t LOG_CRC_OFFSET     = 9;
+static const uint8_t LOG_RECORD_OFFSET  = 12;
+static const uint8_t LOG_RECORD_SIZE    = 6;
+
+// Maximum record offset from page start time
+static const uint32_t LOG_MAX_DT = 0xFFFF;
+
+static void put16(uint8_t * buf, uint16_t val)
+{
+    buf[0] = (uint8_t)(val);
+    buf[1] = (uint8_t)(val >> 8);
+}
+
+static void put32(uint8_t * buf, uint32_t val)
+{
+    put16(&buf[0], (uint16_t)val);
+    put16(&buf[2], (uint16_t)(val >> 16));
+}
+
+static uint16_t get16(const uint8_t * buf)
+{
+    return (uint16_t)buf[0] | ((uint16_t)buf[1] << 8);
+}
+
+static uint32_t get32(const uint8_t * buf)
+{
+    return (uint32_t)get16(&buf[0]) | ((uint32_t)get16(&buf[2]) << 16);
+}
+
+// CRC-8, polynomial x^8 + x^2 + x + 1, with the CRC byte itself taken as zero
+static uint8_t pageCRC(const uint8_t * buf)
+{
+    uint8_t crc = 0;
+
+    for (uint8_t iter = 0; iter < EEPROMLog::PAGE_SIZE; ++iter)
+    {
+        crc ^= (LOG_CRC_OFFSET == iter) ? 0 : buf[iter];
+        for (uint8_t bit = 0; bit < 8; ++bit)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+
+    return crc;
+}
+
+EEPROMLog::EEPROMLog(EEPROMWriteCache& eeprom, uint16_t first_page, uint16_t page_count)
+: _eeprom(eeprom)
+, _first_page(first_page)
+, _page_count(page_count)
+, _head(page_count - 1)
+, _oldest(0)
+, _valid_pages(0)
+, _next_seq(0)
+, _last_time(0)
+, _page_writes(0)
+, _pending()
+{ }
+
+uint8_t EEPROMLog::mount()
+{
+    Page     page;
+    uint32_t lap;
+    uint16_t low;
+    uint16_t high;
+
+    _pending.count = 0;
+    _valid_pages   = 0;
+    _head          = _page_count - 1;
+    _oldest        = 0;
+    _next_seq      = 0;
+    _last_time     = 0;
+
+    if (readPage(0, &page))
+    {
+        // Pages 0 to head share the lap of page 0; everything after is older, torn or unwritten
+        lap  = page.seq / _page_count;
+        low  = 0;
+        high = _page_count - 1;
+
+        while (low < high)
+        {
+            uint16_t mid = low + (high - low + 1) / 2;
+
+            if (readPage(mid, &page) && ((page.seq / _page_count) == lap))
+                low = mid;
+            else
+                high = mid - 1;
+        }
+
+        _head = low;
+    }
+    else if (!readPage(_page_count - 1, &page))
+    {
+        return 0; // Empty log
+    }
+
+    readPage(_head, &page);
+    _next_seq  = page.seq + 1;
+    _last_time = page.records[page.count - 1].time;
+
+    // Oldest page follows the head, skipping at most one torn page
+    _oldest = 0;
+    for (uint16_t skip = 1; skip <= 2; ++skip)
+    {
+        uint16_t index = (_head + skip) % _page_count;
+
+        if ((index != _head) && readPage(index, &page) && (page.seq < _next_seq))
+        {
+            _oldest = index;
+            break;
+        }
+    }
+
+    _valid_pages = (uint16_t)((_head + _page_count - _oldest) % _page_count) + 1;
+
+    return 0;
+}
+
+uint8_t EEPROMLog::append(const LogRecord& record)
+{
+    LogRecord stored = record;
+    uint8_t   error  = 0;
+
+    // Times never step back, so neither do page start times, on which seek() depends
+    if (stored.time < _last_time) stored.time = _last_time;
+
+    // Start a new page if the offset from the page start time no longer fits
+    if ((0 != _pending.count) && ((stored.time - _pending.t0) > LOG_MAX_DT))
+    {
+        error = sync();
+        if (0 != error) return error;
+    }
+
+    if (RECORDS_PER_PAGE == _pending.count) return 1; // Previous page write still failing
+
+    if (0 == _pending.count)
+        _pending.t0 = stored.time;
+
+    _pending.records[_pending.count++] = stored;
+    _last_time = stored.time;
+
+    if (RECORDS_PER_PAGE == _pending.count)
+        error = sync();
+
+    return error;
+}
+
+uint8_t EEPROMLog::sync()
+{
+    uint16_t index = (_head + 1) % _page_count;
+    uint8_t  error;
+
+    if (0 == _pending.count) return 0;
+
+    _pending.seq = _next_seq;
+    error = writePage(index, _pending);
+
+    if (0 != error) return error;
+
+    if (_valid_pages == _page_count)
+        _oldest = (_oldest + 1) % _page_count;
+    else
+        ++_valid_pages;
+
+    _head          = index;
+    _next_seq     += 1;
+    _pending.count = 0;
+
+    return 0;
+}
+
+uint16_t EEPROMLog::read(uint32_t from, LogRecord * records, uint16_t max)
+{
+    Page     page;
+    uint16_t n       = 0;
+    uint16_t logical = seek(from);
+
+    if (NO_PAGE == logical) logical = 0;
+
+    for (; (logical < _valid_pages) && (n < max); ++logical)
+    {
+        if (!readPage(physical(logical), &page)) continue;
+
+        for (uint8_t iter = 0; (iter < page.count) && (n < max); ++iter)
+        {
+            if (page.records[iter].time >= from)
+                records[n++] = page.records[iter];
+        }
+    }
+
+    for (uint8_t iter = 0; (iter < _pending.count) && (n < max); ++iter)
+    {
+        if (_pending.records[iter].time >= from)
+            records[n++] = _pending.records[iter];
+    }
+
+    return n;
+}
+
+uint16_t EEPROMLog::seek(uint32_t t)
+{
+    Page     page;
+    uint16_t low    = 0;
+    uint16_t high   = _valid_pages;
+    uint16_t result = NO_PAGE;
+
+    // Page start times increase with logical index
+    while (low < high)
+    {
+        uint16_t mid = low + (high - low) / 2;
+
+        if (readPage(physical(mid), &page) && (page.t0 <= t))
+        {
+            result = mid;
+            low    = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return result;
+}
+
+uint16_t EEPROMLog::pages() const
+{
+    return _valid_pages;
+}
+
+uint32_t EEPROMLog::pageWrites() const
+{
+    return _page_writes;
+}
+
+bool EEPROMLog::readPage(uint16_t index, Page * page)
+{
+    uint8_t  buf[PAGE_SIZE];
+    uint16_t addr = (uint16_t)((_first_page + index) * PAGE_SIZE);
+
+    if (0 != _eeprom.read(addr, buf, PAGE_SIZE)) return false;
+    if (pageCRC(buf) != buf[LOG_CRC_OFFSET]) return false;
+
+    page->seq   = get32(&buf[LOG_SEQ_OFFSET]);
+    page->t0    = get32(&buf[LOG_T0_OFFSET]);
+    page->count = buf[LOG_COUNT_OFFSET];
+
+    if ((0 == page->count) || (page->count > RECORDS_PER_PAGE)) return false;
+    if ((page->seq % _page_count) != index) return false;
+
+    for (uint8_t iter = 0; iter < page->count; ++iter)
+    {
+        const uint8_t * rec = &buf[LOG_RECORD_OFFSET + iter * LOG_RECORD_SIZE];
+
+        page->records[iter].time        = page->t0 + get16(&rec[0]);
+        page->records[iter].temperature = (int16_t)get16(&rec[2]);
+        page->records[iter].humidity    = (int16_t)get16(&rec[4]);
+    }
+
+    return true;
+}
+
+uint8_t EEPROMLog::writePage(uint16_t index, const Page& page)
+{
+    uint8_t  buf[PAGE_SIZE];
+    uint16_t addr = (uint16_t)((_first_page + index) * PAGE_SIZE);
+    uint8_t  error;
+
+    memset(buf, 0xFF, sizeof(buf));
+    put32(&buf[LOG_SEQ_OFFSET], page.seq);
+    put32(&buf[LOG_T0_OFFSET], page.t0);
+    buf[LOG_COUNT_OFFSET] = page.count;
+
+    for (uint8_t iter = 0; iter < page.count; ++iter)
+    {
+        uint8_t * rec = &buf[LOG_RECORD_OFFSET + iter * LOG_RECORD_SIZE];
+
+        put16(&rec[0], (uint16_t)(page.records[iter].time - page.t0));
+        put16(&rec[2], (uint16_t)page.records[iter].temperature);
+        put16(&rec[4], (uint16_t)page.records[iter].humidity);
+    }
+
+    buf[LOG_CRC_OFFSET] = pageCRC(buf);
+
+    // Whole page in one transaction; requires a Wire transmit buffer of at least PAGE_SIZE + 2 bytes
+    error = _eeprom.write(addr, buf, PAGE_SIZE);
+
+    if (0 == error)
+        error = _eeprom.flush();
+
+    if (0 == error) ++_page_writes;
+
+    return error;
+}
+
+uint16_t EEPROMLog::physical(uint16_t logical) const
+{
+    return (uint16_t)((_oldest + logical) % _page_count);
+}
+
+}
+
+// EOF
@@ -0,0 +1,87 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : fixed-format.cpp
+// Purpose     : Fixed-Point Text Formatting
+// Description : This source file implements header file fixed-format.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "fixed-format.h"
+
+namespace Demo
+{
+
+// Largest value for which the reciprocal multiply below yields an exact quotient
+static const uint32_t DIV10_FAST_MAX = 81919;
+
+// Divide by ten; the Cortex-M0+ has no hardware divider, so small values use multiply and shift
+static inline uint32_t div10(uint32_t val)
+{
+    return (val <= DIV10_FAST_MAX) ? ((val * 0xCCCDUL) >> 19) : (val / 10);
+}
+
+// Write digits of val least significant first into digits, emitting at least min_digits
+static uint8_t reverseDigits(char *digits, uint32_t val, uint8_t min_digits)
+{
+    uint8_t  n = 0;
+    uint32_t q;
+
+    do
+    {
+        q = div10(val);
+        digits[n++] = (char)('0' + (val - q * 10));
+        val = q;
+    } while ((0 != val) || (n < min_digits));
+
+    return n;
+}
+
+uint8_t formatFixed(char *str, int32_t value, uint8_t frac_digits, uint8_t width)
+{
+    char     digits[12];
+    bool     negative  = (value < 0);
+    uint32_t magnitude = negative ? (uint32_t)(-(value + 1)) + 1 : (uint32_t)value;
+    uint8_t  n_digits  = reverseDigits(digits, magnitude, frac_digits + 1);
+    uint8_t  length    = n_digits + (frac_digits ? 1 : 0) + (negative ? 1 : 0);
+    uint8_t  pos       = 0;
+
+    if (negative) str[pos++] = '-';
+
+    for (; length < width; ++length)
+        str[pos++] = '0';
+
+    while (n_digits)
+    {
+        if ((n_digits == frac_digits) && (0 != frac_digits))
+            str[pos++] = '.';
+        str[pos++] = digits[--n_digits];
+    }
+
+    str[pos] = '\0';
+
+    return pos;
+}
+
+uint8_t formatUnsigned(char *str, uint32_t value, uint8_t width)
+{
+    char    digits[10];
+    uint8_t n_digits = reverseDigits(digits, value, 1);
+    uint8_t pos      = 0;
+
+    for (uint8_t length = n_digits; length < width; ++length)
+        str[pos++] = '0';
+
+    while (n_digits)
+        str[pos++] = digits[--n_digits];
+
+    str[pos] = '\0';
+
+    return pos;
+}
+
+}
+
+// EOF
@@ -0,0 +1,635 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-bench.cpp
+// Purpose     : HAL Microbenchmark Suite
+// Description : This source file implements header file hal-bench.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include "hal-bench.h"
+#include "fixed-format.h"
+
+#if defined(HAL_BENCH_TIMELIB)
+#include <TimeLib.h>
+#include "time-cache.h"
+#endif
+
+namespace Demo
+{
+
+// Sample counts per case; bus cases are slow enough that fewer samples suffice
+static const uint32_t BENCH_FAST_SAMPLES  = 1000;
+static const uint32_t BENCH_BUS_SAMPLES   = 16;
+static const uint32_t BENCH_PRINT_SAMPLES = 32;
+
+// Pins and ports exercised; the LED pin and the board's 7-segment ports
+static const uint8_t  BENCH_GPIO_PIN       = PIN_A1;
+static const uint8_t  BENCH_FRAME_PINS[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+static const uint8_t  BENCH_SREG_PINS[8]   = {0, 1, 2, 3, 4, 5, 6, 7};
+
+// I2C payload sizes; 64 bytes is one EEPROM page and two Wire read chunks
+static const uint32_t BENCH_I2C_SIZES[]   = {1, 4, 16, 32, 64};
+static const uint8_t  BENCH_I2C_MAX_SIZE  = 64;
+
+// Device clocks for throughput cases: Standard-mode, Fast-mode, Fast-mode Plus
+static const uint32_t BENCH_I2C_CLOCKS[]  = {100000, 400000, 1000000};
+
+// DMA write payload on SPI, as a shift register frame burst would be
+static const uint8_t  BENCH_SPI_ASYNC_SIZE = 16;
+
+// Fixed-point formatting: centi-degree readings as the sensor display shows them, "%05.2f"
+static const uint8_t  BENCH_FORMAT_FRAC  = 2;
+static const uint8_t  BENCH_FORMAT_WIDTH = 5;
+
+#if defined(HAL_BENCH_TIMELIB)
+// Calendar breakdown: a timestamp advanced one second per sample, as the application clock is
+static const time_t   BENCH_TIME_START   = 1704067200; // 2024-01-01 00:00:00
+#endif
+
+// Queue depth for the handoff cases, as the DMA completion queue
+static const uint32_t BENCH_QUEUE_DEPTH = 8;
+
+// Timer interrupt capture
+static const uint32_t BENCH_TIMER_PERIOD_US = 1000;
+static const uint8_t  BENCH_TIMER_CAPTURES  = 32;
+static volatile uint32_t timer_captures[BENCH_TIMER_CAPTURES];
+static volatile uint8_t  timer_count = 0;
+
+// Wait for the completion of a DMA case, to within a microsecond; the benchmarked bus is the only one submitting
+static void awaitEvent()
+{
+    HAL::DMAEvent event;
+
+    while (!HAL::dmaPoll(event))
+        HAL::delay_us(1);
+}
+
+HALBench::Sampler::Sampler(uint32_t overhead)
+: _overhead(overhead)
+, _start(0)
+, _samples(0)
+, _min(0xFFFFFFFF)
+, _max(0)
+, _total(0)
+{ }
+
+void HALBench::Sampler::begin()
+{
+    _start = HAL::cycles();
+}
+
+void HALBench::Sampler::end()
+{
+    uint32_t elapsed = HAL::cycles() - _start;
+
+    add((elapsed > _overhead) ? (elapsed - _overhead) : 0);
+}
+
+void HALBench::Sampler::add(uint32_t cycles)
+{
+    if (cycles < _min) _min = cycles;
+    if (cycles > _max) _max = cycles;
+    _total += cycles;
+    ++_samples;
+}
+
+void HALBench::Sampler::print(HAL::UART& serial, const char * name, uint32_t size) const
+{
+    serial.printf("BENCH,%s,%lu,%lu,%lu,%lu,%lu\r\n", name, (unsigned long)size, (unsigned long)_samples,
+                  (unsigned long)(_samples ? _min : 0), (unsigned long)(_samples ? _total / _samples : 0),
+                  (unsigned long)_max);
+}
+
+HALBench::HALBench(HAL::UART& serial, HAL::I2C& i2c_bus, HAL::SPI& spi_bus, HAL::Timer& timer, uint8_t i2c_address)
+: _serial(serial)
+, _i2c_bus(i2c_bus)
+, _spi_bus(spi_bus)
+, _timer(timer)
+, _i2c_address(i2c_address)
+, _overhead(0)
+, _cases(0)
+{ }
+
+uint16_t HALBench::run()
+{
+    // Cost of an empty measurement, subtracted from every sample
+    _overhead = 0xFFFFFFFF;
+    for (uint32_t iter = 0; iter < BENCH_FAST_SAMPLES; ++iter)
+    {
+        uint32_t start = HAL::cycles();
+        uint32_t delta = HAL::cycles() - start;
+
+        if (delta < _overhead) _overhead = delta;
+    }
+
+    _cases = 0;
+    _serial.printf("BENCH_BEGIN\r\n");
+    _serial.printf("BENCH_INFO,cpu_hz,%lu\r\n", (unsigned long)HAL::cpuFrequency());
+    _serial.printf("BENCH_INFO,overhead,%lu\r\n", (unsigned long)_overhead);
+
+    runGPIO();
+    runSPI();
+    runI2C();
+    runI2CClock();
+    runUART();
+    runTimer();
+    runFormat();
+#if defined(HAL_BENCH_TIMELIB)
+    runTime();
+#endif
+    runQueue();
+
+    _serial.printf("BENCH_END,%u\r\n", (unsigned)_cases);
+
+    return _cases;
+}
+
+void HALBench::runGPIO()
+{
+    HAL::GPIO     pin(BENCH_GPIO_PIN);
+    HAL::GPIOPort frame_port(BENCH_FRAME_PINS, sizeof(BENCH_FRAME_PINS));
+    HAL::GPIOPort sreg_port(BENCH_SREG_PINS, sizeof(BENCH_SREG_PINS));
+    Sampler       write_sampler(_overhead);
+    Sampler       read_sampler(_overhead);
+    Sampler       frame_sampler(_overhead);
+    Sampler       sreg_sampler(_overhead);
+
+    pin.pinMode(GPIO_OUTPUT);
+
+    for (uint32_t iter = 0; iter < BENCH_FAST_SAMPLES; ++iter)
+    {
+        write_sampler.begin();
+        pin.digitalWrite(iter & 1);
+        write_sampler.end();
+
+        read_sampler.begin();
+        pin.digitalRead();
+        read_sampler.end();
+    }
+
+    pin.digitalWrite(LOW);
+
+    frame_port.init();
+    for (uint32_t iter = 0; iter < BENCH_BUS_SAMPLES; ++iter)
+    {
+        frame_sampler.begin();
+        frame_port.write(0x0100 | (iter & 0xFF));
+        frame_sampler.end();
+    }
+
+    sreg_port.init();
+    for (uint32_t iter = 0; iter < BENCH_FAST_SAMPLES; ++iter)
+    {
+        sreg_sampler.begin();
+        sreg_port.write(iter & 0xFF);
+        sreg_sampler.end();
+    }
+
+    write_sampler.print(_serial, "gpio.digitalWrite", 1);
+    read_sampler.print(_serial, "gpio.digitalRead", 1);
+    frame_sampler.print(_serial, "gpioport.write.frame", sizeof(BENCH_FRAME_PINS));
+    sreg_sampler.print(_serial, "gpioport.write.sreg", sizeof(BENCH_SREG_PINS));
+    _cases += 4;
+}
+
+void HALBench::runSPI()
+{
+    Sampler sampler(_overhead);
+
+    for (uint32_t iter = 0; iter < BENCH_FAST_SAMPLES; ++iter)
+    {
+        sampler.begin();
+        _spi_bus.transfer((uint8_t)iter);
+        sampler.end();
+    }
+
+    sampler.print(_serial, "spi.transfer", 1);
+    ++_cases;
+
+    // DMA write: the cost to the caller of starting it, and of starting it and collecting its completion
+    {
+        uint8_t               payload[BENCH_SPI_ASYNC_SIZE] = { };
+        const HAL::DMASegment seg = { payload, sizeof(payload) };
+        Sampler               submit_sampler(_overhead);
+        Sampler               total_sampler(_overhead);
+        uint8_t               error;
+
+        for (uint32_t iter = 0; iter < BENCH_BUS_SAMPLES; ++iter)
+        {
+            submit_sampler.begin();
+            error = _spi_bus.writeAsync(&seg, 1);
+            submit_sampler.end();
+            if (0 == error) awaitEvent();
+
+            total_sampler.begin();
+            if (0 == _spi_bus.writeAsync(&seg, 1)) awaitEvent();
+            total_sampler.end();
+        }
+
+        submit_sampler.print(_serial, "spi.writeAsync.submit", sizeof(payload));
+        total_sampler.print(_serial, "spi.writeAsync", sizeof(payload));
+        _cases += 2;
+    }
+
+#if defined(HAL_SPI1_SERCOM)
+    // One byte on each channel back to back; transfers block, so the pair costs two single transfers
+    {
+        HAL::SPI& second = HAL::spiBus(1);
+        Sampler  pair_sampler(_overhead);
+
+        second.init();
+
+        for (uint32_t iter = 0; iter < BENCH_FAST_SAMPLES; ++iter)
+        {
+            pair_sampler.begin();
+            _spi_bus.transfer((uint8_t)iter);
+            second.transfer((uint8_t)iter);
+            pair_sampler.end();
+        }
+
+        pair_sampler.print(_serial, "spi.transfer.2ch", 2);
+        ++_cases;
+    }
+#endif
+}
+
+void HALBench::runI2C()
+{
+    uint8_t buffer[BENCH_I2C_MAX_SIZE + 2];
+    uint8_t addr = _i2c_address;
+
+    for (uint8_t iter = 0; iter < sizeof(buffer); ++iter)
+        buffer[iter] = 0;
+
+    // Fixed shape cases
+    {
+        Sampler byte_sampler(_overhead);
+        Sampler reg_byte_sampler(_overhead);
+        Sampler read_byte_sampler(_overhead);
+        Sampler write_read_byte_sampler(_overhead);
+        Sampler probe_sampler(_overhead);
+
+        for (uint32_t iter = 0; iter < BENCH_BUS_SAMPLES; ++iter)
+        {
+            byte_sampler.begin();
+            _i2c_bus.write(addr, (uint8_t)0x00);
+            byte_sampler.end();
+
+            reg_byte_sampler.begin();
+            _i2c_bus.write(addr, (uint8_t)0x00, (uint8_t)0x00);
+            reg_byte_sampler.end();
+
+            read_byte_sampler.begin();
+            _i2c_bus.read(addr);
+            read_byte_sampler.end();
+
+            write_read_byte_sampler.begin();
+            _i2c_bus.writeRead(addr, (uint8_t)0x00, buffer);
+            write_read_byte_sampler.end();
+
+            probe_sampler.begin();
+            _i2c_bus.probe(addr);
+            probe_sampler.end();
+        }
+
+        byte_sampler.print(_serial, "i2c.write.byte", 1);
+        reg_byte_sampler.print(_serial, "i2c.write.reg8_byte", 1);
+        read_byte_sampler.print(_serial, "i2c.read.byte", 1);
+        write_read_byte_sampler.print(_serial, "i2c.writeRead.reg8_byte", 1);
+        probe_sampler.print(_serial, "i2c.probe", 0);
+        _cases += 5;
+    }
+
+    // Payload cases across sizes
+    for (uint8_t index = 0; index < sizeof(BENCH_I2C_SIZES) / sizeof(BENCH_I2C_SIZES[0]); ++index)
+    {
+        uint32_t size = BENCH_I2C_SIZES[index];
+        Sampler  write_sampler(_overhead);
+        Sampler  write_reg8_sampler(_overhead);
+        Sampler  write_reg16_sampler(_overhead);
+        Sampler  read_sampler(_overhead);
+        Sampler  write_read_sampler(_overhead);
+        Sampler  write_read_reg8_sampler(_overhead);
+        Sampler  write_read_reg8_stop_sampler(_overhead);
+        Sampler  write_read_reg16_sampler(_overhead);
+        Sampler  transfer_write_sampler(_overhead);
+        Sampler  transfer_read_sampler(_overhead);
+        Sampler  async_submit_sampler(_overhead);
+        Sampler  async_sampler(_overhead);
+        uint8_t  reg[2] = { 0x00, 0x00 };
+        uint8_t  error;
+
+        // Memory address and caller-owned payload as separate segments, as a driver would pass them
+        const HAL::I2CSegment reg_seg       = { reg, sizeof(reg) };
+        const HAL::I2CSegment write_segs[2] = { { reg, sizeof(reg) }, { buffer, size } };
+        const HAL::I2CSegment read_seg      = { buffer, size };
+        const HAL::DMASegment async_segs[2] = { { reg, sizeof(reg) }, { buffer, size } };
+
+        for (uint32_t iter = 0; iter < BENCH_BUS_SAMPLES; ++iter)
+        {
+            write_sampler.begin();
+            _i2c_bus.write(addr, buffer, size);
+            write_sampler.end();
+
+            write_reg8_sampler.begin();
+            _i2c_bus.write(addr, (uint8_t)0x00, buffer, size);
+            write_reg8_sampler.end();
+
+            write_reg16_sampler.begin();
+            _i2c_bus.write(addr, (uint16_t)0x0000, buffer, size);
+            write_reg16_sampler.end();
+
+            read_sampler.begin();
+            _i2c_bus.read(addr, buffer, size);
+            read_sampler.end();
+
+            write_read_sampler.begin();
+            _i2c_bus.writeRead(addr, buffer, 2, buffer, size);
+            write_read_sampler.end();
+
+            write_read_reg8_sampler.begin();
+            _i2c_bus.writeRead(addr, (uint8_t)0x00, buffer, size);
+            write_read_reg8_sampler.end();
+
+            write_read_reg8_stop_sampler.begin();
+            _i2c_bus.writeRead(addr, (uint8_t)0x00, buffer, size, true);
+            write_read_reg8_stop_sampler.end();
+
+            write_read_reg16_sampler.begin();
+            _i2c_bus.writeRead(addr, (uint16_t)0x0000, buffer, size);
+            write_read_reg16_sampler.end();
+
+            transfer_write_sampler.begin();
+            _i2c_bus.transfer(addr, write_segs, 2);
+            transfer_write_sampler.end();
+
+            transfer_read_sampler.begin();
+            _i2c_bus.transfer(addr, &reg_seg, 1, &read_seg, 1);
+            transfer_read_sampler.end();
+
+            async_submit_sampler.begin();
+            error = _i2c_bus.writeAsync(addr, async_segs, 2);
+            async_submit_sampler.end();
+            if (0 == error) awaitEvent();
+
+            async_sampler.begin();
+            if (0 == _i2c_bus.writeAsync(addr, async_segs, 2)) awaitEvent();
+            async_sampler.end();
+        }
+
+        write_sampler.print(_serial, "i2c.write", size);
+        write_reg8_sampler.print(_serial, "i2c.write.reg8", size);
+        write_reg16_sampler.print(_serial, "i2c.write.reg16", size);
+        read_sampler.print(_serial, "i2c.read", size);
+        write_read_sampler.print(_serial, "i2c.writeRead", size);
+        write_read_reg8_sampler.print(_serial, "i2c.writeRead.reg8", size);
+        write_read_reg8_stop_sampler.print(_serial, "i2c.writeRead.reg8_stop", size);
+        write_read_reg16_sampler.print(_serial, "i2c.writeRead.reg16", size);
+        transfer_write_sampler.print(_serial, "i2c.transfer.reg16_write", size);
+        transfer_read_sampler.print(_serial, "i2c.transfer.reg16_read", size);
+        async_submit_sampler.print(_serial, "i2c.writeAsync.reg16_submit", size);
+        async_sampler.print(_serial, "i2c.writeAsync.reg16", size);
+        _cases += 12;
+    }
+}
+
+void HALBench::runI2CClock()
+{
+    uint8_t  buffer[BENCH_I2C_MAX_SIZE];
+    uint8_t  addr     = _i2c_address;
+    uint8_t  other    = _i2c_address ^ 0x01;
+    uint32_t switches = _i2c_bus.clockSwitches();
+    uint32_t cycles   = _i2c_bus.clockSwitchCycles();
+    char     name[24];
+
+    for (uint8_t iter = 0; iter < sizeof(buffer); ++iter)
+        buffer[iter] = 0;
+
+    // Page sized transfers at each device clock
+    for (uint8_t index = 0; index < sizeof(BENCH_I2C_CLOCKS) / sizeof(BENCH_I2C_CLOCKS[0]); ++index)
+    {
+        uint32_t khz = BENCH_I2C_CLOCKS[index] / 1000;
+        Sampler  read_sampler(_overhead);
+        Sampler  write_sampler(_overhead);
+
+        _i2c_bus.setDeviceClock(addr, BENCH_I2C_CLOCKS[index]);
+
+        for (uint32_t iter = 0; iter < BENCH_BUS_SAMPLES; ++iter)
+        {
+            read_sampler.begin();
+            _i2c_bus.read(addr, buffer, sizeof(buffer));
+            read_sampler.end();
+
+            write_sampler.begin();
+            _i2c_bus.write(addr, buffer, sizeof(buffer));
+            write_sampler.end();
+        }
+
+        snprintf(name, sizeof(name), "i2c.read.%lukhz", (unsigned long)khz);
+        read_sampler.print(_serial, name, sizeof(buffer));
+        snprintf(name, sizeof(name), "i2c.write.%lukhz", (unsigned long)khz);
+        write_sampler.print(_serial, name, sizeof(buffer));
+        _cases += 2;
+    }
+
+    // Alternating between a device at Fast-mode Plus and one at the bus clock switches on every transaction
+    {
+        Sampler sampler(_overhead);
+
+        for (uint32_t iter = 0; iter < BENCH_BUS_SAMPLES; ++iter)
+        {
+            sampler.begin();
+            _i2c_bus.probe((iter & 1) ? other : addr);
+            sampler.end();
+        }
+
+        sampler.print(_serial, "i2c.probe.switching", 0);
+        ++_cases;
+    }
+
+    _i2c_bus.setDeviceClock(addr, 0);
+
+    switches = _i2c_bus.clockSwitches() - switches;
+    cycles   = _i2c_bus.clockSwitchCycles() - cycles;
+    _serial.printf("BENCH_INFO,i2c_switch_cycles,%lu\r\n", (unsigned long)(switches ? cycles / switches : 0));
+}
+
+void HALBench::runUART()
+{
+    Sampler sampler(_overhead);
+
+    // Lines are prefixed so that they are ignored when results are parsed
+    for (uint32_t iter = 0; iter < BENCH_PRINT_SAMPLES; ++iter)
+    {
+        sampler.begin();
+        _serial.printf("# printf %lu\r\n", (unsigned long)iter);
+        sampler.end();
+    }
+
+    sampler.print(_serial, "uart.printf", 12);
+    ++_cases;
+}
+
+void HALBench::runTimer()
+{
+    Sampler  interval_sampler(0);
+    Sampler  entry_sampler(0);
+    uint32_t period = (uint32_t)(((uint64_t)HAL::cpuFrequency() * BENCH_TIMER_PERIOD_US) / 1000000UL);
+    uint32_t start;
+    uint32_t first;
+
+    timer_count = 0;
+    _timer.init(BENCH_TIMER_PERIOD_US);
+    _timer.attachInterrupt(timerISR);
+
+    start = HAL::cycles();
+    _timer.start();
+
+    while (timer_count < BENCH_TIMER_CAPTURES)
+        HAL::delay_us(10);
+
+    _timer.stop();
+
+    // Entry latency is counted from the expected expiry of the first period
+    first = timer_captures[0] - start;
+    entry_sampler.add((first > period) ? (first - period) : 0);
+
+    for (uint8_t iter = 1; iter < BENCH_TIMER_CAPTURES; ++iter)
+        interval_sampler.add(timer_captures[iter] - timer_captures[iter - 1]);
+
+    interval_sampler.print(_serial, "timer.interval", BENCH_TIMER_PERIOD_US);
+    entry_sampler.print(_serial, "timer.entry", BENCH_TIMER_PERIOD_US);
+    _cases += 2;
+}
+
+void HALBench::runFormat()
+{
+    char     fixed_text[16];
+    char     float_text[16];
+    Sampler  fixed_sampler(_overhead);
+    Sampler  float_sampler(_overhead);
+    uint32_t mismatches = 0;
+
+    // Readings from -20.00 to about 50; both paths must produce the same text
+    for (uint32_t iter = 0; iter < BENCH_FAST_SAMPLES; ++iter)
+    {
+        int32_t value = (int32_t)(iter * 7) - 2000;
+
+        fixed_sampler.begin();
+        formatFixed(fixed_text, value, BENCH_FORMAT_FRAC, BENCH_FORMAT_WIDTH);
+        fixed_sampler.end();
+
+        float_sampler.begin();
+        snprintf(float_text, sizeof(float_text), "%05.2f", value / 100.0);
+        float_sampler.end();
+
+        if (0 != strcmp(fixed_text, float_text)) ++mismatches;
+    }
+
+    fixed_sampler.print(_serial, "format.fixed", BENCH_FORMAT_WIDTH);
+    float_sampler.print(_serial, "format.snprintf_float", BENCH_FORMAT_WIDTH);
+    _serial.printf("BENCH_INFO,format_mismatches,%lu\r\n", (unsigned long)mismatches);
+    _cases += 2;
+}
+
+#if defined(HAL_BENCH_TIMELIB)
+void HALBench::runTime()
+{
+    TimeCache         cache;
+    tmElements_t      tm;
+    Sampler           timelib_sampler(_overhead);
+    Sampler           cache_sampler(_overhead);
+    Sampler           break_sampler(_overhead);
+    volatile uint32_t sink = 0;
+    time_t            t    = BENCH_TIME_START;
+
+    cache.update(t);
+
+    // Six fields of each new second: per-field TimeLib calls, which break the timestamp down again on the first
+    // call after it changes, against a TimeCache step and plain loads
+    for (uint32_t iter = 0; iter < BENCH_FAST_SAMPLES; ++iter)
+    {
+        ++t;
+
+        timelib_sampler.begin();
+        sink = sink + second(t) + minute(t) + hour(t) + day(t) + month(t) + year(t);
+        timelib_sampler.end();
+
+        cache_sampler.begin();
+        cache.update(t);
+        sink = sink + cache.fields().Second + cache.fields().Minute + cache.fields().Hour + cache.fields().Day +
+               cache.fields().Month + cache.fields().Year;
+        cache_sampler.end();
+
+        break_sampler.begin();
+        breakTime(t, tm);
+        break_sampler.end();
+
+        sink = sink + tm.Second;
+    }
+
+    timelib_sampler.print(_serial, "time.timelib.fields", 6);
+    cache_sampler.print(_serial, "time.cache.fields", 6);
+    break_sampler.print(_serial, "time.breakTime", 1);
+    _cases += 3;
+}
+#endif
+
+void HALBench::runQueue()
+{
+    HAL::SPSCQueue<HAL::DMAEvent, BENCH_QUEUE_DEPTH> spsc;
+    HAL::MPSCQueue<HAL::DMAEvent, BENCH_QUEUE_DEPTH> mpsc;
+    HAL::DMAEvent event = { };
+    Sampler       spsc_push_sampler(_overhead);
+    Sampler       spsc_pop_sampler(_overhead);
+    Sampler       mpsc_push_sampler(_overhead);
+    Sampler       mpsc_pop_sampler(_overhead);
+
+    // One element in and out per sample, so the indices wrap but the queue never fills
+    for (uint32_t iter = 0; iter < BENCH_FAST_SAMPLES; ++iter)
+    {
+        event.len = iter;
+
+        spsc_push_sampler.begin();
+        spsc.push(event);
+        spsc_push_sampler.end();
+
+        spsc_pop_sampler.begin();
+        spsc.pop(event);
+        spsc_pop_sampler.end();
+
+        mpsc_push_sampler.begin();
+        mpsc.push(event);
+        mpsc_push_sampler.end();
+
+        mpsc_pop_sampler.begin();
+        mpsc.pop(event);
+        mpsc_pop_sampler.end();
+    }
+
+    spsc_push_sampler.print(_serial, "queue.spsc.push", sizeof(event));
+    spsc_pop_sampler.print(_serial, "queue.spsc.pop", sizeof(event));
+    mpsc_push_sampler.print(_serial, "queue.mpsc.push", sizeof(event));
+    mpsc_pop_sampler.print(_serial, "queue.mpsc.pop", sizeof(event));
+    _cases += 4;
+}
+
+void HALBench::timerISR()
+{
+    uint32_t now = HAL::cycles();
+
+    if (timer_count < BENCH_TIMER_CAPTURES)
+    {
+        timer_captures[timer_count] = now;
+        timer_count = timer_count + 1;
+    }
+}
+
+}
+
+// EOF
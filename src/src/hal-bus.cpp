@@ -0,0 +1,57 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-bus.cpp
+// Purpose     : Hardware Abstraction Layer Bus Registry
+// Description : This source file implements header file hal-bus.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "hal-bus.h"
+
+namespace HAL
+{
+
+// Objects are function statics so that they exist before any static initializer elsewhere takes a reference.
+// Channel lists follow the compile-time mapping in hal-i2c.h, hal-spi.h and hal-uart.h.
+
+I2C& i2cBus(uint8_t channel)
+{
+    static I2C buses[] = {
+        I2C(0),
+#if defined(HAL_I2C1_SERCOM)
+        I2C(1),
+#endif
+    };
+
+    return buses[(channel < sizeof(buses) / sizeof(buses[0])) ? channel : 0];
+}
+
+SPI& spiBus(uint8_t channel)
+{
+    static SPI buses[] = {
+        SPI(0),
+#if defined(HAL_SPI1_SERCOM)
+        SPI(1),
+#endif
+    };
+
+    return buses[(channel < sizeof(buses) / sizeof(buses[0])) ? channel : 0];
+}
+
+UART& uartBus(uint8_t channel)
+{
+    static UART ports[] = {
+        UART(0),
+#if defined(HAL_UART1_PORT)
+        UART(1),
+#endif
+    };
+
+    return ports[(channel < sizeof(ports) / sizeof(ports[0])) ? channel : 0];
+}
+
+}
+
+// EOF
@@ -0,0 +1,175 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-busstats.cpp
+// Purpose     : Hardware Abstraction Layer Bus Statistics
+// Description : This source file implements header file hal-busstats.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "hal-busstats.h"
+
+#if defined(HAL_BUS_STATS)
+
+#include <string.h>
+#include "hal.h"
+
+namespace HAL
+{
+
+static const char * const BUS_STATS_NAMES[] = { "i2c", "spi", "uart" };
+
+static DeviceStats stats_table[HAL_BUS_STATS_DEVICES];
+static uint8_t     stats_devices   = 0;
+static uint32_t    stats_untracked = 0;
+static uint32_t    stats_start_us  = 0;
+static bool        stats_started   = false;
+
+// Index of the device, adding it if there is room; HAL_BUS_STATS_DEVICES if there is not
+static uint8_t findDevice(uint8_t bus, uint8_t channel, uint8_t addr, bool add)
+{
+    for (uint8_t iter = 0; iter < stats_devices; ++iter)
+    {
+        const DeviceStats& entry = stats_table[iter];
+
+        if ((entry.addr == addr) && (entry.bus == bus) && (entry.channel == channel))
+            return iter;
+    }
+
+    if (!add || (stats_devices >= HAL_BUS_STATS_DEVICES))
+        return HAL_BUS_STATS_DEVICES;
+
+    memset(&stats_table[stats_devices], 0, sizeof(DeviceStats));
+    stats_table[stats_devices].bus     = bus;
+    stats_table[stats_devices].channel = channel;
+    stats_table[stats_devices].addr    = addr;
+
+    return stats_devices++;
+}
+
+// Power of two latency bucket
+static uint8_t bucket(uint32_t elapsed_us)
+{
+    uint8_t bits = 0;
+
+    while ((0 != elapsed_us) && (bits < DeviceStats::BUCKETS - 1))
+    {
+        elapsed_us >>= 1;
+        ++bits;
+    }
+
+    return bits;
+}
+
+void busStatsRecord(uint32_t start_us, uint32_t end_us, uint8_t bus, uint8_t channel, uint8_t addr, uint32_t bytes,
+                    uint8_t error)
+{
+    uint32_t        elapsed_us = end_us - start_us;
+    CriticalSection lock;
+
+    // UART traffic is not accounted; dumping the counters would otherwise perturb them
+    if (BUS_UART == bus) return;
+
+    if (!stats_started)
+    {
+        stats_start_us = start_us;
+        stats_started  = true;
+    }
+
+    uint8_t index = findDevice(bus, channel, addr, true);
+
+    if (HAL_BUS_STATS_DEVICES == index)
+    {
+        ++stats_untracked;
+        return;
+    }
+
+    DeviceStats& entry = stats_table[index];
+
+    ++entry.transactions;
+    entry.bytes   += bytes;
+    entry.busy_us += elapsed_us;
+    if (elapsed_us > entry.max_us) entry.max_us = elapsed_us;
+    ++entry.histogram[bucket(elapsed_us)];
+
+    if (0 != error)
+    {
+        ++entry.errors;
+        if ((BUS_I2C == bus) && ((I2C_ERROR_NACK_ADDR == error) || (I2C_ERROR_NACK_DATA == error)))
+            ++entry.nacks;
+    }
+}
+
+bool busStats(uint8_t bus, uint8_t channel, uint8_t addr, DeviceStats& stats)
+{
+    CriticalSection lock;
+    uint8_t         index = findDevice(bus, channel, addr, false);
+
+    if (HAL_BUS_STATS_DEVICES == index) return false;
+
+    stats = stats_table[index];
+
+    return true;
+}
+
+uint8_t busStatsDevices()
+{
+    return stats_devices;
+}
+
+bool busStatsAt(uint8_t index, DeviceStats& stats)
+{
+    CriticalSection lock;
+
+    if (index >= stats_devices) return false;
+
+    stats = stats_table[index];
+
+    return true;
+}
+
+uint32_t busStatsWindow()
+{
+    return stats_started ? (HAL::micros() - stats_start_us) : 0;
+}
+
+void busStatsDump(const UART& serial)
+{
+    DeviceStats entry;
+
+    serial.printf("BUS_STATS_BEGIN,%u,%lu,%lu\r\n", (unsigned)busStatsDevices(), (unsigned long)busStatsWindow(),
+                  (unsigned long)stats_untracked);
+
+    for (uint8_t index = 0; busStatsAt(index, entry); ++index)
+    {
+        const char * name = (entry.bus <= BUS_UART) ? BUS_STATS_NAMES[entry.bus] : "?";
+
+        serial.printf("BUS_STATS,%s,%u,0x%02X,%lu,%lu,%lu,%lu,%lu,%lu", name, (unsigned)entry.channel,
+                      (unsigned)entry.addr, (unsigned long)entry.transactions, (unsigned long)entry.bytes,
+                      (unsigned long)entry.errors, (unsigned long)entry.nacks, (unsigned long)entry.busy_us,
+                      (unsigned long)entry.max_us);
+
+        for (uint8_t iter = 0; iter < DeviceStats::BUCKETS; ++iter)
+            serial.printf(",%lu", (unsigned long)entry.histogram[iter]);
+
+        serial.printf("\r\n");
+    }
+
+    serial.printf("BUS_STATS_END\r\n");
+}
+
+void busStatsClear()
+{
+    CriticalSection lock;
+
+    stats_devices   = 0;
+    stats_untracked = 0;
+    stats_started   = false;
+}
+
+}
+
+#endif // HAL_BUS_STATS
+
+// EOF
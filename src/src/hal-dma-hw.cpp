@@ -0,0 +1,136 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-dma-hw.cpp
+// Purpose     : Hardware Abstraction Layer DMA Scheduler Backend
+// Description : This source file implements header file hal-dma-hw.h on the SAMD21 DMAC.
+// Language    : C++
+// Platform    : Seeeduino Xiao
+// Framework   : Arduino
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "hal.h"
+#include "hal-dma-hw.h"
+
+namespace HAL
+{
+
+// The DMAC fetches each channel's first descriptor from the base array and writes its state back to the other
+static DmacDescriptor base_descriptors[HAL_DMA_CHANNELS] __attribute__((aligned(16)));
+static DmacDescriptor writeback_descriptors[HAL_DMA_CHANNELS] __attribute__((aligned(16)));
+static DmacDescriptor linked_descriptors[HAL_DMA_CHANNELS][(HAL_DMA_SEGMENTS > 1) ? (HAL_DMA_SEGMENTS - 1) : 1]
+                      __attribute__((aligned(16)));
+
+static bool dmac_started = false;
+
+// Clock and enable the DMAC on first use
+static void startDMAC()
+{
+    if (dmac_started) return;
+
+    PM->AHBMASK.reg  |= PM_AHBMASK_DMAC;
+    PM->APBBMASK.reg |= PM_APBBMASK_DMAC;
+
+    DMAC->CTRL.reg = 0;
+    DMAC->CTRL.reg = DMAC_CTRL_SWRST;
+    while (DMAC->CTRL.bit.SWRST);
+
+    DMAC->BASEADDR.reg = (uint32_t)base_descriptors;
+    DMAC->WRBADDR.reg  = (uint32_t)writeback_descriptors;
+    DMAC->CTRL.reg     = DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN(0xF);
+
+    NVIC_EnableIRQ(DMAC_IRQn);
+    dmac_started = true;
+}
+
+// Complete a channel whose transfer has ended; called from the interrupt or with interrupts masked
+static void service(uint8_t dma_channel)
+{
+    uint8_t flags;
+
+    DMAC->CHID.reg = dma_channel;
+    flags          = DMAC->CHINTFLAG.reg & (DMAC_CHINTFLAG_TCMPL | DMAC_CHINTFLAG_TERR);
+
+    if (0 == flags) return;
+
+    DMAC->CHINTFLAG.reg = flags;
+
+    dmaComplete(dma_channel, (flags & DMAC_CHINTFLAG_TERR) ? DMA_ERROR_TRANSFER : 0);
+}
+
+void dmaHwStart(uint8_t dma_channel, const DMARequest& request)
+{
+    uint8_t          used = 0;
+    DmacDescriptor * prev = nullptr;
+
+    startDMAC();
+
+    // One descriptor per segment, chained; empty segments are left out
+    for (uint8_t iter = 0; iter < request.count; ++iter)
+    {
+        const DMASegment& seg  = request.segs[iter];
+        DmacDescriptor *  desc;
+
+        if (0 == seg.len) continue;
+
+        desc = (0 == used) ? &base_descriptors[dma_channel] : &linked_descriptors[dma_channel][used - 1];
+
+        desc->BTCTRL.reg   = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BEATSIZE_BYTE | DMAC_BTCTRL_SRCINC |
+                             DMAC_BTCTRL_BLOCKACT_NOACT;
+        desc->BTCNT.reg    = (uint16_t)seg.len;
+        desc->SRCADDR.reg  = (uint32_t)(seg.data + seg.len); // End address, as the source increments
+        desc->DSTADDR.reg  = (uint32_t)request.dest;
+        desc->DESCADDR.reg = 0;
+
+        if (prev) prev->DESCADDR.reg = (uint32_t)desc;
+
+        prev = desc;
+        ++used;
+    }
+
+    // One beat per peripheral trigger; the transfer starts as soon as the peripheral requests data
+    CriticalSection lock;
+
+    DMAC->CHID.reg       = dma_channel;
+    DMAC->CHCTRLA.reg    = 0;
+    while (DMAC->CHCTRLA.bit.ENABLE);
+    DMAC->CHCTRLA.reg    = DMAC_CHCTRLA_SWRST;
+    while (DMAC->CHCTRLA.bit.SWRST);
+    DMAC->CHCTRLB.reg    = DMAC_CHCTRLB_LVL(0) | DMAC_CHCTRLB_TRIGSRC(request.trigger) |
+                           DMAC_CHCTRLB_TRIGACT_BEAT;
+    DMAC->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL | DMAC_CHINTENSET_TERR;
+    DMAC->CHCTRLA.reg    = DMAC_CHCTRLA_ENABLE;
+}
+
+// Interrupts are masked by the caller
+void dmaHwStop(uint8_t dma_channel)
+{
+    DMAC->CHID.reg      = dma_channel;
+    DMAC->CHCTRLA.reg   = 0;
+    while (DMAC->CHCTRLA.bit.ENABLE);
+    DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL | DMAC_CHINTFLAG_TERR;
+}
+
+void dmaHwService(uint8_t dma_channel)
+{
+    CriticalSection lock;
+    service(dma_channel);
+}
+
+}
+
+// DMAC interrupt, shared by all channels; the channel selection is restored for any interrupted access
+extern "C" void DMAC_Handler(void)
+{
+    uint8_t  saved   = DMAC->CHID.reg;
+    uint32_t pending = DMAC->INTSTATUS.reg;
+
+    for (uint8_t iter = 0; iter < HAL_DMA_CHANNELS; ++iter)
+    {
+        if (pending & (1UL << iter)) HAL::service(iter);
+    }
+
+    DMAC->CHID.reg = saved;
+}
+
+// EOF
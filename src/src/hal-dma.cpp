@@ -0,0 +1,207 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-dma.cpp
+// Purpose     : Hardware Abstraction Layer DMA Scheduler
+// Description : This source file implements header file hal-dma.h on the backend interface of hal-dma-hw.h, and is
+//               compiled by both the target and the native build.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "hal.h"
+#include "hal-dma.h"
+#include "hal-dma-hw.h"
+#include "hal-queue.h"
+
+namespace HAL
+{
+
+// Byte count of one descriptor
+static const uint32_t DMA_SEGMENT_MAX = 0xFFFF;
+
+// Job per DMAC channel; a channel is claimed for exactly the duration of one job, from submission until its end
+// has been settled in thread context
+struct Job
+{
+    volatile bool    active;
+    volatile bool    ended;
+    volatile uint8_t error;
+    uint8_t          bus;
+    uint8_t          channel;
+    uint8_t          addr;
+    uint8_t          tag;
+    uint32_t         len;
+    uint32_t         start_us;
+    uint32_t         timeout_us;
+    DMADone          done;
+    void *           ctx;
+};
+
+static Job jobs[HAL_DMA_CHANNELS];
+
+static MPSCQueue<DMAEvent, HAL_DMA_EVENTS> events;
+static uint32_t dropped_events = 0;
+
+// DMAC channel running a bus channel's job; HAL_DMA_CHANNELS if none
+static uint8_t findJob(uint8_t bus, uint8_t channel)
+{
+    for (uint8_t iter = 0; iter < HAL_DMA_CHANNELS; ++iter)
+    {
+        if (jobs[iter].active && (jobs[iter].bus == bus) && (jobs[iter].channel == channel)) return iter;
+    }
+
+    return HAL_DMA_CHANNELS;
+}
+
+// End a job that has outlived its deadline; interrupts are masked
+static void expire(uint8_t dma_channel)
+{
+    Job& job = jobs[dma_channel];
+
+    if (!job.active || job.ended || ((HAL::micros() - job.start_us) <= job.timeout_us)) return;
+
+    dmaHwStop(dma_channel);
+    dmaComplete(dma_channel, DMA_ERROR_TIMEOUT);
+}
+
+// Note the end of a job and its status only; the rest waits for settle(), as the DMAC interrupt may be the caller
+void dmaComplete(uint8_t dma_channel, uint8_t error)
+{
+    Job& job = jobs[dma_channel];
+
+    if (!job.active || job.ended) return;
+
+    job.error = error;
+    job.ended = true;
+}
+
+// Let an ended job's bus finish, record the job, free the channel and post the event; interrupts are enabled
+static void settle(uint8_t dma_channel)
+{
+    Job&     job   = jobs[dma_channel];
+    DMAEvent event = { job.bus, job.channel, job.addr, job.tag, job.error, job.len };
+
+    if (!job.active || !job.ended) return;
+
+    event.error = job.done ? job.done(job.ctx, job.error) : job.error;
+    HAL_BUS_RECORD(job.start_us, job.bus, job.channel, job.addr, job.len, 0, event.error);
+    job.ended  = false;
+    job.active = false;
+
+    if (!events.push(event)) ++dropped_events;
+}
+
+bool dmaPoll(DMAEvent& event)
+{
+    for (uint8_t iter = 0; iter < HAL_DMA_CHANNELS; ++iter)
+    {
+        {
+            CriticalSection lock;
+            expire(iter);
+        }
+
+        settle(iter);
+    }
+
+    return events.pop(event);
+}
+
+uint8_t dmaChannelsFree()
+{
+    uint8_t count = 0;
+
+    for (uint8_t iter = 0; iter < HAL_DMA_CHANNELS; ++iter)
+    {
+        if (!jobs[iter].active) ++count;
+    }
+
+    return count;
+}
+
+uint32_t dmaDropped()
+{
+    return dropped_events;
+}
+
+uint32_t dmaLength(const DMASegment * segs, uint8_t count)
+{
+    uint32_t len = 0;
+
+    if (count > HAL_DMA_SEGMENTS) return 0;
+
+    for (uint8_t iter = 0; iter < count; ++iter)
+    {
+        if (segs[iter].len > DMA_SEGMENT_MAX) return 0;
+        len += segs[iter].len;
+    }
+
+    return len;
+}
+
+uint8_t dmaSubmit(const DMARequest& request)
+{
+    uint32_t len         = dmaLength(request.segs, request.count);
+    uint8_t  dma_channel = HAL_DMA_CHANNELS;
+
+    if (0 == len) return DMA_ERROR_LENGTH;
+
+    {
+        CriticalSection lock;
+
+        if (HAL_DMA_CHANNELS != findJob(request.bus, request.channel)) return DMA_ERROR_BUSY;
+
+        for (uint8_t iter = 0; (iter < HAL_DMA_CHANNELS) && (HAL_DMA_CHANNELS == dma_channel); ++iter)
+        {
+            if (!jobs[iter].active) dma_channel = iter;
+        }
+
+        if (HAL_DMA_CHANNELS == dma_channel) return DMA_ERROR_BUSY;
+
+        Job& job = jobs[dma_channel];
+
+        job.active     = true;
+        job.ended      = false;
+        job.error      = 0;
+        job.bus        = request.bus;
+        job.channel    = request.channel;
+        job.addr       = request.addr;
+        job.tag        = request.tag;
+        job.len        = len;
+        job.start_us   = HAL::micros();
+        job.timeout_us = request.timeout_us;
+        job.done       = request.done;
+        job.ctx        = request.ctx;
+    }
+
+    dmaHwStart(dma_channel, request);
+
+    return 0;
+}
+
+bool dmaActive(uint8_t bus, uint8_t channel)
+{
+    return HAL_DMA_CHANNELS != findJob(bus, channel);
+}
+
+// Served here rather than left to the interrupt, which may be masked or outranked by the caller
+void dmaWait(uint8_t bus, uint8_t channel)
+{
+    uint8_t dma_channel;
+
+    while (HAL_DMA_CHANNELS != (dma_channel = findJob(bus, channel)))
+    {
+        dmaHwService(dma_channel);
+
+        {
+            CriticalSection lock;
+            expire(dma_channel);
+        }
+
+        settle(dma_channel);
+    }
+}
+
+}
+
+// EOF
@@ -1,9 +1,10 @@
 //--------------------------------------------------------------------------------------------------------------------
 // Name        : hal-gpio.cpp
 // Purpose     : Hardware Abstraction Layer GPIO
-// Description : This source file implements header file hal-gpio.h.
+// Description : This source file implements header file hal-gpio.h, and is compiled by both the target and
+//               the native build.
 // Language    : C++
-// Platform    : Seeeduino Xiao
+// Platform    : Portable
 // Framework   : Arduino
 // Copyright   : MIT License 2024, John Greenwell
 //--------------------------------------------------------------------------------------------------------------------
@@ -38,6 +39,16 @@ uint8_t GPIO::digitalRead() const
     return ::digitalRead(_pin_number);
 }
 
+void GPIO::attachInterrupt(void (*isr)(), uint8_t mode) const
+{
+    ::attachInterrupt(digitalPinToInterrupt(_pin_number), isr, mode);
+}
+
+void GPIO::detachInterrupt() const
+{
+    ::detachInterrupt(digitalPinToInterrupt(_pin_number));
+}
+
 }
 
 // EOF
@@ -1,31 +1,59 @@
 //--------------------------------------------------------------------------------------------------------------------
 // Name        : hal-gpioport.cpp
 // Purpose     : Hardware Abstraction Layer GPIO Port
-// Description : This source file implements header file hal-gpioport.h.
+// Description : This source file implements header file hal-gpioport.h, and is compiled by both the target and
+//               the native build.
 // Language    : C++
-// Platform    : Seeeduino Xiao
+// Platform    : Portable
 // Framework   : Arduino
 // Copyright   : MIT License 2024, John Greenwell
 //--------------------------------------------------------------------------------------------------------------------
 
 #include <Arduino.h>
 #include "hal-gpioport.h"
+#include "hal-bus.h"
 #include "shift-register.h"
 #include "mcp23008.h"
 
+// Ports identified by first pin number:
+//   0, 8 bits  : 74HC595 shift register (SPI)
+//   0, 12 bits : 7-segment frame; low byte segments via shift register, high nibble digit selects
+//   8          : MCP23008 expander (I2C)
+//
+// With HAL_SEG_SELECT_SR defined, digit selects are taken from a second 74HC595 chained from QH' of the
+// first, so that a 7-segment frame is emitted as a single two byte SPI burst and I2C is not touched.
+// Without it, digit selects are written to the MCP23008 as wired on the reference schematic, with the segments
+// blanked over the I2C write so that no digit shows its neighbour's pattern.
+
 // TODO: add pull-up resistor mode option
 // TODO: comprehensive functionality beyond what is needed for application
 
 namespace HAL
 {
 
+// Shift register on SPI channel 1 when the build maps one (HAL_SPI1_SERCOM), apart from the MCP23S08
+#if defined(HAL_SPI1_SERCOM)
+static const uint8_t SREG_SPI_CHANNEL = 1;
+#else
+static const uint8_t SREG_SPI_CHANNEL = 0;
+#endif
+
 // Drivers handled within the HAL implementation
-HAL::I2C i2c_bus(0);
-HAL::SPI spi_bus(0);
+static HAL::I2C&                   i2c_bus = HAL::i2cBus(0);
+static HAL::SPI&                   spi_bus = HAL::spiBus(SREG_SPI_CHANNEL);
 static const uint8_t               MCP23X08_ADDRESS = 0x20;
 static PeripheralIO::ShiftRegister sreg(spi_bus, PIN_A2);
 static PeripheralIO::MCP23008      i2c_io(i2c_bus, MCP23X08_ADDRESS);
 
+#if defined(HAL_SEG_SELECT_SR)
+static HAL::GPIO                   seg_latch(PIN_A2);
+#endif
+
+static bool isSegmentFrame(const uint8_t * pins, uint8_t n_bits)
+{
+    return (0 == pins[0]) && (n_bits > 8);
+}
+
 
 GPIOPort::GPIOPort(const uint8_t* pins, uint8_t len)
 : _pins()
@@ -38,7 +66,10 @@ GPIOPort::GPIOPort(const uint8_t* pins, uint8_t len)
 void GPIOPort::init() const
 {
     if (0 == _pins[0]) // Only the shift register requires initialization
+    {
+        if (0 != SREG_SPI_CHANNEL) spi_bus.init(); // Channel 0 is initialized with the application's SPI bus
         sreg.init();
+    }
 }
 
 bool GPIOPort::pinMode(uint8_t pin, uint8_t mode) const
@@ -68,7 +99,7 @@ bool GPIOPort::pinMode(uint8_t pin, uint8_t mode) const
 
 void GPIOPort::portMode(uint8_t mode) const
 {
-    if (8 == _pins[0])
+    if ((8 == _pins[0]) || isSegmentFrame(_pins, _n_bits))
     {
         if (GPIO_OUTPUT== mode)
             i2c_io.write(PeripheralIO::MCP23008_IODIR, 0xF0);
@@ -89,10 +120,28 @@ uint8_t GPIOPort::digitalRead(uint8_t pin) const
 
 void GPIOPort::write(uint32_t val) const
 {
-    if (0 == _pins[0])
+    if (isSegmentFrame(_pins, _n_bits))
+    {
+#if defined(HAL_SEG_SELECT_SR)
+        seg_latch.digitalWrite(LOW);
+        spi_bus.transfer(~(uint8_t)(val >> 8)); // Shifted through to the chained select register
+        spi_bus.transfer((uint8_t)val);
+        seg_latch.digitalWrite(HIGH);
+#else
+        // Segments are blanked while the selects change, or the new pattern would show on the old digit
+        sreg.write(0);
+        i2c_io.write(~(uint8_t)(val >> 8));
+        sreg.write((uint8_t)val);
+#endif
+    }
+    else if (0 == _pins[0])
+    {
         sreg.write((uint8_t)val);
+    }
     else
+    {
         i2c_io.write(~(uint8_t)val);
+    }
 }
 
 uint32_t GPIOPort::read() const
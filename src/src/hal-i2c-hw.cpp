@@ -0,0 +1,203 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-i2c-hw.cpp
+// Purpose     : Hardware Abstraction Layer I2C Backend
+// Description : This source file implements header file hal-i2c-hw.h on the SAMD21 SERCOM behind each TwoWire.
+// Language    : C++
+// Platform    : Seeeduino Xiao
+// Framework   : Arduino
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <wiring_private.h>
+#include "hal.h"
+#include "hal-i2c.h"
+#include "hal-i2c-hw.h"
+
+namespace HAL
+{
+
+static const uint32_t I2C_FAST_MODE_HZ  = 400000;
+
+// Bus clear: at most one byte and an acknowledge clocked out, at roughly 100 kHz
+static const uint8_t  I2C_CLEAR_PULSES  = 9;
+static const uint32_t I2C_CLEAR_HALF_US = 5;
+
+// DMA writes: the last byte and its acknowledge take at most one byte time at 100 kHz after the DMAC finishes
+static const uint32_t I2C_DMA_SETTLE_US = 100;
+
+// SERCOM behind Wire, and its DMAC trigger
+#if !defined(HAL_I2C_SERCOM)
+#define HAL_I2C_SERCOM SERCOM2
+#endif
+#if !defined(HAL_I2C_DMAC_TX)
+#define HAL_I2C_DMAC_TX SERCOM2_DMAC_ID_TX
+#endif
+
+// Second channel on a further SERCOM, given by number, with its pad 0 (SDA) and pad 1 (SCL) pins
+#if defined(HAL_I2C1_SERCOM)
+#if !defined(HAL_I2C1_SDA) || !defined(HAL_I2C1_SCL)
+#error "HAL_I2C1_SERCOM requires HAL_I2C1_SDA and HAL_I2C1_SCL"
+#endif
+#if !defined(HAL_I2C1_PIO)
+#define HAL_I2C1_PIO PIO_SERCOM_ALT
+#endif
+#define HAL_I2C_PASTE(a, b)  a ## b
+#define HAL_I2C_SERCOM_N(a, b) HAL_I2C_PASTE(a, b)
+#define HAL_I2C_PASTE3(a, b, c) a ## b ## c
+#define HAL_I2C_DMAC_TX_N(n)    HAL_I2C_PASTE3(SERCOM, n, _DMAC_ID_TX)
+
+static TwoWire Wire1(&HAL_I2C_SERCOM_N(sercom, HAL_I2C1_SERCOM), HAL_I2C1_SDA, HAL_I2C1_SCL);
+#endif
+
+// Peripheral per channel
+struct Port
+{
+    TwoWire& wire;
+    Sercom * sercom;
+    uint8_t  dma_trigger;
+    uint8_t  sda;
+    uint8_t  scl;
+    EPioType pio;
+};
+
+// Master transfers are polled by Wire, and DMA writes completed from the DMAC interrupt, so no channel needs a
+// SERCOM interrupt handler
+static const Port ports[I2C_CHANNELS] = {
+    { ::Wire, HAL_I2C_SERCOM, HAL_I2C_DMAC_TX, PIN_WIRE_SDA, PIN_WIRE_SCL, PIO_NOT_A_PIN },
+#if defined(HAL_I2C1_SERCOM)
+    { Wire1, HAL_I2C_SERCOM_N(SERCOM, HAL_I2C1_SERCOM), HAL_I2C_DMAC_TX_N(HAL_I2C1_SERCOM), HAL_I2C1_SDA,
+      HAL_I2C1_SCL, HAL_I2C1_PIO },
+#endif
+};
+
+// Drive a bus line low or release it to the pull-up; output latch is held low so the line is never driven high
+static void driveLine(uint8_t pin, bool low)
+{
+    pinMode(pin, low ? OUTPUT : INPUT);
+}
+
+TwoWire& i2cHwWire(uint8_t channel)
+{
+    return ports[channel].wire;
+}
+
+// A TwoWire muxes its pins with the variant's pin type, which suits only Wire's own pins
+void i2cHwBegin(uint8_t channel)
+{
+    const Port& port = ports[channel];
+
+    port.wire.begin();
+
+    if (PIO_NOT_A_PIN != port.pio)
+    {
+        pinPeripheral(port.sda, port.pio);
+        pinPeripheral(port.scl, port.pio);
+    }
+}
+
+// Wire.setClock() reinitializes the SERCOM with SPEED and both timeouts cleared, so all three are set here;
+// a device holding SCL low then ends the transfer with a bus error after 25-35 ms instead of hanging Wire, which
+// rules out longer clock stretching (see hal-i2c.h)
+void i2cHwClock(uint8_t channel, uint32_t hz)
+{
+    const Port& port = ports[channel];
+
+    port.wire.setClock(hz);
+
+    port.sercom->I2CM.CTRLA.bit.ENABLE = 0;
+    while (port.sercom->I2CM.SYNCBUSY.bit.ENABLE);
+    port.sercom->I2CM.CTRLA.bit.SPEED     = (hz > I2C_FAST_MODE_HZ) ? 1 : 0;
+    port.sercom->I2CM.CTRLA.bit.LOWTOUTEN = 1;
+    port.sercom->I2CM.CTRLA.bit.INACTOUT  = 3;
+    port.sercom->I2CM.CTRLA.bit.ENABLE    = 1;
+    while (port.sercom->I2CM.SYNCBUSY.bit.ENABLE);
+    port.sercom->I2CM.STATUS.bit.BUSSTATE = 1; // Force idle, as Wire does on enable
+    while (port.sercom->I2CM.SYNCBUSY.bit.SYSOP);
+}
+
+// The pins are taken from the SERCOM and bit-banged, then handed back to it
+uint8_t i2cHwClear(uint8_t channel, uint32_t hz)
+{
+    const Port& port   = ports[channel];
+    uint8_t     pulses = 0;
+    bool        released;
+
+    port.wire.end();
+
+    pinMode(port.sda, INPUT);
+    pinMode(port.scl, INPUT);
+    digitalWrite(port.sda, LOW);
+    digitalWrite(port.scl, LOW);
+
+    while ((LOW == digitalRead(port.sda)) && (pulses < I2C_CLEAR_PULSES))
+    {
+        driveLine(port.scl, true);
+        delayMicroseconds(I2C_CLEAR_HALF_US);
+        driveLine(port.scl, false);
+        delayMicroseconds(I2C_CLEAR_HALF_US);
+        ++pulses;
+    }
+
+    // Stop: SDA rises while SCL is high
+    driveLine(port.sda, true);
+    delayMicroseconds(I2C_CLEAR_HALF_US);
+    driveLine(port.sda, false);
+    delayMicroseconds(I2C_CLEAR_HALF_US);
+
+    released = (HIGH == digitalRead(port.sda)) && (HIGH == digitalRead(port.scl));
+
+    i2cHwBegin(channel);
+    i2cHwClock(channel, hz);
+
+    return released ? 0 : I2C_ERROR_BUS;
+}
+
+void i2cHwWriteRequest(uint8_t channel, DMARequest& request)
+{
+    request.trigger = ports[channel].dma_trigger;
+    request.dest    = &ports[channel].sercom->I2CM.DATA.reg;
+}
+
+// The SERCOM raises the first data trigger once the address is acknowledged, and ends the data phase by its own
+// length counter
+void i2cHwWriteStart(uint8_t channel, uint8_t addr, uint32_t len)
+{
+    ports[channel].sercom->I2CM.ADDR.reg = SERCOM_I2CM_ADDR_ADDR(addr << 1) | SERCOM_I2CM_ADDR_LENEN |
+                                           SERCOM_I2CM_ADDR_LEN(len);
+}
+
+uint8_t i2cHwWriteEnd(uint8_t channel, uint8_t error)
+{
+    Sercom * sercom = ports[channel].sercom;
+    uint32_t start  = HAL::micros();
+    uint16_t status;
+    uint8_t  result;
+
+    while ((0 == error) && !(sercom->I2CM.INTFLAG.reg & (SERCOM_I2CM_INTFLAG_MB | SERCOM_I2CM_INTFLAG_ERROR)))
+    {
+        if ((HAL::micros() - start) > I2C_DMA_SETTLE_US) error = DMA_ERROR_TIMEOUT;
+    }
+
+    status = sercom->I2CM.STATUS.reg;
+
+    // A NACK before the DMAC finished refused the address, or the transfer would have run to its end
+    if (status & (SERCOM_I2CM_STATUS_BUSERR | SERCOM_I2CM_STATUS_ARBLOST))
+        result = I2C_ERROR_BUS;
+    else if (status & SERCOM_I2CM_STATUS_RXNACK)
+        result = (0 == error) ? I2C_ERROR_NACK_DATA : I2C_ERROR_NACK_ADDR;
+    else if (DMA_ERROR_TIMEOUT == error)
+        result = I2C_ERROR_TIMEOUT;
+    else
+        result = error ? I2C_ERROR_BUS : 0;
+
+    sercom->I2CM.CTRLB.bit.CMD = 3; // Stop
+    while (sercom->I2CM.SYNCBUSY.bit.SYSOP);
+
+    return result;
+}
+
+}
+
+// EOF
@@ -1,16 +1,20 @@
 //--------------------------------------------------------------------------------------------------------------------
 // Name        : hal-i2c.cpp
 // Purpose     : Hardware Abstraction Layer I2C
-// Description : This source file implements header file hal-i2c.h.
+// Description : This source file implements header file hal-i2c.h on TwoWire and the backend interface of
+//               hal-i2c-hw.h, and is compiled by both the target and the native build.
 // Language    : C++
-// Platform    : Seeeduino Xiao
+// Platform    : Portable
 // Framework   : Arduino
 // Copyright   : MIT License 2024, John Greenwell
 //--------------------------------------------------------------------------------------------------------------------
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "hal.h"
 #include "hal-i2c.h"
+#include "hal-i2c-hw.h"
+#include "hal-instrument.h"
 
 namespace HAL
 {
@@ -18,29 +22,291 @@ namespace HAL
 // Maximum read buffer size
 static const uint8_t I2C_READ_BUFFER_MAX = 32;
 
+// Per-device clock and failure state
+struct Device
+{
+    uint8_t  addr;
+    uint8_t  failures;
+    uint32_t max_hz;
+    uint32_t backoff_ms;
+    uint32_t retry_ms;
+};
+
+static const uint8_t  I2C_MAX_DEVICES       = 8;
+static const uint8_t  I2C_NO_ADDRESS        = 0xFF;
+
+// Backoff after consecutive failures, doubling per further failure
+static const uint8_t  I2C_BACKOFF_THRESHOLD = 3;
+static const uint32_t I2C_BACKOFF_MIN_MS    = 8;
+static const uint32_t I2C_BACKOFF_MAX_MS    = 1024;
+
+// Deadline on any wait for the bus, above the SERCOM SCL low timeout so that hardware detection comes first
+static const uint32_t I2C_WAIT_TIMEOUT_US   = 40000;
+
+// DMA writes: the SERCOM length counter is one byte wide
+static const uint32_t I2C_DMA_LENGTH_MAX    = 0xFF;
+
+// Bus state per channel, shared by all I2C objects on that channel
+struct Channel
+{
+    uint8_t  index;
+    Device   devices[I2C_MAX_DEVICES];
+    uint8_t  device_count;
+    uint32_t default_clock_hz;
+    uint32_t current_clock_hz;
+    uint8_t  last_addr;
+    uint32_t clock_switches;
+    uint32_t clock_switch_cycles;
+    uint32_t recovery_count;
+    uint8_t  dma_addr;
+};
+
+static Channel channels[I2C_CHANNELS] = {
+    { 0, { }, 0, 100000, 0, I2C_NO_ADDRESS, 0, 0, 0, I2C_NO_ADDRESS },
+#if defined(HAL_I2C1_SERCOM)
+    { 1, { }, 0, 100000, 0, I2C_NO_ADDRESS, 0, 0, 0, I2C_NO_ADDRESS },
+#endif
+};
+
+// Device entry, optionally added if absent; nullptr if absent and not added or the table is full
+static Device * findDevice(Channel& bus, uint8_t addr, bool add)
+{
+    for (uint8_t iter = 0; iter < bus.device_count; ++iter)
+    {
+        if (bus.devices[iter].addr == addr) return &bus.devices[iter];
+    }
+
+    if (!add || (bus.device_count >= I2C_MAX_DEVICES)) return nullptr;
+
+    Device& device = bus.devices[bus.device_count++];
+
+    device.addr       = addr;
+    device.failures   = 0;
+    device.max_hz     = 0;
+    device.backoff_ms = 0;
+    device.retry_ms   = 0;
+
+    return &device;
+}
+
+// Switch the bus clock for the addressed device; consecutive transactions to one device share the last switch
+static void selectClock(Channel& bus, uint8_t addr)
+{
+    const Device * device;
+    uint32_t       hz;
+    uint32_t       start;
+
+    if (addr == bus.last_addr) return;
+    bus.last_addr = addr;
+
+    device = findDevice(bus, addr, false);
+    hz     = (device && device->max_hz) ? device->max_hz : bus.default_clock_hz;
+
+    if (hz == bus.current_clock_hz) return;
+
+    start = HAL::cycles();
+    i2cHwClock(bus.index, hz);
+    bus.clock_switch_cycles += HAL::cycles() - start;
+    bus.current_clock_hz     = hz;
+    ++bus.clock_switches;
+}
+
+// True while a failing device is skipped; one attempt is let through as each backoff interval ends
+static bool skipDevice(Channel& bus, uint8_t addr)
+{
+    const Device * device = findDevice(bus, addr, false);
+
+    if (!device || (device->failures < I2C_BACKOFF_THRESHOLD)) return false;
+
+    return (int32_t)(HAL::millis() - device->retry_ms) < 0;
+}
+
+// Account a transaction result to its device: absent or stalled devices back off, any success clears the backoff;
+// other errors say nothing about the device's presence and leave its count as it was
+static void account(Channel& bus, uint8_t addr, uint8_t error)
+{
+    bool     failed = (I2C_ERROR_NACK_ADDR == error) || (I2C_ERROR_TIMEOUT == error);
+    Device * device;
+
+    if (!failed && (0 != error)) return;
+
+    device = findDevice(bus, addr, failed);
+
+    if (!device) return;
+
+    if (!failed)
+    {
+        device->failures   = 0;
+        device->backoff_ms = 0;
+        return;
+    }
+
+    if (device->failures < 0xFF) ++device->failures;
+
+    if (device->failures >= I2C_BACKOFF_THRESHOLD)
+    {
+        device->backoff_ms = (0 == device->backoff_ms) ? I2C_BACKOFF_MIN_MS : (device->backoff_ms * 2);
+        if (device->backoff_ms > I2C_BACKOFF_MAX_MS) device->backoff_ms = I2C_BACKOFF_MAX_MS;
+        device->retry_ms   = HAL::millis() + device->backoff_ms;
+    }
+}
+
+// Wait for the bytes requestFrom() received to be readable
+static uint8_t awaitReceived(TwoWire& wire, uint8_t received, uint32_t start)
+{
+    while ((uint32_t)wire.available() < received)
+    {
+        if ((HAL::micros() - start) > I2C_WAIT_TIMEOUT_US) return I2C_ERROR_TIMEOUT;
+    }
+
+    return 0;
+}
+
+// Read one Wire buffer sized chunk; requestFrom() returns short when the address is not acknowledged
+static uint8_t requestChunk(TwoWire& wire, uint8_t addr, uint8_t * data, uint8_t len)
+{
+    uint32_t start    = HAL::micros();
+    uint8_t  received = wire.requestFrom(addr, len);
+
+    if (awaitReceived(wire, received, start)) return I2C_ERROR_TIMEOUT;
+
+    for (uint8_t iter = 0; iter < received; ++iter)
+        data[iter] = wire.read();
+
+    return (received < len) ? I2C_ERROR_NACK_ADDR : 0;
+}
+
+// Read in Wire buffer sized chunks, stopping at the first failed chunk
+static uint8_t requestChunks(TwoWire& wire, uint8_t addr, uint8_t * data, uint32_t len)
+{
+    uint32_t bytes_read = 0;
+    uint8_t  chunk;
+    uint8_t  error      = 0;
+
+    while ((bytes_read < len) && (0 == error))
+    {
+        chunk       = ((len - bytes_read) < I2C_READ_BUFFER_MAX) ? (len - bytes_read) : I2C_READ_BUFFER_MAX;
+        error       = requestChunk(wire, addr, &data[bytes_read], chunk);
+        bytes_read += chunk;
+    }
+
+    return error;
+}
+
+// Total length of a segment list
+static uint32_t segmentsLength(const I2CSegment * segs, uint8_t count)
+{
+    uint32_t len = 0;
+
+    for (uint8_t iter = 0; iter < count; ++iter)
+        len += segs[iter].len;
+
+    return len;
+}
+
+// Read in Wire buffer sized chunks, draining each chunk straight into the segments it spans
+static uint8_t requestSegments(TwoWire& wire, uint8_t addr, const I2CSegment * segs, uint8_t count)
+{
+    uint32_t remaining = segmentsLength(segs, count);
+    uint32_t offset    = 0;
+    uint8_t  seg       = 0;
+    uint8_t  chunk;
+    uint8_t  received;
+    uint8_t  val;
+
+    while (remaining > 0)
+    {
+        uint32_t start = HAL::micros();
+
+        chunk    = (remaining < I2C_READ_BUFFER_MAX) ? remaining : I2C_READ_BUFFER_MAX;
+        received = wire.requestFrom(addr, chunk);
+
+        if (awaitReceived(wire, received, start)) return I2C_ERROR_TIMEOUT;
+
+        for (uint8_t iter = 0; iter < received; ++iter)
+        {
+            while (offset >= segs[seg].len)
+            {
+                ++seg;
+                offset = 0;
+            }
+
+            val = wire.read();
+            if (segs[seg].data) segs[seg].data[offset] = val;
+            ++offset;
+        }
+
+        if (received < chunk) return I2C_ERROR_NACK_ADDR;
+
+        remaining -= chunk;
+    }
+
+    return 0;
+}
+
+// Complete a transaction: account the result to the device and clear the bus after a bus error or timeout
+static void finish(Channel& bus, uint8_t addr, uint8_t error)
+{
+    account(bus, addr, error);
+
+    if ((I2C_ERROR_BUS == error) || (I2C_ERROR_TIMEOUT == error))
+    {
+        i2cHwClear(bus.index, bus.current_clock_hz);
+        ++bus.recovery_count;
+    }
+}
+
+// End of a DMA write: let the backend end the transfer and account its result; from dmaPoll() or dmaWait(), so the
+// settling wait and any bus clear run in thread context
+static uint8_t writeDone(void * ctx, uint8_t error)
+{
+    Channel& bus    = *(Channel *)ctx;
+    uint8_t  result = i2cHwWriteEnd(bus.index, error);
+
+    finish(bus, bus.dma_addr, result);
+
+    return result;
+}
+
 I2C::I2C(uint8_t i2c_channel)
-: _i2c_channel(i2c_channel)
+: _i2c_channel((i2c_channel < I2C_CHANNELS) ? i2c_channel : 0)
 , _i2c_error(0)
 , _i2c_busy(false)
 { }
 
 void I2C::init(uint32_t baudrate)
 {
+    Channel& bus = channels[_i2c_channel];
+
     if (_i2c_busy) return;
+    dmaWait(BUS_I2C, _i2c_channel);
+
+    i2cHwBegin(_i2c_channel);
 
-    ::Wire.begin();
-    ::Wire.setClock(baudrate);
+    bus.default_clock_hz = baudrate;
+    bus.current_clock_hz = baudrate;
+    bus.last_addr        = I2C_NO_ADDRESS;
+    i2cHwClock(_i2c_channel, baudrate);
 }
 
 uint8_t I2C::write(uint8_t addr, uint8_t * data, uint32_t len)
 {
+    Channel& bus = channels[_i2c_channel];
+    TwoWire& wire = i2cHwWire(_i2c_channel);
+
     if (_i2c_busy) return 1;
+    dmaWait(BUS_I2C, _i2c_channel);
+    if (skipDevice(bus, addr)) return I2C_ERROR_BACKOFF;
 
     _i2c_busy = true;
-    Wire.beginTransmission(addr);
+    HAL_BUS_START(bus_start);
+    selectClock(bus, addr);
+    wire.beginTransmission(addr);
     for (uint8_t iter = 0; iter < len; ++iter)
-        Wire.write(data[iter]);
-    _i2c_error = Wire.endTransmission();
+        wire.write(data[iter]);
+    _i2c_error = wire.endTransmission();
+    finish(bus, addr, _i2c_error);
+    HAL_BUS_RECORD(bus_start, BUS_I2C, _i2c_channel, addr, len, 0, _i2c_error);
     _i2c_busy = false;
 
     return _i2c_error;
@@ -48,12 +314,21 @@ uint8_t I2C::write(uint8_t addr, uint8_t * data, uint32_t len)
 
 uint8_t I2C::write(uint8_t addr, uint8_t data)
 {
+    Channel& bus = channels[_i2c_channel];
+    TwoWire& wire = i2cHwWire(_i2c_channel);
+
     if (_i2c_busy) return 1;
+    dmaWait(BUS_I2C, _i2c_channel);
+    if (skipDevice(bus, addr)) return I2C_ERROR_BACKOFF;
 
     _i2c_busy = true;
-    Wire.beginTransmission(addr);
-    Wire.write(data);
-    _i2c_error = Wire.endTransmission();
+    HAL_BUS_START(bus_start);
+    selectClock(bus, addr);
+    wire.beginTransmission(addr);
+    wire.write(data);
+    _i2c_error = wire.endTransmission();
+    finish(bus, addr, _i2c_error);
+    HAL_BUS_RECORD(bus_start, BUS_I2C, _i2c_channel, addr, 1, 0, _i2c_error);
     _i2c_busy = false;
 
     return _i2c_error;
@@ -61,13 +336,22 @@ uint8_t I2C::write(uint8_t addr, uint8_t data)
 
 uint8_t I2C::write(uint8_t addr, uint8_t reg, uint8_t data)
 {
+    Channel& bus = channels[_i2c_channel];
+    TwoWire& wire = i2cHwWire(_i2c_channel);
+
     if (_i2c_busy) return 1;
+    dmaWait(BUS_I2C, _i2c_channel);
+    if (skipDevice(bus, addr)) return I2C_ERROR_BACKOFF;
 
     _i2c_busy = true;
-    Wire.beginTransmission(addr);
-    Wire.write(reg);
-    Wire.write(data);
-    _i2c_error = Wire.endTransmission();
+    HAL_BUS_START(bus_start);
+    selectClock(bus, addr);
+    wire.beginTransmission(addr);
+    wire.write(reg);
+    wire.write(data);
+    _i2c_error = wire.endTransmission();
+    finish(bus, addr, _i2c_error);
+    HAL_BUS_RECORD(bus_start, BUS_I2C, _i2c_channel, addr, 2, 0, _i2c_error);
     _i2c_busy = false;
 
     return _i2c_error;
@@ -75,14 +359,23 @@ uint8_t I2C::write(uint8_t addr, uint8_t reg, uint8_t data)
 
 uint8_t I2C::write(uint8_t addr, uint8_t reg, uint8_t * data, uint32_t len)
 {
+    Channel& bus = channels[_i2c_channel];
+    TwoWire& wire = i2cHwWire(_i2c_channel);
+
     if (_i2c_busy) return 1;
+    dmaWait(BUS_I2C, _i2c_channel);
+    if (skipDevice(bus, addr)) return I2C_ERROR_BACKOFF;
 
     _i2c_busy = true;
-    Wire.beginTransmission(addr);
-    Wire.write(reg);
+    HAL_BUS_START(bus_start);
+    selectClock(bus, addr);
+    wire.beginTransmission(addr);
+    wire.write(reg);
     for (uint8_t iter = 0; iter < len; ++iter)
-        Wire.write(data[iter]);
-    _i2c_error = Wire.endTransmission();
+        wire.write(data[iter]);
+    _i2c_error = wire.endTransmission();
+    finish(bus, addr, _i2c_error);
+    HAL_BUS_RECORD(bus_start, BUS_I2C, _i2c_channel, addr, 1 + len, 0, _i2c_error);
     _i2c_busy = false;
 
     return _i2c_error;
@@ -90,15 +383,24 @@ uint8_t I2C::write(uint8_t addr, uint8_t reg, uint8_t * data, uint32_t len)
 
 uint8_t I2C::write(uint8_t addr, uint16_t reg, uint8_t * data, uint32_t len)
 {
+    Channel& bus = channels[_i2c_channel];
+    TwoWire& wire = i2cHwWire(_i2c_channel);
+
     if (_i2c_busy) return 1;
+    dmaWait(BUS_I2C, _i2c_channel);
+    if (skipDevice(bus, addr)) return I2C_ERROR_BACKOFF;
 
     _i2c_busy = true;
-    Wire.beginTransmission(addr);
-    Wire.write((uint8_t)(reg >> 8));
-    Wire.write((uint8_t)(reg));
+    HAL_BUS_START(bus_start);
+    selectClock(bus, addr);
+    wire.beginTransmission(addr);
+    wire.write((uint8_t)(reg >> 8));
+    wire.write((uint8_t)(reg));
     for (uint8_t iter = 0; iter < len; ++iter)
-        Wire.write(data[iter]);
-    _i2c_error = Wire.endTransmission();
+        wire.write(data[iter]);
+    _i2c_error = wire.endTransmission();
+    finish(bus, addr, _i2c_error);
+    HAL_BUS_RECORD(bus_start, BUS_I2C, _i2c_channel, addr, 2 + len, 0, _i2c_error);
     _i2c_busy = false;
 
     return _i2c_error;
@@ -106,32 +408,28 @@ uint8_t I2C::write(uint8_t addr, uint16_t reg, uint8_t * data, uint32_t len)
 
 uint8_t I2C::read(uint8_t addr, uint8_t * data, uint32_t len)
 {
-    uint32_t bytes_read = 0;
-    uint8_t  chunk      = I2C_READ_BUFFER_MAX;
+    Channel& bus = channels[_i2c_channel];
+    TwoWire& wire = i2cHwWire(_i2c_channel);
 
     if (_i2c_busy) return 1;
+    dmaWait(BUS_I2C, _i2c_channel);
+    if (skipDevice(bus, addr)) return I2C_ERROR_BACKOFF;
 
     _i2c_busy = true;
-    Wire.beginTransmission(addr);
-    _i2c_error = Wire.endTransmission();
+    HAL_BUS_START(bus_start);
+    selectClock(bus, addr);
+    wire.beginTransmission(addr);
+    _i2c_error = wire.endTransmission();
     
     if (0 == _i2c_error)
     {
-        Wire.beginTransmission(addr);
-
-        while (bytes_read < len)
-        {
-            chunk = ((len - bytes_read) < I2C_READ_BUFFER_MAX) ? (len - bytes_read) : I2C_READ_BUFFER_MAX;
-            Wire.requestFrom(addr, (uint8_t)chunk);
-            while ((uint32_t)Wire.available() < chunk); 
-            for (uint8_t iter = 0; iter < chunk; ++iter)
-                data[iter] = Wire.read();
-            bytes_read += chunk;
-        }
-
-        Wire.endTransmission();
+        wire.beginTransmission(addr);
+        _i2c_error = requestChunks(wire, addr, data, len);
+        wire.endTransmission();
     }
     
+    finish(bus, addr, _i2c_error);
+    HAL_BUS_RECORD(bus_start, BUS_I2C, _i2c_channel, addr, 0, len, _i2c_error);
     _i2c_busy = false;
 
     return _i2c_error;
@@ -139,16 +437,22 @@ uint8_t I2C::read(uint8_t addr, uint8_t * data, uint32_t len)
 
 uint8_t I2C::read(uint8_t addr)
 {
-    uint8_t data;
+    Channel& bus  = channels[_i2c_channel];
+    TwoWire& wire = i2cHwWire(_i2c_channel);
+    uint8_t  data = 0xFF;
 
     if (_i2c_busy) return 1;
+    dmaWait(BUS_I2C, _i2c_channel);
+    if (skipDevice(bus, addr)) return data;
 
     _i2c_busy = true;
-    Wire.beginTransmission(addr);
-    Wire.requestFrom(addr, (uint8_t)1);
-    while (!Wire.available()); 
-    data = Wire.read();
-    Wire.endTransmission();
+    HAL_BUS_START(bus_start);
+    selectClock(bus, addr);
+    wire.beginTransmission(addr);
+    _i2c_error = requestChunk(wire, addr, &data, 1);
+    wire.endTransmission();
+    finish(bus, addr, _i2c_error);
+    HAL_BUS_RECORD(bus_start, BUS_I2C, _i2c_channel, addr, 0, 1, _i2c_error);
     _i2c_busy = false;
 
     return data;
@@ -156,32 +460,29 @@ uint8_t I2C::read(uint8_t addr)
 
 uint8_t I2C::writeRead(uint8_t addr, uint8_t * wr_data, uint32_t wr_len, uint8_t * r_data, uint32_t r_len)
 {
-    uint32_t bytes_read = 0;
-    uint8_t  chunk      = I2C_READ_BUFFER_MAX;
-    
+    Channel& bus = channels[_i2c_channel];
+    TwoWire& wire = i2cHwWire(_i2c_channel);
+
     if (_i2c_busy) return 1;
+    dmaWait(BUS_I2C, _i2c_channel);
+    if (skipDevice(bus, addr)) return I2C_ERROR_BACKOFF;
 
     _i2c_busy = true;
-    Wire.beginTransmission(addr);
+    HAL_BUS_START(bus_start);
+    selectClock(bus, addr);
+    wire.beginTransmission(addr);
     for (uint8_t iter = 0; iter < wr_len; ++iter)
-        Wire.write(wr_data[iter]);
-    _i2c_error = Wire.endTransmission(0);
+        wire.write(wr_data[iter]);
+    _i2c_error = wire.endTransmission(0);
 
     if (0 == _i2c_error)
     {
-        while (bytes_read < r_len)
-        {
-            chunk = ((r_len - bytes_read) < I2C_READ_BUFFER_MAX) ? (r_len - bytes_read) : I2C_READ_BUFFER_MAX;
-            Wire.requestFrom(addr, (uint8_t)chunk);
-            while ((uint32_t)Wire.available() < chunk); 
-            for (uint32_t iter = bytes_read; iter < (bytes_read + chunk); ++iter)
-                r_data[iter] = Wire.read();
-            bytes_read += chunk;
-        }
-
-        Wire.endTransmission();
+        _i2c_error = requestChunks(wire, addr, r_data, r_len);
+        wire.endTransmission();
     }
 
+    finish(bus, addr, _i2c_error);
+    HAL_BUS_RECORD(bus_start, BUS_I2C, _i2c_channel, addr, wr_len, r_len, _i2c_error);
     _i2c_busy = false;
 
     return _i2c_error;
@@ -189,21 +490,28 @@ uint8_t I2C::writeRead(uint8_t addr, uint8_t * wr_data, uint32_t wr_len, uint8_t
 
 uint8_t I2C::writeRead(uint8_t addr, uint8_t reg, uint8_t * data)
 {
+    Channel& bus = channels[_i2c_channel];
+    TwoWire& wire = i2cHwWire(_i2c_channel);
+
     if (_i2c_busy) return 1;
+    dmaWait(BUS_I2C, _i2c_channel);
+    if (skipDevice(bus, addr)) return I2C_ERROR_BACKOFF;
 
     _i2c_busy = true;
-    Wire.beginTransmission(addr);
-    Wire.write(reg);
-    _i2c_error = Wire.endTransmission(0);
+    HAL_BUS_START(bus_start);
+    selectClock(bus, addr);
+    wire.beginTransmission(addr);
+    wire.write(reg);
+    _i2c_error = wire.endTransmission(0);
 
     if (0 == _i2c_error)
     {
-        Wire.requestFrom(addr, (uint8_t)1);
-        while (!Wire.available()); 
-        *data = Wire.read();
-        Wire.endTransmission();
+        _i2c_error = requestChunk(wire, addr, data, 1);
+        wire.endTransmission();
     }
 
+    finish(bus, addr, _i2c_error);
+    HAL_BUS_RECORD(bus_start, BUS_I2C, _i2c_channel, addr, 1, 1, _i2c_error);
     _i2c_busy = false;
 
     return _i2c_error;
@@ -211,31 +519,28 @@ uint8_t I2C::writeRead(uint8_t addr, uint8_t reg, uint8_t * data)
 
 uint8_t I2C::writeRead(uint8_t addr, uint8_t reg, uint8_t * data, uint32_t len, bool stopbit)
 {
-    uint32_t bytes_read = 0;
-    uint8_t  chunk      = I2C_READ_BUFFER_MAX;
+    Channel& bus = channels[_i2c_channel];
+    TwoWire& wire = i2cHwWire(_i2c_channel);
 
     if (_i2c_busy) return 1;
+    dmaWait(BUS_I2C, _i2c_channel);
+    if (skipDevice(bus, addr)) return I2C_ERROR_BACKOFF;
 
     _i2c_busy = true;
-    Wire.beginTransmission(addr);
-    Wire.write((uint8_t)(reg));
-    _i2c_error = Wire.endTransmission(stopbit);
+    HAL_BUS_START(bus_start);
+    selectClock(bus, addr);
+    wire.beginTransmission(addr);
+    wire.write((uint8_t)(reg));
+    _i2c_error = wire.endTransmission(stopbit);
     
     if (0 == _i2c_error)
     {
-        while (bytes_read < len)
-        {
-            chunk = ((len - bytes_read) < I2C_READ_BUFFER_MAX) ? (len - bytes_read) : I2C_READ_BUFFER_MAX;
-            Wire.requestFrom(addr, (uint8_t)chunk);
-            while ((uint32_t)Wire.available() < chunk); 
-            for (uint32_t iter = bytes_read; iter < (bytes_read + chunk); ++iter)
-                data[iter] = Wire.read();
-            bytes_read += chunk;
-        }
-
-        Wire.endTransmission();
+        _i2c_error = requestChunks(wire, addr, data, len);
+        wire.endTransmission();
     }
 
+    finish(bus, addr, _i2c_error);
+    HAL_BUS_RECORD(bus_start, BUS_I2C, _i2c_channel, addr, 1, len, _i2c_error);
     _i2c_busy = false;
 
     return _i2c_error;
@@ -243,40 +548,191 @@ uint8_t I2C::writeRead(uint8_t addr, uint8_t reg, uint8_t * data, uint32_t len,
 
 uint8_t I2C::writeRead(uint8_t addr, uint16_t reg, uint8_t * data, uint32_t len)
 {
-    uint32_t bytes_read = 0;
-    uint8_t  chunk      = I2C_READ_BUFFER_MAX;
+    Channel& bus = channels[_i2c_channel];
+    TwoWire& wire = i2cHwWire(_i2c_channel);
 
     if (_i2c_busy) return 1;
+    dmaWait(BUS_I2C, _i2c_channel);
+    if (skipDevice(bus, addr)) return I2C_ERROR_BACKOFF;
 
     _i2c_busy = true;
-    Wire.beginTransmission(addr);
-    Wire.write((uint8_t)(reg >> 8));
-    Wire.write((uint8_t)(reg));
-    _i2c_error = Wire.endTransmission(0);
+    HAL_BUS_START(bus_start);
+    selectClock(bus, addr);
+    wire.beginTransmission(addr);
+    wire.write((uint8_t)(reg >> 8));
+    wire.write((uint8_t)(reg));
+    _i2c_error = wire.endTransmission(0);
 
     if (0 == _i2c_error)
     {
-            while (bytes_read < len)
+        _i2c_error = requestChunks(wire, addr, data, len);
+        wire.endTransmission();
+    }
+
+    finish(bus, addr, _i2c_error);
+    HAL_BUS_RECORD(bus_start, BUS_I2C, _i2c_channel, addr, 2, len, _i2c_error);
+    _i2c_busy = false;
+
+    return _i2c_error;
+}
+
+uint8_t I2C::transfer(uint8_t addr, const I2CSegment * wr_segs, uint8_t wr_count,
+                      const I2CSegment * r_segs, uint8_t r_count, bool stopbit)
+{
+    Channel& bus = channels[_i2c_channel];
+    TwoWire& wire = i2cHwWire(_i2c_channel);
+
+    if (_i2c_busy) return 1;
+    dmaWait(BUS_I2C, _i2c_channel);
+    if (skipDevice(bus, addr)) return I2C_ERROR_BACKOFF;
+
+    _i2c_busy  = true;
+    _i2c_error = 0;
+    HAL_BUS_START(bus_start);
+    selectClock(bus, addr);
+
+    // Wire sends nothing until endTransmission(), so a write that overflows its buffer never reaches the bus
+    if ((0 != wr_count) || (0 == r_count))
+    {
+        wire.beginTransmission(addr);
+
+        for (uint8_t iter = 0; (iter < wr_count) && (0 == _i2c_error); ++iter)
         {
-            chunk = ((len - bytes_read) < I2C_READ_BUFFER_MAX) ? (len - bytes_read) : I2C_READ_BUFFER_MAX;
-            Wire.requestFrom(addr, (uint8_t)chunk);
-            while ((uint32_t)Wire.available() < chunk); 
-            for (uint32_t iter = bytes_read; iter < (bytes_read + chunk); ++iter)
-                data[iter] = Wire.read();
-            bytes_read += chunk;
+            if (wire.write(wr_segs[iter].data, wr_segs[iter].len) != wr_segs[iter].len)
+                _i2c_error = I2C_ERROR_LENGTH;
         }
-        
-        Wire.endTransmission();
+
+        if (0 == _i2c_error) _i2c_error = wire.endTransmission((0 == r_count) || stopbit);
     }
 
+    // requestFrom() ends each chunk with a stop, so no address-only write follows
+    if ((0 == _i2c_error) && (0 != r_count))
+        _i2c_error = requestSegments(wire, addr, r_segs, r_count);
+
+    finish(bus, addr, _i2c_error);
+    HAL_BUS_RECORD(bus_start, BUS_I2C, _i2c_channel, addr, segmentsLength(wr_segs, wr_count),
+                   segmentsLength(r_segs, r_count), _i2c_error);
     _i2c_busy = false;
 
     return _i2c_error;
 }
 
+uint8_t I2C::writeAsync(uint8_t addr, const DMASegment * segs, uint8_t count, uint8_t tag)
+{
+    Channel&   bus = channels[_i2c_channel];
+    uint32_t   len = dmaLength(segs, count);
+    DMARequest request;
+    uint8_t    error;
+
+    if (_i2c_busy || dmaActive(BUS_I2C, _i2c_channel)) return DMA_ERROR_BUSY;
+    if ((0 == len) || (len > I2C_DMA_LENGTH_MAX)) return DMA_ERROR_LENGTH;
+    if (skipDevice(bus, addr)) return I2C_ERROR_BACKOFF;
+
+    selectClock(bus, addr);
+    bus.dma_addr = addr;
+
+    request.bus        = BUS_I2C;
+    request.channel    = _i2c_channel;
+    request.addr       = addr;
+    request.tag        = tag;
+    request.segs       = segs;
+    request.count      = count;
+    request.timeout_us = I2C_WAIT_TIMEOUT_US + ((len + 1) * 9 * 1000000) / bus.current_clock_hz;
+    request.done       = writeDone;
+    request.ctx        = &bus;
+    i2cHwWriteRequest(_i2c_channel, request);
+
+    error = dmaSubmit(request);
+    if (error) return error;
+
+    // The address goes out last, once the transfer is ready for the data phase it starts
+    i2cHwWriteStart(_i2c_channel, addr, len);
+
+    return 0;
+}
+
+bool I2C::probe(uint8_t addr)
+{
+    Channel& bus = channels[_i2c_channel];
+    TwoWire& wire = i2cHwWire(_i2c_channel);
+
+    if (_i2c_busy) return false;
+    dmaWait(BUS_I2C, _i2c_channel);
+
+    _i2c_busy = true;
+    HAL_BUS_START(bus_start);
+    selectClock(bus, addr);
+    wire.beginTransmission(addr);
+    _i2c_error = wire.endTransmission();
+
+    // Acknowledge polling expects NACKs while a device is busy; only success and bus faults are accounted
+    if (I2C_ERROR_NACK_ADDR != _i2c_error) finish(bus, addr, _i2c_error);
+
+    HAL_BUS_RECORD(bus_start, BUS_I2C, _i2c_channel, addr, 0, 0, _i2c_error);
+    _i2c_busy = false;
+
+    return (0 == _i2c_error);
+}
+
 bool I2C::busy() const
 {
-    return _i2c_busy;
+    return _i2c_busy || dmaActive(BUS_I2C, _i2c_channel);
+}
+
+bool I2C::setDeviceClock(uint8_t addr, uint32_t max_hz)
+{
+    Channel& bus    = channels[_i2c_channel];
+    Device * device = findDevice(bus, addr, true);
+
+    if (!device) return false;
+
+    device->max_hz = max_hz;
+
+    // Force a fresh lookup on the next transaction
+    bus.last_addr = I2C_NO_ADDRESS;
+
+    return true;
+}
+
+uint32_t I2C::clock() const
+{
+    return channels[_i2c_channel].current_clock_hz;
+}
+
+uint32_t I2C::clockSwitches() const
+{
+    return channels[_i2c_channel].clock_switches;
+}
+
+uint32_t I2C::clockSwitchCycles() const
+{
+    return channels[_i2c_channel].clock_switch_cycles;
+}
+
+uint8_t I2C::recover()
+{
+    Channel& bus = channels[_i2c_channel];
+    uint8_t  error;
+
+    if (_i2c_busy) return 1;
+    dmaWait(BUS_I2C, _i2c_channel);
+
+    _i2c_busy = true;
+    error     = i2cHwClear(_i2c_channel, bus.current_clock_hz);
+    ++bus.recovery_count;
+    _i2c_busy = false;
+
+    return error;
+}
+
+uint32_t I2C::recoveries() const
+{
+    return channels[_i2c_channel].recovery_count;
+}
+
+bool I2C::backingOff(uint8_t addr) const
+{
+    return skipDevice(channels[_i2c_channel], addr);
 }
 
 }
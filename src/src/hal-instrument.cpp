@@ -0,0 +1,45 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-instrument.cpp
+// Purpose     : Hardware Abstraction Layer Bus Instrumentation
+// Description : This source file implements header file hal-instrument.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "hal-instrument.h"
+
+#if defined(HAL_TRACE) || defined(HAL_BUS_STATS)
+
+#include "hal.h"
+#include "hal-trace.h"
+#include "hal-busstats.h"
+
+namespace HAL
+{
+
+uint32_t instrumentStamp()
+{
+    return HAL::micros();
+}
+
+void instrumentRecord(uint32_t start_us, uint8_t bus, uint8_t channel, uint8_t addr, uint16_t wr_len,
+                      uint16_t rd_len, uint8_t error)
+{
+    uint32_t end_us = HAL::micros();
+
+#if defined(HAL_TRACE)
+    traceRecord(start_us, end_us, bus, channel, addr, wr_len, rd_len, error);
+#endif
+
+#if defined(HAL_BUS_STATS)
+    busStatsRecord(start_us, end_us, bus, channel, addr, (uint32_t)wr_len + rd_len, error);
+#endif
+}
+
+}
+
+#endif // HAL_TRACE || HAL_BUS_STATS
+
+// EOF
@@ -0,0 +1,125 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-spi-hw.cpp
+// Purpose     : Hardware Abstraction Layer SPI Backend
+// Description : This source file implements header file hal-spi-hw.h on the SAMD21 SERCOM behind each SPIClass.
+// Language    : C++
+// Platform    : Seeeduino Xiao
+// Framework   : Arduino
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <wiring_private.h>
+#include "hal.h"
+#include "hal-spi-hw.h"
+
+namespace HAL
+{
+
+// DMA writes: bound on the last byte shifting out
+static const uint32_t SPI_DMA_SETTLE_US = 100;
+
+// SERCOM behind the variant's SPI, and its DMAC trigger
+#if !defined(HAL_SPI_SERCOM)
+#define HAL_SPI_SERCOM SERCOM0
+#endif
+#if !defined(HAL_SPI_DMAC_TX)
+#define HAL_SPI_DMAC_TX SERCOM0_DMAC_ID_TX
+#endif
+
+// Second channel on a further SERCOM, given by number, with its pins and pad assignment
+#if defined(HAL_SPI1_SERCOM)
+#if !defined(HAL_SPI1_MOSI) || !defined(HAL_SPI1_SCK) || !defined(HAL_SPI1_MISO)
+#error "HAL_SPI1_SERCOM requires HAL_SPI1_MOSI, HAL_SPI1_SCK and HAL_SPI1_MISO"
+#endif
+#if defined(HAL_I2C1_SERCOM) && (HAL_I2C1_SERCOM == HAL_SPI1_SERCOM)
+#error "HAL_SPI1_SERCOM and HAL_I2C1_SERCOM name the same SERCOM"
+#endif
+#if !defined(HAL_SPI1_TX_PAD)
+#define HAL_SPI1_TX_PAD SPI_PAD_0_SCK_1
+#endif
+#if !defined(HAL_SPI1_RX_PAD)
+#define HAL_SPI1_RX_PAD SERCOM_RX_PAD_3
+#endif
+#if !defined(HAL_SPI1_PIO)
+#define HAL_SPI1_PIO PIO_SERCOM_ALT
+#endif
+#define HAL_SPI_PASTE(a, b)    a ## b
+#define HAL_SPI_SERCOM_N(a, b) HAL_SPI_PASTE(a, b)
+#define HAL_SPI_PASTE3(a, b, c) a ## b ## c
+#define HAL_SPI_DMAC_TX_N(n)    HAL_SPI_PASTE3(SERCOM, n, _DMAC_ID_TX)
+
+static SPIClass SPI1(&HAL_SPI_SERCOM_N(sercom, HAL_SPI1_SERCOM), HAL_SPI1_MISO, HAL_SPI1_SCK, HAL_SPI1_MOSI,
+                     HAL_SPI1_TX_PAD, HAL_SPI1_RX_PAD);
+#endif
+
+// Bus per channel; pins are muxed again after begin() only for channels off the variant's SPI pins
+struct Port
+{
+    SPIClass& spi;
+    Sercom *  sercom;
+    uint8_t   dma_trigger;
+    uint8_t   mosi;
+    uint8_t   sck;
+    EPioType  pio;
+};
+
+static const Port ports[SPI_CHANNELS] = {
+    { ::SPI, HAL_SPI_SERCOM, HAL_SPI_DMAC_TX, 0, 0, PIO_NOT_A_PIN },
+#if defined(HAL_SPI1_SERCOM)
+    { SPI1, HAL_SPI_SERCOM_N(SERCOM, HAL_SPI1_SERCOM), HAL_SPI_DMAC_TX_N(HAL_SPI1_SERCOM), HAL_SPI1_MOSI,
+      HAL_SPI1_SCK, HAL_SPI1_PIO },
+#endif
+};
+
+// End of a DMA write: let the last byte shift out, then drop what was received and the overflow it caused
+static uint8_t writeDone(void * ctx, uint8_t error)
+{
+    Sercom * sercom = ((const Port *)ctx)->sercom;
+    uint32_t start  = HAL::micros();
+
+    while ((0 == error) && !sercom->SPI.INTFLAG.bit.TXC)
+    {
+        if ((HAL::micros() - start) > SPI_DMA_SETTLE_US) error = DMA_ERROR_TIMEOUT;
+    }
+
+    while (sercom->SPI.INTFLAG.bit.RXC)
+        (void) sercom->SPI.DATA.reg;
+
+    sercom->SPI.STATUS.reg = SERCOM_SPI_STATUS_BUFOVF;
+
+    return error;
+}
+
+SPIClass& spiHwPort(uint8_t channel)
+{
+    return ports[channel].spi;
+}
+
+void spiHwBegin(uint8_t channel)
+{
+    const Port& port = ports[channel];
+
+    port.spi.begin();
+
+    if (PIO_NOT_A_PIN != port.pio)
+    {
+        pinPeripheral(port.mosi, port.pio);
+        pinPeripheral(port.sck, port.pio);
+    }
+}
+
+void spiHwWriteRequest(uint8_t channel, DMARequest& request)
+{
+    const Port& port = ports[channel];
+
+    request.trigger = port.dma_trigger;
+    request.dest    = &port.sercom->SPI.DATA.reg;
+    request.done    = writeDone;
+    request.ctx     = (void *)&port;
+}
+
+}
+
+// EOF
@@ -1,34 +1,66 @@
 //--------------------------------------------------------------------------------------------------------------------
 // Name        : hal-spi.cpp
 // Purpose     : Hardware Abstraction Layer SPI
-// Description : This source file implements header file hal-spi.h.
+// Description : This source file implements header file hal-spi.h on SPIClass and the backend interface of
+//               hal-spi-hw.h, and is compiled by both the target and the native build.
 // Language    : C++
-// Platform    : Seeeduino Xiao
+// Platform    : Portable
 // Framework   : Arduino
 // Copyright   : MIT License 2024, John Greenwell
 //--------------------------------------------------------------------------------------------------------------------
 
 #include <Arduino.h>
 #include <SPI.h>
+#include "hal.h"
 #include "hal-spi.h"
+#include "hal-spi-hw.h"
+#include "hal-instrument.h"
 
 namespace HAL
 {
 
+// DMA writes: bound on a whole job at 1 MHz or faster
+static const uint32_t SPI_DMA_TIMEOUT_US = 10000;
+
 SPI::SPI(uint8_t spi_channel)
-: _spi_channel(spi_channel)
+: _spi_channel((spi_channel < SPI_CHANNELS) ? spi_channel : 0)
 { }
 
 void SPI::init(uint32_t baudrate) const
 {
     (void) baudrate; // Init baudrate not supported in this HAL
 
-    ::SPI.begin();
+    spiHwBegin(_spi_channel);
 }
 
 uint8_t SPI::transfer(uint8_t val) const
 {
-    return ::SPI.transfer(val);
+    dmaWait(BUS_SPI, _spi_channel);
+
+    HAL_BUS_START(bus_start);
+    uint8_t retval = spiHwPort(_spi_channel).transfer(val);
+    HAL_BUS_RECORD(bus_start, BUS_SPI, _spi_channel, 0, 1, 1, 0);
+
+    return retval;
+}
+
+uint8_t SPI::writeAsync(const DMASegment * segs, uint8_t count, uint8_t tag) const
+{
+    uint32_t   len = dmaLength(segs, count);
+    DMARequest request;
+
+    if (0 == len) return DMA_ERROR_LENGTH;
+
+    request.bus        = BUS_SPI;
+    request.channel    = _spi_channel;
+    request.addr       = 0;
+    request.tag        = tag;
+    request.segs       = segs;
+    request.count      = count;
+    request.timeout_us = SPI_DMA_TIMEOUT_US + (len * 8);
+    spiHwWriteRequest(_spi_channel, request);
+
+    return dmaSubmit(request);
 }
 
 }
@@ -1,9 +1,10 @@
 //--------------------------------------------------------------------------------------------------------------------
 // Name        : hal-timer.cpp
 // Purpose     : Hardware Abstraction Layer Timer
-// Description : This source file implements header file hal-timer.h.
+// Description : This source file implements header file hal-timer.h, and is compiled by both the target and
+//               the native build.
 // Language    : C++
-// Platform    : Seeeduino Xiao
+// Platform    : Portable
 // Framework   : Arduino
 // Copyright   : MIT License 2024, John Greenwell
 //--------------------------------------------------------------------------------------------------------------------
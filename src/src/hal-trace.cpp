@@ -0,0 +1,91 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-trace.cpp
+// Purpose     : Hardware Abstraction Layer Bus Trace
+// Description : This source file implements header file hal-trace.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "hal-trace.h"
+
+#if defined(HAL_TRACE)
+
+#include "hal.h"
+
+namespace HAL
+{
+
+static_assert((HAL_TRACE_DEPTH & (HAL_TRACE_DEPTH - 1)) == 0, "HAL_TRACE_DEPTH must be a power of two");
+
+static const char * const TRACE_BUS_NAMES[] = { "i2c", "spi", "uart" };
+
+static TraceRecord   trace_ring[HAL_TRACE_DEPTH];
+static uint32_t      trace_total  = 0;
+static volatile bool trace_paused = false;
+
+void traceRecord(uint32_t start_us, uint32_t end_us, uint8_t bus, uint8_t channel, uint8_t addr, uint16_t wr_len,
+                 uint16_t rd_len, uint8_t error)
+{
+    if (trace_paused) return;
+
+    CriticalSection lock;
+    TraceRecord&    record = trace_ring[trace_total & (HAL_TRACE_DEPTH - 1)];
+
+    record.start_us = start_us;
+    record.end_us   = end_us;
+    record.wr_len   = wr_len;
+    record.rd_len   = rd_len;
+    record.bus      = bus;
+    record.channel  = channel;
+    record.addr     = addr;
+    record.error    = error;
+    ++trace_total;
+}
+
+void traceDump(const UART& serial)
+{
+    uint32_t total;
+    uint32_t count;
+
+    // Printing is itself traced; suspend recording so the ring is stable while it is read
+    trace_paused = true;
+
+    {
+        CriticalSection lock;
+        total = trace_total;
+    }
+
+    count = (total < HAL_TRACE_DEPTH) ? total : HAL_TRACE_DEPTH;
+
+    serial.printf("TRACE_BEGIN,%lu,%lu\r\n", (unsigned long)count, (unsigned long)(total - count));
+
+    for (uint32_t iter = total - count; iter < total; ++iter)
+    {
+        const TraceRecord& record = trace_ring[iter & (HAL_TRACE_DEPTH - 1)];
+        const char *       name   = (record.bus <= BUS_UART) ? TRACE_BUS_NAMES[record.bus] : "?";
+
+        serial.printf("TRACE,%s,%u,0x%02X,%lu,%lu,%u,%u,%u\r\n", name, (unsigned)record.channel, (unsigned)record.addr, (unsigned long)record.start_us,
+                      (unsigned long)record.end_us, (unsigned)record.wr_len, (unsigned)record.rd_len,
+                      (unsigned)record.error);
+    }
+
+    serial.printf("TRACE_END\r\n");
+
+    traceClear();
+    trace_paused = false;
+}
+
+void traceClear()
+{
+    CriticalSection lock;
+
+    trace_total = 0;
+}
+
+}
+
+#endif // HAL_TRACE
+
+// EOF
@@ -0,0 +1,85 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-uart-hw.cpp
+// Purpose     : Hardware Abstraction Layer UART Backend
+// Description : This source file implements header file hal-uart-hw.h on the framework's Serial ports and the
+//               SAMD21 SERCOM behind a hardware UART.
+// Language    : C++
+// Platform    : Seeeduino Xiao
+// Framework   : Arduino
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "hal-uart-hw.h"
+
+namespace HAL
+{
+
+// Port per channel: channel 0 is USB CDC; channel 1 is the hardware UART named by HAL_UART1_PORT (e.g. Serial1),
+// served by DMA when its SERCOM is given
+struct Port
+{
+    Stream& port;
+    void  (*begin)(uint32_t baud);
+    Sercom * sercom;
+    uint8_t  dma_trigger;
+};
+
+static void beginSerial0(uint32_t baud)
+{
+    Serial.begin(baud);
+}
+
+#if defined(HAL_UART1_PORT)
+#if defined(HAL_UART1_SERCOM) && ((defined(HAL_I2C1_SERCOM) && (HAL_I2C1_SERCOM == HAL_UART1_SERCOM)) || \
+                                  (defined(HAL_SPI1_SERCOM) && (HAL_SPI1_SERCOM == HAL_UART1_SERCOM)))
+#error "HAL_UART1_SERCOM is also claimed by HAL_I2C1_SERCOM or HAL_SPI1_SERCOM"
+#endif
+#define HAL_UART_PASTE(a, b)     a ## b
+#define HAL_UART_SERCOM_N(a, b)  HAL_UART_PASTE(a, b)
+#define HAL_UART_PASTE3(a, b, c) a ## b ## c
+#define HAL_UART_DMAC_TX_N(n)    HAL_UART_PASTE3(SERCOM, n, _DMAC_ID_TX)
+
+static void beginSerial1(uint32_t baud)
+{
+    HAL_UART1_PORT.begin(baud);
+}
+#endif
+
+static const Port ports[UART_CHANNELS] = {
+    { Serial, beginSerial0, nullptr, 0 },
+#if defined(HAL_UART1_PORT) && defined(HAL_UART1_SERCOM)
+    { HAL_UART1_PORT, beginSerial1, HAL_UART_SERCOM_N(SERCOM, HAL_UART1_SERCOM),
+      HAL_UART_DMAC_TX_N(HAL_UART1_SERCOM) },
+#elif defined(HAL_UART1_PORT)
+    { HAL_UART1_PORT, beginSerial1, nullptr, 0 },
+#endif
+};
+
+Stream& uartHwPort(uint8_t channel)
+{
+    return ports[channel].port;
+}
+
+void uartHwBegin(uint8_t channel, uint32_t baud)
+{
+    ports[channel].begin(baud);
+}
+
+bool uartHwWriteRequest(uint8_t channel, DMARequest& request)
+{
+    const Port& port = ports[channel];
+
+    if (!port.sercom) return false;
+
+    request.trigger = port.dma_trigger;
+    request.dest    = &port.sercom->USART.DATA.reg;
+    request.done    = nullptr;
+    request.ctx     = nullptr;
+
+    return true;
+}
+
+}
+
+// EOF
@@ -1,15 +1,18 @@
 //--------------------------------------------------------------------------------------------------------------------
 // Name        : hal-uart.cpp
 // Purpose     : Hardware Abstraction Layer UART
-// Description : This source file implements header file hal-uart.h.
+// Description : This source file implements header file hal-uart.h on Stream and the backend interface of
+//               hal-uart-hw.h, and is compiled by both the target and the native build.
 // Language    : C++
-// Platform    : Seeeduino Xiao
+// Platform    : Portable
 // Framework   : Arduino
 // Copyright   : MIT License 2024, John Greenwell
 //--------------------------------------------------------------------------------------------------------------------
 
 #include <Arduino.h>
 #include "hal-uart.h"
+#include "hal-uart-hw.h"
+#include "hal-instrument.h"
 
 namespace HAL
 {
@@ -17,76 +20,135 @@ namespace HAL
 // Used when wrapping printf()
 static char tmp_str[255];
 
+// DMA writes: a job is ended after twice its time at the line rate plus this margin
+static const uint32_t UART_DMA_TIMEOUT_US = 10000;
+
+// Line rate per channel, which bounds the duration of a DMA write
+static uint32_t channel_baud[UART_CHANNELS];
+
 UART::UART(uint8_t serial_channel)
-: _serial_channel(serial_channel)
+: _serial_channel((serial_channel < UART_CHANNELS) ? serial_channel : 0)
 { }
 
 void UART::init(uint32_t baud) const
 {
-    Serial.begin(baud);
+    uartHwBegin(_serial_channel, baud);
+    channel_baud[_serial_channel] = baud;
 }
 
 uint8_t UART::read() const
 {
-    return (uint8_t)Serial.read();
+    HAL_BUS_START(bus_start);
+    uint8_t retval = (uint8_t)uartHwPort(_serial_channel).read();
+    HAL_BUS_RECORD(bus_start, BUS_UART, _serial_channel, 0, 0, 1, 0);
+
+    return retval;
 }
 
 uint32_t UART::readBytes(char *buffer, uint32_t length) const
 {
-    return Serial.readBytes(buffer, length);
+    HAL_BUS_START(bus_start);
+    uint32_t retval = uartHwPort(_serial_channel).readBytes(buffer, length);
+    HAL_BUS_RECORD(bus_start, BUS_UART, _serial_channel, 0, 0, retval, 0);
+
+    return retval;
 }
 
 uint32_t UART::write(const char *str, uint32_t length) const
 {
+    Stream&  port   = uartHwPort(_serial_channel);
     uint32_t retval = 0;
 
+    dmaWait(BUS_UART, _serial_channel);
+
+    HAL_BUS_START(bus_start);
+
     for (retval = 0; retval < length; ++retval)
     {
-        Serial.write(str[retval]);
+        port.write(str[retval]);
     }
 
+    HAL_BUS_RECORD(bus_start, BUS_UART, _serial_channel, 0, retval, 0, 0);
+
     return retval;
 }
 
 uint32_t UART::write(char *str, uint32_t length) const
 {
-    uint32_t retval = 0;
-
-    for (retval = 0; retval < length; ++retval)
-    {
-        Serial.write(str[retval]);
-    }
-
-    return retval;
+    return write((const char *)str, length);
 }
 
 uint32_t UART::print(const char *str) const
 {
-    return Serial.print(str);
+    dmaWait(BUS_UART, _serial_channel);
+
+    HAL_BUS_START(bus_start);
+    uint32_t retval = uartHwPort(_serial_channel).print(str);
+    HAL_BUS_RECORD(bus_start, BUS_UART, _serial_channel, 0, retval, 0, 0);
+
+    return retval;
 }
 
 uint32_t UART::print(char *str) const
 {
-    return Serial.print(str);
+    return print((const char *)str);
 }
 
 uint32_t UART::printf(const char *str, ...) const
 {
-    va_list args;
+    uint32_t retval;
+    va_list  args;
+
+    dmaWait(BUS_UART, _serial_channel);
+
+    HAL_BUS_START(bus_start);
     va_start(args, str);
-    vsprintf(tmp_str, str, args);
-    return Serial.print(tmp_str);
+    vsnprintf(tmp_str, sizeof(tmp_str), str, args);
     va_end(args);
+    retval = uartHwPort(_serial_channel).print(tmp_str);
+    HAL_BUS_RECORD(bus_start, BUS_UART, _serial_channel, 0, retval, 0, 0);
+
+    return retval;
 }
 
 uint32_t UART::println(const char *str) const
 {
-    return Serial.println(str);
+    dmaWait(BUS_UART, _serial_channel);
+
+    HAL_BUS_START(bus_start);
+    uint32_t retval = uartHwPort(_serial_channel).println(str);
+    HAL_BUS_RECORD(bus_start, BUS_UART, _serial_channel, 0, retval, 0, 0);
+
+    return retval;
 }
 
 bool UART::available() const
 {
-    return Serial.available();
+    return uartHwPort(_serial_channel).available();
+}
+
+uint8_t UART::writeAsync(const DMASegment * segs, uint8_t count, uint8_t tag) const
+{
+    uint32_t   len  = dmaLength(segs, count);
+    uint32_t   baud = channel_baud[_serial_channel] ? channel_baud[_serial_channel] : 9600;
+    DMARequest request;
+
+    if (!uartHwWriteRequest(_serial_channel, request)) return DMA_ERROR_UNSUPPORTED;
+    if (0 == len) return DMA_ERROR_LENGTH;
+    if (dmaActive(BUS_UART, _serial_channel)) return DMA_ERROR_BUSY;
+
+    // Bytes the blocking writes left in the port's ring buffer go out first
+    uartHwPort(_serial_channel).flush();
+
+    request.bus        = BUS_UART;
+    request.channel    = _serial_channel;
+    request.addr       = 0;
+    request.tag        = tag;
+    request.segs       = segs;
+    request.count      = count;
+    request.timeout_us = UART_DMA_TIMEOUT_US + (uint32_t)(((uint64_t)len * 20 * 1000000) / baud);
+
+    return dmaSubmit(request);
 }
 
 }
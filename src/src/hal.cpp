@@ -43,6 +43,48 @@ uint32_t micros()
     return ::micros();
 }
 
+uint32_t cycles()
+{
+    uint32_t ticks, ticks2;
+    uint32_t pend, pend2;
+    uint32_t count, count2;
+
+    // The Cortex-M0+ has no cycle counter; combine the millisecond tick with the SysTick down counter,
+    // re-reading until no reload occurred between the reads (as the core's micros() does)
+    ticks2 = SysTick->VAL;
+    pend2  = !!(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk);
+    count2 = ::millis();
+
+    do
+    {
+        ticks  = ticks2;
+        pend   = pend2;
+        count  = count2;
+        ticks2 = SysTick->VAL;
+        pend2  = !!(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk);
+        count2 = ::millis();
+    } while ((pend != pend2) || (count != count2) || (ticks < ticks2));
+
+    return ((count + pend) * (SysTick->LOAD + 1)) + (SysTick->LOAD - ticks);
+}
+
+uint32_t cpuFrequency()
+{
+    return SystemCoreClock;
+}
+
+uint32_t disableInterrupts()
+{
+    uint32_t state = __get_PRIMASK();
+    __disable_irq();
+    return state;
+}
+
+void restoreInterrupts(uint32_t state)
+{
+    __set_PRIMASK(state);
+}
+
 }
 
 // EOF
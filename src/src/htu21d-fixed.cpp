@@ -0,0 +1,169 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : htu21d-fixed.cpp
+// Purpose     : HTU21D Fixed-Point Measurement
+// Description : This source file implements header file htu21d-fixed.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "htu21d-fixed.h"
+
+namespace Demo
+{
+
+// Sensor commands; hold master mode (0xE3, 0xE5) stretches SCL beyond the HAL's SCL low timeout and is not used
+static const uint8_t HTU21D_TEMP_NOHOLD  = 0xF3;
+static const uint8_t HTU21D_HUMID_NOHOLD = 0xF5;
+
+// Maximum conversion times at default resolution (14-bit temperature, 12-bit humidity)
+static const uint32_t HTU21D_TEMP_CONV_MS  = 50;
+static const uint32_t HTU21D_HUMID_CONV_MS = 16;
+
+// Status bits occupy the two least significant bits of each reading
+static const uint16_t HTU21D_STATUS_MASK = 0xFFFC;
+
+// CRC-8 polynomial x^8 + x^5 + x^4 + 1
+static const uint8_t HTU21D_CRC_POLY = 0x31;
+
+HTU21DFixed::HTU21DFixed(HAL::I2C& i2c_bus, uint8_t address)
+: _i2c_bus(i2c_bus)
+, _address(address)
+, _temperature(0)
+, _humidity(0)
+, _state(STATE_IDLE)
+, _trigger_ms(0)
+{ }
+
+uint8_t HTU21DFixed::measure()
+{
+    uint16_t raw   = 0;
+    uint8_t  error = readRaw(HTU21D_TEMP_NOHOLD, HTU21D_TEMP_CONV_MS, &raw);
+
+    if (0 != error) return error;
+    _temperature = convertTemperature(raw);
+
+    error = readRaw(HTU21D_HUMID_NOHOLD, HTU21D_HUMID_CONV_MS, &raw);
+
+    if (0 != error) return error;
+    _humidity = convertHumidity(raw);
+
+    return 0;
+}
+
+bool HTU21DFixed::service()
+{
+    uint8_t  data[3];
+    uint32_t elapsed = HAL::millis() - _trigger_ms;
+    uint32_t conv_ms = (STATE_TEMP == _state) ? HTU21D_TEMP_CONV_MS : HTU21D_HUMID_CONV_MS;
+    bool     updated = false;
+
+    if (STATE_IDLE == _state)
+    {
+        trigger(STATE_TEMP);
+        return false;
+    }
+
+    if (elapsed < conv_ms) return false;
+
+    // Sensor NACKs its address until the conversion completes; try again on the next call,
+    // re-triggering if the conversion appears to have been lost
+    if (0 != _i2c_bus.read(_address, data, 3))
+    {
+        if (elapsed > (4 * conv_ms)) trigger(_state);
+        return false;
+    }
+
+    if (checkCRC(data))
+    {
+        uint16_t raw = ((uint16_t)data[0] << 8) | data[1];
+
+        if (STATE_TEMP == _state)
+            _temperature = convertTemperature(raw);
+        else
+            _humidity = convertHumidity(raw);
+
+        updated = true;
+    }
+
+    trigger((STATE_TEMP == _state) ? STATE_HUMID : STATE_TEMP);
+
+    return updated;
+}
+
+int16_t HTU21DFixed::getTemperature() const
+{
+    return _temperature;
+}
+
+int16_t HTU21DFixed::getHumidity() const
+{
+    return _humidity;
+}
+
+int16_t HTU21DFixed::convertTemperature(uint16_t raw)
+{
+    // 17572 * 65535 fits in 31 bits, so no 64-bit intermediate is needed
+    return (int16_t)(-4685 + (int32_t)((17572UL * (raw & HTU21D_STATUS_MASK)) >> 16));
+}
+
+int16_t HTU21DFixed::convertHumidity(uint16_t raw)
+{
+    int32_t humidity = -600 + (int32_t)((12500UL * (raw & HTU21D_STATUS_MASK)) >> 16);
+
+    if (humidity < 0) humidity = 0;
+    if (humidity > 10000) humidity = 10000;
+
+    return (int16_t)humidity;
+}
+
+bool HTU21DFixed::checkCRC(const uint8_t * data)
+{
+    uint8_t crc = 0;
+
+    for (uint8_t iter = 0; iter < 2; ++iter)
+    {
+        crc ^= data[iter];
+        for (uint8_t bit = 0; bit < 8; ++bit)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ HTU21D_CRC_POLY) : (uint8_t)(crc << 1);
+    }
+
+    return (crc == data[2]);
+}
+
+uint8_t HTU21DFixed::trigger(State state)
+{
+    uint8_t error = _i2c_bus.write(_address, (STATE_TEMP == state) ? HTU21D_TEMP_NOHOLD : HTU21D_HUMID_NOHOLD);
+
+    // Retry trigger on the next call if the bus was unavailable
+    _state      = (0 == error) ? state : STATE_IDLE;
+    _trigger_ms = HAL::millis();
+
+    return error;
+}
+
+// Trigger, wait out the conversion with the bus released, then collect the result
+uint8_t HTU21DFixed::readRaw(uint8_t command, uint32_t conv_ms, uint16_t * raw)
+{
+    uint8_t data[3];
+    uint8_t error = _i2c_bus.write(_address, command);
+
+    if (0 != error) return error;
+
+    HAL::delay_ms(conv_ms);
+
+    error = _i2c_bus.read(_address, data, 3);
+
+    if (0 != error) return error;
+    if (!checkCRC(data)) return 0xFF;
+
+    *raw = ((uint16_t)data[0] << 8) | data[1];
+
+    return 0;
+}
+
+}
+
+// EOF
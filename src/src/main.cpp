@@ -9,16 +9,26 @@
 //--------------------------------------------------------------------------------------------------------------------
 
 #include "hal.h"
+#include "hal-trace.h"
+#include "hal-busstats.h"
 #include "led.h"
-#include "switch.h"
 #include "shift-register.h"
 #include "mcp23008.h"
 #include "mcp23s08.h"
-#include "micro7seg.h"
-#include "at24cxx.h"
 #include "ds3232.h"
-#include "htu21d.h"
 #include "ssd1306.h"
+#include "oled-io.h"
+#include "oled-compositor.h"
+#include "oled-ticker.h"
+#include "fixed-format.h"
+#include "htu21d-fixed.h"
+#include "time-cache.h"
+#include "rtc-tick.h"
+#include "build-time.h"
+#include "eeprom-cache.h"
+#include "eeprom-log.h"
+#include "seg-frames.h"
+#include "button-events.h"
 
 // Baud and timer settings
 const uint32_t SERIAL_BAUDRATE = 1000000;
@@ -26,7 +36,37 @@ const uint32_t I2C_BAUDRATE    = 100000;
 const uint32_t SPI_BAUDRATE    = 1000000;
 const uint32_t TIMER_PERIOD_US = 2500;
 
+// Per-device maximum I2C clocks; I2C_BAUDRATE applies to any other device. Fast-mode Plus needs pull-ups sized
+// for its rise time.
+const uint32_t OLED_I2C_CLOCK     = 400000;  // SSD1306
+const uint32_t EEPROM_I2C_CLOCK   = 1000000; // AT24C256 at 2.5 V and above
+const uint32_t RTC_I2C_CLOCK      = 400000;  // DS3232
+const uint32_t SENSOR_I2C_CLOCK   = 400000;  // HTU21D
+const uint32_t EXPANDER_I2C_CLOCK = 400000;  // MCP23008 digit selects
+const uint8_t  SENSOR_ADDRESS     = 0x40;
+const uint8_t  EXPANDER_ADDRESS   = 0x20;
+
+// Push button on D7 (A7), active low against the internal pull-up. D7 is also SERCOM4 pad 1, which the second
+// I2C, SPI or UART channel options in platformio.ini claim; the button must then be moved with -D BUTTON_PIN=<pin>
+#if !defined(BUTTON_PIN)
+#if (defined(HAL_I2C1_SERCOM) && ((7 == HAL_I2C1_SDA) || (7 == HAL_I2C1_SCL))) ||                         \
+    (defined(HAL_SPI1_SERCOM) && ((7 == HAL_SPI1_MOSI) || (7 == HAL_SPI1_SCK) || (7 == HAL_SPI1_MISO))) || \
+    defined(HAL_UART1_PORT)
+#error "D7 is taken by a SERCOM4 channel; define BUTTON_PIN to move the button"
+#endif
+#define BUTTON_PIN PIN_A7
+#endif
+
+// RTC square wave input and resynchronization interval
+const uint8_t  RTC_SQW_PIN      = PIN_A0;
+const uint32_t RTC_RESYNC_S     = 3600;
+
 // OLED settings
+#if defined(HAL_I2C1_SERCOM)
+const bool     OLED_SHARES_BUS     = false; // OLED on I2C channel 1, clear of the expander traffic in the timer ISR
+#else
+const bool     OLED_SHARES_BUS     = true;
+#endif
 const uint8_t  OLED_SCREEN_WIDTH   = 128;  // OLED width in pixels
 const uint8_t  OLED_SCREEN_HEIGHT  = 64;   // OLED height in pixels
 const uint8_t  OLED_SCREEN_ADDRESS = 0x3C; // OLED address; see datasheet
@@ -34,40 +74,66 @@ const uint8_t  OLED_SCREEN_ADDRESS = 0x3C; // OLED address; see datasheet
 // SPI GPIO expander address
 const uint8_t  MCP23X08_ADDRESS = 0x20;
 
-// Dummy pin numbers for 7-seg display; actual arrangement handled in the HAL
-const uint8_t DISPLAY_PINS_CHAR[8] = {0, 1, 2, 3, 4, 5, 6, 7};
-const uint8_t DISPLAY_PINS_SEL[4]  = {8, 9, 10, 11};
+// EEPROM settings; the first 256 bytes hold configuration data, the remainder the sensor log
+const uint8_t  EEPROM_ADDRESS         = 0x50;
+const uint8_t  EEPROM_WP_PIN          = PIN_A6;
+const uint16_t EEPROM_LOG_FIRST_PAGE  = 4;
+const uint16_t EEPROM_LOG_PAGE_COUNT  = 508;
 
-// Month name strings
-const char *monthName[12] =
-{
-  "Jan", "Feb", "Mar", "Apr", "May", "Jun",
-  "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
-};
+// Dummy pin numbers for 7-seg display (8 segments then 4 digit selects); actual arrangement handled in the HAL
+const uint8_t DISPLAY_PINS[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+
+// Build timestamp, parsed at compile time
+constexpr time_t       BUILD_TIME     = Demo::BuildTime::timestamp(__DATE__, __TIME__);
+constexpr tmElements_t BUILD_ELEMENTS = Demo::BuildTime::elements(__DATE__, __TIME__);
 
 // Global variables
 char         data[256];
-tmElements_t tm;
+char         text[Demo::OLEDCompositor::MAX_FIELD_CHARS + 1];
 time_t       current_time;
 time_t       previous_time;
 
+// Sensor history; one sample per second, displayed as an 8 second moving average
+HAL::SampleRing<int16_t, 8> temperature_samples;
+HAL::SampleRing<int16_t, 8> humidity_samples;
+
+// Calendar fields of current_time, advanced once per second
+Demo::TimeCache clock_fields;
+
 // HAL-mediated utility
 HAL::Timer timer;
 
-// Peripheral buses
-HAL::I2C  i2c_bus(0);
-HAL::SPI  spi_bus(0);
-HAL::UART serial_bus(0);
+// Peripheral buses, shared with the HAL's own drivers through the registry. The OLED has a channel of its own when
+// the build maps a second one (HAL_I2C1_SERCOM), and the instrumentation dumps go to the hardware UART when the build
+// maps one (HAL_UART1_PORT), apart from USB CDC; otherwise both resolve to channel 0
+HAL::I2C&  i2c_bus       = HAL::i2cBus(0);
+HAL::SPI&  spi_bus       = HAL::spiBus(0);
+HAL::UART& serial_bus    = HAL::uartBus(0);
+HAL::I2C&  oled_bus      = HAL::i2cBus(1);
+HAL::UART& telemetry_bus = HAL::uartBus(1);
 
 // Peripheral objects
 PeripheralIO::LED       led(PIN_A1);
-PeripheralIO::Switch    button(PIN_A7);
+Demo::ButtonEvents      button(BUTTON_PIN);
 PeripheralIO::MCP23S08  spi_io(spi_bus, PIN_A3, MCP23X08_ADDRESS);
-PeripheralIO::Micro7Seg segments(DISPLAY_PINS_CHAR, DISPLAY_PINS_SEL);
-PeripheralIO::AT24CXX   eeprom(i2c_bus, PeripheralIO::AT24C256, 0, PIN_A6);
+HAL::GPIOPort           display_port(DISPLAY_PINS, sizeof(DISPLAY_PINS));
+Demo::SegmentFrames     segments(display_port);
 PeripheralIO::DS3232RTC rtc(i2c_bus, PeripheralIO::DS3232RTC::DS32_ADDR);
-PeripheralIO::HTU21D    sensor(i2c_bus);
-PeripheralIO::SSD1306   display(i2c_bus, OLED_SCREEN_WIDTH, OLED_SCREEN_HEIGHT);
+Demo::RTCTick           rtc_tick(i2c_bus, RTC_SQW_PIN, PeripheralIO::DS3232RTC::DS32_ADDR);
+Demo::HTU21DFixed       sensor(i2c_bus);
+Demo::EEPROMWriteCache  eeprom_cache(i2c_bus, EEPROM_ADDRESS, EEPROM_WP_PIN);
+Demo::EEPROMLog         sensor_log(eeprom_cache, EEPROM_LOG_FIRST_PAGE, EEPROM_LOG_PAGE_COUNT);
+PeripheralIO::SSD1306   display(oled_bus, OLED_SCREEN_WIDTH, OLED_SCREEN_HEIGHT);
+
+// OLED fields; only fields whose value changed are redrawn and pushed to the panel
+Demo::OLEDIO         oled(oled_bus, OLED_SCREEN_ADDRESS, OLED_SCREEN_WIDTH);
+Demo::OLEDCompositor screen(display, oled);
+Demo::OLEDTicker     ticker(display, oled);
+uint8_t              field_date;
+uint8_t              field_time;
+uint8_t              field_temp;
+uint8_t              field_humid;
+uint8_t              field_button;
 
 // C library initialization
 extern "C" void __libc_init_array(void);
@@ -80,14 +146,11 @@ void initVariant() {}
 // Function prototypes
 void initFramework();
 void yieldToTasks();
-bool extractTime(const char *str);
-bool extractDate(const char *str);
-void printInteger(int val, char delim);
-void printDate(time_t t);
-void printTime(time_t t);
-time_t getTime();
+void formatDate(char *str, const tmElements_t &t);
+void formatTime(char *str, const tmElements_t &t);
+void formatMeasurement(char *str, const char *prefix, int16_t val, const char *suffix);
 void timerISR();
-void getTimeFromCompiler();
+time_t setTimeFromCompiler();
 
 int main()
 {
@@ -95,28 +158,35 @@ int main()
 
     // Bus initialization
     serial_bus.init(SERIAL_BAUDRATE);
+#if defined(HAL_UART1_PORT)
+    telemetry_bus.init(SERIAL_BAUDRATE);
+#endif
     i2c_bus.init(I2C_BAUDRATE);
+#if defined(HAL_I2C1_SERCOM)
+    oled_bus.init(I2C_BAUDRATE);
+#endif
     spi_bus.init(SPI_BAUDRATE);
 
+    // Bus clock follows the addressed device, switching only when it changes
+    oled_bus.setDeviceClock(OLED_SCREEN_ADDRESS, OLED_I2C_CLOCK);
+    i2c_bus.setDeviceClock(EEPROM_ADDRESS, EEPROM_I2C_CLOCK);
+    i2c_bus.setDeviceClock(PeripheralIO::DS3232RTC::DS32_ADDR, RTC_I2C_CLOCK);
+    i2c_bus.setDeviceClock(SENSOR_ADDRESS, SENSOR_I2C_CLOCK);
+    i2c_bus.setDeviceClock(EXPANDER_ADDRESS, EXPANDER_I2C_CLOCK);
+
     HAL::delay_ms(10);
 
     // Peripheral initialization
     button.init();
     spi_io.init();
     spi_io.portMode(GPIO_OUTPUT);
-    eeprom.init();
-    eeprom.setWriteProtect();
+    eeprom_cache.init(); // Sole owner of the EEPROM and its write protect pin
     segments.init();
     rtc.begin();
-    setSyncProvider(getTime);
 
-    // Apply time and date from compiler
-    getTimeFromCompiler();
-
-    HAL::delay_ms(10);
-
-    // Set RTC synchronization
-    setSyncProvider(getTime);
+    // Local seconds counter driven by RTC square wave; RTC is read only at boot and resync
+    if (0 != rtc_tick.begin(setTimeFromCompiler()))
+        Serial.println(F("RTC square wave unavailable; counting seconds from millis()"));
 
     // OLED display initialization
     if(!display.begin(SSD1306_SWITCHCAPVCC, OLED_SCREEN_ADDRESS))
@@ -125,19 +195,33 @@ int main()
         for(;;);
     }
 
-    display.clearDisplay();
     display.setTextSize(1);              // Normal 1:1 pixel scale
     display.setTextColor(SSD1306_WHITE); // Draw white text
-    display.setCursor(0, 0);             // Start at top-left corner
     display.cp437(true);                 // Use full 256 char 'Code Page 437' font
 
-    display.print("Hello world!");
-    display.display();
+    // Boot log streamed through the hardware start line ticker
+    ticker.begin();
+    ticker.println("Hello world!");
+    ticker.println("RTC synchronized.");
 
     HAL::delay_ms(10);
 
     // Read EEPROM contents into memory
-    eeprom.read(0, data, 255);
+    eeprom_cache.read(0, (uint8_t *)data, 255);
+    sensor_log.mount();
+    ticker.println("EEPROM loaded.");
+    ticker.end();
+
+    display.clearDisplay();
+    display.setCursor(0, 0);             // Start at top-left corner
+    display.print("Hello world!");
+    display.display();
+
+    field_date   = screen.addField("date",   0,  8, 11);
+    field_time   = screen.addField("time",   72, 8, 8);
+    field_temp   = screen.addField("temp",   0,  16, 10);
+    field_humid  = screen.addField("humid",  66, 16, 9);
+    field_button = screen.addField("button", 0,  24, 17);
 
     // Timer initialization
     timer.init(TIMER_PERIOD_US);
@@ -149,69 +233,84 @@ int main()
     {
         static uint16_t val = 0;
 
-        // Suspend timer when reading RTC due to shared bus
-        timer.stop();
         previous_time = current_time;
-        current_time  = now();
-        timer.start();
+        current_time  = rtc_tick.now();
 
-        // Update measurements each second
-        // Suspend timer during sensor read due to shared bus
-        if (current_time != previous_time)
+        // Resync just after a second boundary, well clear of the next square wave edge
+        // Suspend timer when reading RTC due to shared bus
+        if ((current_time != previous_time) && (!rtc_tick.aligned() || (rtc_tick.sinceSync() >= RTC_RESYNC_S)))
         {
             timer.stop();
-            sensor.measure();
+            rtc_tick.sync(rtc.get());
             timer.start();
-            delay(20);
-        }
-        else
-        {
-            delay(80);
+            current_time = rtc_tick.now();
         }
 
+        // Collect completed conversions and trigger the next; the bus is free while the sensor converts
+        // Suspend timer during sensor access due to shared bus
+        timer.stop();
+        sensor.service();
+        timer.start();
+        delay(80);
+
         led.on();
 
+        button.service();
+
         // Display loop count on 7-seg display and LED array
         spi_io.write((uint8_t)val);
         segments.write(val);
 
         if (current_time != previous_time)
         {
-            display.fillRect(0, 8, 128, 24, SSD1306_BLACK);
-
             // Display current time on OLED
-            display.setCursor(0, 8);
-            printDate(current_time);
-            display.print(' ');
-            printTime(current_time);
-
-            // Display sensor values on OLED
-            display.setCursor(0, 16);
-            display.printf("T: %05.2f'C H: %05.2f%%", sensor.getTemperature(), sensor.getHumidity());
+            clock_fields.update(current_time);
+            formatDate(text, clock_fields.fields());
+            screen.set(field_date, text);
+            formatTime(text, clock_fields.fields());
+            screen.set(field_time, text);
+
+            // Display smoothed sensor values on OLED
+            temperature_samples.push(sensor.getTemperature());
+            humidity_samples.push(sensor.getHumidity());
+            formatMeasurement(text, "T: ", temperature_samples.mean(), "'C");
+            screen.set(field_temp, text);
+            formatMeasurement(text, "H: ", humidity_samples.mean(), "%");
+            screen.set(field_humid, text);
+
+            // Log sensor values; a full EEPROM page is written every eighth record
+            Demo::LogRecord record = { (uint32_t)current_time, sensor.getTemperature(), sensor.getHumidity() };
+            timer.stop();
+            sensor_log.append(record);
+            eeprom_cache.service();
+            timer.start();
 
-            // Display button state on OLED
-            display.setCursor(0, 24);
-            display.print("Button ");
+            // Display button state on OLED from events queued since last update
+            bool                      was_pressed  = false;
+            bool                      was_released = false;
+            Demo::ButtonEvents::Event events[4];
+            uint8_t                   n_events;
 
-            if (button.released())
+            while (0 != (n_events = button.popBatch(events, 4)))
             {
-                button.clearState();
-                display.print("released.");
-            }
-            else if (button.pressed() || button.getState())
-            {
-                button.clearState();
-                display.print("pressed.");
+                for (uint8_t iter = 0; iter < n_events; ++iter)
+                {
+                    was_pressed  |= (Demo::ButtonEvents::BUTTON_PRESSED == events[iter].type);
+                    was_released |= (Demo::ButtonEvents::BUTTON_RELEASED == events[iter].type);
+                }
             }
+
+            if (was_released)
+                screen.set(field_button, "Button released.");
+            else if (was_pressed || button.pressed())
+                screen.set(field_button, "Button pressed.");
             else
-            {
-                display.print("inactive.");
-            }
+                screen.set(field_button, "Button inactive.");
 
             // Suspend timer when updating display due to shared bus
-            timer.stop();
-            display.display();
-            timer.start();
+            if (OLED_SHARES_BUS) timer.stop();
+            screen.render();
+            if (OLED_SHARES_BUS) timer.start();
         }
         else
         {
@@ -228,6 +327,24 @@ int main()
         // serial_bus.printf("Testing serial... Value = %d.\r\n", val);
         // timer.start();
 
+#if defined(HAL_TRACE) || defined(HAL_BUS_STATS)
+        // Dump bus instrumentation when the host sends any character; timer halted for printf() as above
+        if (telemetry_bus.available())
+        {
+            while (telemetry_bus.available())
+                telemetry_bus.read();
+
+            timer.stop();
+#if defined(HAL_BUS_STATS)
+            HAL::busStatsDump(telemetry_bus);
+#endif
+#if defined(HAL_TRACE)
+            HAL::traceDump(telemetry_bus);
+#endif
+            timer.start();
+        }
+#endif
+
         yieldToTasks();
     }
 
@@ -257,122 +374,58 @@ void yieldToTasks()
     }
 }
 
-// Convert time string to integer values
-bool extractTime(const char *str)
+// Format date as "DD-Mon-YYYY"
+void formatDate(char *str, const tmElements_t &t)
 {
-  int Hour, Min, Sec;
-
-  if (sscanf(str, "%d:%d:%d", &Hour, &Min, &Sec) != 3)
-  {
-    return false;
-  }
-
-  tm.Hour = Hour;
-  tm.Minute = Min;
-  tm.Second = Sec;
+    uint8_t len = Demo::formatUnsigned(str, t.Day, 2);
 
-  return true;
+    str[len++] = '-';
+    memcpy(&str[len], monthShortStr(t.Month), 3);
+    len += 3;
+    str[len++] = '-';
+    Demo::formatUnsigned(&str[len], tmYearToCalendar(t.Year), 4);
 }
 
-// Convert date to values
-bool extractDate(const char *str)
+// Format time as "HH:MM:SS"
+void formatTime(char *str, const tmElements_t &t)
 {
-  char Month[12];
-  int Day, Year;
-  uint8_t monthIndex;
-
-  if (sscanf(str, "%s %d %d", Month, &Day, &Year) != 3)
-  {
-    return false;
-  }
-
-  for (monthIndex = 0; monthIndex < 12; monthIndex++)
-  {
-    if (strcmp(Month, monthName[monthIndex]) == 0)
-    {
-        break;
-    }
-  }
-
-  if (monthIndex >= 12)
-  {
-    return false;
-  }
-
-  tm.Day = Day;
-  tm.Month = monthIndex + 1;
-  tm.Year = CalendarYrToTm(Year);
-
-  return true;
+    Demo::formatUnsigned(&str[0], t.Hour, 2);
+    str[2] = ':';
+    Demo::formatUnsigned(&str[3], t.Minute, 2);
+    str[5] = ':';
+    Demo::formatUnsigned(&str[6], t.Second, 2);
 }
 
-// Print an integer in "00" format (with leading zero),
-// followed by a delimiter character
-void printInteger(int val, char delim)
+// Format centi-unit measurement as "<prefix>00.00<suffix>" without float printf
+void formatMeasurement(char *str, const char *prefix, int16_t val, const char *suffix)
 {
-    if (val < 10)
-    {
-        display.print("0");
-    }
-
-    display.print((int)val);
+    uint8_t len = strlen(prefix);
 
-    if (delim > 0)
-    {
-        display.print(delim);
-    }
-
-    return;
-}
-
-// Print date to display
-void printDate(time_t t)
-{
-    printInteger(day(t), 0);
-    display.print('-');
-    display.print(monthShortStr(month(t)));
-    display.print('-');
-    display.print((int)(year(t)));
-}
-
-// Print time to display
-void printTime(time_t t)
-{
-    printInteger(hour(t), ':');
-    printInteger(minute(t), ':');
-    printInteger(second(t), ' ');
-}
-
-// RTC refresh synchronization
-time_t getTime()
-{
-    return rtc.get();
+    memcpy(str, prefix, len);
+    len += Demo::formatFixed(&str[len], val, 2, 5);
+    strcpy(&str[len], suffix);
 }
 
 // Timer expiration callback
 void timerISR()
 {
-    static bool update_button = false;
-
     segments.refresh();
-
-    if (update_button)
-    {
-        button.poll();
-    }
-
-    update_button = !update_button;
 }
 
-void getTimeFromCompiler()
+// Apply time and date from compiler if RTC is behind; returns current RTC time
+time_t setTimeFromCompiler()
 {
-    if (extractDate(__DATE__))
+    time_t       rtc_time = rtc.get();
+    tmElements_t build_tm = BUILD_ELEMENTS;
+
+    if (rtc_time >= BUILD_TIME)
     {
-        if (extractTime(__TIME__))
-        {
-            rtc.write(tm);
-        }
+        return rtc_time;
     }
+
+    rtc.write(build_tm);
+
+    return BUILD_TIME;
 }
 
 // EOF
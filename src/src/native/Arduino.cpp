@@ -0,0 +1,78 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : Arduino.cpp
+// Purpose     : Native Framework Shim
+// Description : This source file implements the core API declared in header file Arduino.h on the simulator.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "Arduino.h"
+#include "sim.h"
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    Sim::pinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    Sim::pinWrite(pin, val);
+}
+
+int digitalRead(uint8_t pin)
+{
+    return Sim::pinRead(pin);
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(), uint8_t mode)
+{
+    Sim::pinAttachInterrupt(pin, isr, mode);
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    Sim::pinDetachInterrupt(pin);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    Sim::advance((uint64_t)us * Sim::NS_PER_US);
+}
+
+size_t Print::write(const uint8_t * data, size_t len)
+{
+    size_t count = 0;
+
+    while ((count < len) && write(data[count]))
+        ++count;
+
+    return count;
+}
+
+size_t Print::print(const char * str)
+{
+    return write((const uint8_t *)str, strlen(str));
+}
+
+size_t Print::println(const char * str)
+{
+    size_t count = print(str);
+
+    return count + print("\r\n");
+}
+
+// A port without input returns at once rather than after the core's one second timeout
+size_t Stream::readBytes(char * buffer, size_t len)
+{
+    size_t count = 0;
+    int    val;
+
+    while ((count < len) && ((val = read()) >= 0))
+        buffer[count++] = (char)val;
+
+    return count;
+}
+
+// EOF
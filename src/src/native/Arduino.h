@@ -0,0 +1,93 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : Arduino.h
+// Purpose     : Native Framework Shim
+// Description : 
+//               This header stands in for the Arduino framework header when the HAL is built for the native host
+//               backend. It supplies the integer types, C library headers and constants that the HAL headers and
+//               the portable modules depend upon, and the part of the core API the HAL sources use: digital pins,
+//               pin interrupts and delayMicroseconds() act on the simulator in sim.h (Arduino.cpp), and Print and
+//               Stream are the base of the simulated serial ports. Constant values match the SAMD21 Arduino core
+//               and Seeeduino Xiao variant.
+//
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : N/A
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _NATIVE_ARDUINO_H
+#define _NATIVE_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#define LOW             0x0
+#define HIGH            0x1
+
+#define INPUT           0x0
+#define OUTPUT          0x1
+#define INPUT_PULLUP    0x2
+#define INPUT_PULLDOWN  0x3
+
+#define CHANGE          2
+#define FALLING         3
+#define RISING          4
+
+#define PIN_A0          0
+#define PIN_A1          1
+#define PIN_A2          2
+#define PIN_A3          3
+#define PIN_A4          4
+#define PIN_A5          5
+#define PIN_A6          6
+#define PIN_A7          7
+#define PIN_A8          8
+#define PIN_A9          9
+#define PIN_A10         10
+
+#define PIN_WIRE_SDA    4
+#define PIN_WIRE_SCL    5
+
+#define F(str)          (str)
+
+#define digitalPinToInterrupt(pin) (pin)
+
+void     pinMode(uint8_t pin, uint8_t mode);
+void     digitalWrite(uint8_t pin, uint8_t val);
+int      digitalRead(uint8_t pin);
+void     attachInterrupt(uint8_t pin, void (*isr)(), uint8_t mode);
+void     detachInterrupt(uint8_t pin);
+void     delayMicroseconds(uint32_t us);
+
+// Output side of a serial port; a port implements write()
+class Print
+{
+    public:
+        virtual ~Print() { }
+
+        virtual size_t write(uint8_t data) = 0;
+        virtual size_t write(const uint8_t * data, size_t len);
+
+        size_t print(const char * str);
+        size_t println(const char * str);
+};
+
+// Serial port; a port implements input and flush()
+class Stream : public Print
+{
+    public:
+        virtual int  available() = 0;
+        virtual int  read() = 0;
+        virtual void flush() = 0;
+
+        size_t readBytes(char * buffer, size_t len);
+};
+
+#endif // _NATIVE_ARDUINO_H
+
+// EOF
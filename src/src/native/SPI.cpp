@@ -0,0 +1,27 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : SPI.cpp
+// Purpose     : Native Framework Shim
+// Description : This source file implements header file SPI.h.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "SPI.h"
+
+SPIClass SPI(Sim::spi(0));
+
+SPIClass::SPIClass(Sim::SPIBus& bus)
+: _bus(bus)
+{ }
+
+void SPIClass::begin()
+{ }
+
+uint8_t SPIClass::transfer(uint8_t val)
+{
+    return _bus.transfer(val);
+}
+
+// EOF
@@ -0,0 +1,43 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : SPI.h
+// Purpose     : Native Framework Shim
+// Description :
+//               This header stands in for the Arduino SPI library when the HAL is built for the native host
+//               backend. An SPIClass exchanges each byte on a simulated SPI bus (sim.h); the bus keeps its own
+//               clock.
+//
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : sim.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _NATIVE_SPI_H
+#define _NATIVE_SPI_H
+
+#include "Arduino.h"
+#include "sim.h"
+
+class SPIClass
+{
+    public:
+        /**
+         * @brief Constructor for SPIClass object
+         * @param bus Simulated bus; must outlive the object
+        */
+        SPIClass(Sim::SPIBus& bus);
+
+        // As in the Arduino SPI library
+        void    begin();
+        uint8_t transfer(uint8_t val);
+
+    private:
+        Sim::SPIBus& _bus;
+};
+
+extern SPIClass SPI;
+
+#endif // _NATIVE_SPI_H
+
+// EOF
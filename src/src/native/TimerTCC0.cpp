@@ -0,0 +1,15 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : TimerTCC0.cpp
+// Purpose     : Native Framework Shim
+// Description : This source file implements header file TimerTCC0.h.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "TimerTCC0.h"
+
+TimerTCC0 TimerTcc0;
+
+// EOF
@@ -0,0 +1,36 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : TimerTCC0.h
+// Purpose     : Native Framework Shim
+// Description :
+//               This header stands in for the Seeed TimerTCC0 library when the HAL is built for the native host
+//               backend, driving the simulator's periodic timer (sim.h). As on the TCC, start() restarts the
+//               period from the current time.
+//
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : sim.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _NATIVE_TIMERTCC0_H
+#define _NATIVE_TIMERTCC0_H
+
+#include "Arduino.h"
+#include "sim.h"
+
+class TimerTCC0
+{
+    public:
+        // As in the TimerTCC0 library
+        void initialize(uint32_t period_us) { Sim::timerInit(period_us); }
+        void attachInterrupt(void (*isr)()) { Sim::timerAttach(isr); }
+        void start() { Sim::timerRun(true); }
+        void stop() { Sim::timerRun(false); }
+};
+
+extern TimerTCC0 TimerTcc0;
+
+#endif // _NATIVE_TIMERTCC0_H
+
+// EOF
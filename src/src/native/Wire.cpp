@@ -0,0 +1,90 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : Wire.cpp
+// Purpose     : Native Framework Shim
+// Description : This source file implements header file Wire.h.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "Wire.h"
+
+TwoWire Wire(Sim::i2c(0));
+
+TwoWire::TwoWire(Sim::I2CBus& bus)
+: _bus(bus)
+, _tx_addr(0)
+, _tx()
+, _tx_len(0)
+, _rx()
+, _rx_len(0)
+, _rx_pos(0)
+{ }
+
+void TwoWire::begin()
+{ }
+
+void TwoWire::end()
+{ }
+
+void TwoWire::setClock(uint32_t hz)
+{
+    _bus.setClock(hz);
+}
+
+void TwoWire::beginTransmission(uint8_t addr)
+{
+    _tx_addr = addr;
+    _tx_len  = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool stopbit)
+{
+    uint8_t error = _bus.write(_tx_addr, nullptr, 0, _tx, _tx_len, stopbit);
+
+    _tx_len = 0;
+
+    return error;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+    if (_tx_len >= BUFFER_SIZE) return 0;
+
+    _tx[_tx_len++] = data;
+
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t * data, size_t len)
+{
+    size_t count = 0;
+
+    while ((count < len) && write(data[count]))
+        ++count;
+
+    return count;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t addr, size_t len, bool stopbit)
+{
+    if (len > BUFFER_SIZE) len = BUFFER_SIZE;
+
+    _rx_len = _bus.read(addr, _rx, len, stopbit);
+    _rx_pos = 0;
+
+    return (uint8_t)_rx_len;
+}
+
+int TwoWire::available()
+{
+    return (int)(_rx_len - _rx_pos);
+}
+
+int TwoWire::read()
+{
+    return (_rx_pos < _rx_len) ? _rx[_rx_pos++] : -1;
+}
+
+// EOF
@@ -0,0 +1,61 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : Wire.h
+// Purpose     : Native Framework Shim
+// Description :
+//               This header stands in for the Arduino Wire library when the HAL is built for the native host
+//               backend. A TwoWire makes its transactions on a simulated I2C bus (sim.h) the way the SAMD21 core
+//               makes them on its SERCOM: endTransmission() sends the bytes buffered since beginTransmission(), an
+//               address-only write if there are none, and requestFrom() reads into a receive buffer drained by
+//               read(). The transmit buffer is the core's 256 bytes; a write beyond it is refused.
+//
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : sim.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _NATIVE_WIRE_H
+#define _NATIVE_WIRE_H
+
+#include "Arduino.h"
+#include "sim.h"
+
+class TwoWire
+{
+    public:
+        /**
+         * @brief Constructor for TwoWire object
+         * @param bus Simulated bus; must outlive the object
+        */
+        TwoWire(Sim::I2CBus& bus);
+
+        // As in the Arduino Wire library
+        void    begin();
+        void    end();
+        void    setClock(uint32_t hz);
+        void    beginTransmission(uint8_t addr);
+        uint8_t endTransmission(bool stopbit=true);
+        size_t  write(uint8_t data);
+        size_t  write(const uint8_t * data, size_t len);
+        uint8_t requestFrom(uint8_t addr, size_t len, bool stopbit=true);
+        int     available();
+        int     read();
+
+    private:
+        static const size_t BUFFER_SIZE = 256;
+
+        Sim::I2CBus& _bus;
+        uint8_t      _tx_addr;
+        uint8_t      _tx[BUFFER_SIZE];
+        size_t       _tx_len;
+        uint8_t      _rx[BUFFER_SIZE];
+        size_t       _rx_len;
+        size_t       _rx_pos;
+};
+
+extern TwoWire Wire;
+
+#endif // _NATIVE_WIRE_H
+
+// EOF
@@ -0,0 +1,54 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : bench-main.cpp
+// Purpose     : Native HAL Microbenchmark Entry
+// Description : This main source file runs the HAL microbenchmark suite on the native HAL backend against the
+//               simulated board. Cycles are virtual time at the nominal core clock, so results show bus and delay
+//               costs only; they are deterministic and suited to catching changes in bus traffic per HAL call.
+//               Build and run with `pio run -e native_bench -t exec`.
+// Platform    : Native
+// Framework   : Simulation
+// Language    : C++
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "hal.h"
+#include "hal-bench.h"
+#include "sim.h"
+#include "sim-board.h"
+
+// Baud settings, as on target
+const uint32_t SERIAL_BAUDRATE = 1000000;
+const uint32_t I2C_BAUDRATE    = 100000;
+const uint32_t SPI_BAUDRATE    = 1000000;
+
+// Simulated board
+Sim::Board board;
+
+// HAL-mediated utility
+HAL::Timer timer;
+
+// Peripheral buses
+HAL::I2C&  i2c_bus    = HAL::i2cBus(0);
+HAL::SPI&  spi_bus    = HAL::spiBus(0);
+HAL::UART& serial_bus = HAL::uartBus(0);
+
+// Peripheral objects
+HAL::GPIO      eeprom_wp(Sim::BOARD_EEPROM_WP_PIN);
+Demo::HALBench bench(serial_bus, i2c_bus, spi_bus, timer, Sim::BOARD_EEPROM_ADDR);
+
+int main()
+{
+    board.attach();
+    Sim::uart().setEcho(true);
+
+    serial_bus.init(SERIAL_BAUDRATE);
+    i2c_bus.init(I2C_BAUDRATE);
+    spi_bus.init(SPI_BAUDRATE);
+
+    eeprom_wp.pinMode(GPIO_OUTPUT);
+    eeprom_wp.digitalWrite(HIGH);
+
+    return (bench.run() > 0) ? 0 : 1;
+}
+
+// EOF
@@ -0,0 +1,261 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : button-main.cpp
+// Purpose     : Native Button Bounce Scenario
+// Description : This main source file injects contact bounce on the simulated button pin and checks the events
+//               ButtonEvents (button-events.h) queues against the presses and releases intended:
+//
+//                 press/release  each first edge followed by 6-7 bounces 200-500 us apart, settling at the new
+//                                level; one event is expected per edge burst, timestamped at its first edge
+//                 glitch         every tenth press bounces back to released within the debounce window; the
+//                                press is accepted at its edge and the release follows from service() once the
+//                                pin has been quiet for a full window
+//
+//               The button is active low: a press drives the pin low and a release lets the internal pull-up
+//               restore it. The main loop calls service() and drains the queue every millisecond.
+//
+//               Options: --cycles N       press/release cycles (default 1000, at most 2000)
+//                        --debounce-us N  debounce window (default 5000)
+//                        --seed N         bounce generator seed (default 1)
+//
+//               Results are printed one key=value pair per line, as by the native workload; any missing, extra or
+//               out of order event fails the run. Build and run with `pio run -e native_button -t exec`.
+// Platform    : Native
+// Framework   : Simulation
+// Language    : C++
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hal.h"
+#include "sim.h"
+#include "sim-board.h"
+#include "button-events.h"
+
+// Stimulus timing
+const uint32_t BOUNCE_MIN_US  = 200;
+const uint32_t BOUNCE_MAX_US  = 500;
+const uint64_t HOLD_NS        = 50 * Sim::NS_PER_MS;
+const uint64_t IDLE_NS        = 50 * Sim::NS_PER_MS;
+const uint16_t GLITCH_EVERY   = 10;
+const uint16_t MAX_CYCLES     = 2000;
+
+// Edges per cycle: two bursts of at most 1 + 7 + 1 edges
+const uint32_t MAX_EDGES      = MAX_CYCLES * 18;
+
+// Stimulus edge and intended event
+struct Edge
+{
+    uint64_t time_ns;
+    uint8_t  level;
+};
+
+struct Expected
+{
+    Demo::ButtonEvents::EventType type;
+    uint32_t                      time_us;
+    bool                          reconciled;
+};
+
+// Simulated board
+Sim::Board board;
+
+// Stimulus, generated up front and applied from scheduled callbacks
+Edge     edges[MAX_EDGES];
+uint32_t edge_count = 0;
+Expected expected[MAX_CYCLES * 2];
+uint32_t expected_count = 0;
+
+// Generator state
+uint32_t random_state = 1;
+
+// Function prototypes
+void     generate(uint16_t cycles);
+uint64_t burst(uint64_t time_ns, uint8_t level);
+void     applyEdge(void * ctx);
+uint32_t nextRandom(uint32_t lo, uint32_t hi);
+uint32_t option(int argc, char ** argv, const char * name, uint32_t fallback);
+void     report(const char * key, uint64_t val);
+
+int main(int argc, char ** argv)
+{
+    uint32_t cycles           = option(argc, argv, "--cycles", 1000);
+    uint32_t debounce_us      = option(argc, argv, "--debounce-us", 5000);
+    uint32_t presses          = 0;
+    uint32_t releases         = 0;
+    uint32_t errors           = 0;
+    uint32_t matched          = 0;
+    uint32_t press_max_us     = 0;
+    uint32_t release_max_us   = 0;
+    uint32_t reconcile_max_us = 0;
+    uint64_t end_ns;
+
+    random_state = option(argc, argv, "--seed", 1);
+    if (cycles > MAX_CYCLES) cycles = MAX_CYCLES;
+
+    board.attach();
+    Sim::uart().setEcho(false);
+
+    Demo::ButtonEvents button(Sim::BOARD_BUTTON_PIN, debounce_us);
+
+    Sim::pinRelease(Sim::BOARD_BUTTON_PIN);
+    button.init();
+
+    generate((uint16_t)cycles);
+    Sim::schedule(edges[0].time_ns, applyEdge, nullptr);
+    end_ns = edges[edge_count - 1].time_ns + IDLE_NS;
+
+    while (Sim::now() < end_ns)
+    {
+        Demo::ButtonEvents::Event events[4];
+        uint8_t                   n_events;
+
+        HAL::delay_ms(1);
+        button.service();
+
+        while (0 != (n_events = button.popBatch(events, 4)))
+        {
+            for (uint8_t iter = 0; iter < n_events; ++iter)
+            {
+                const Demo::ButtonEvents::Event& event = events[iter];
+                uint32_t                         latency;
+
+                if (Demo::ButtonEvents::BUTTON_PRESSED == event.type)
+                    ++presses;
+                else
+                    ++releases;
+
+                if ((matched >= expected_count) || (expected[matched].type != event.type) ||
+                    ((int32_t)(event.time_us - expected[matched].time_us) < 0))
+                {
+                    ++errors;
+                    continue;
+                }
+
+                latency = event.time_us - expected[matched].time_us;
+
+                if (expected[matched].reconciled)
+                    reconcile_max_us = (latency > reconcile_max_us) ? latency : reconcile_max_us;
+                else if (Demo::ButtonEvents::BUTTON_PRESSED == event.type)
+                    press_max_us = (latency > press_max_us) ? latency : press_max_us;
+                else
+                    release_max_us = (latency > release_max_us) ? latency : release_max_us;
+
+                ++matched;
+            }
+        }
+    }
+
+    errors += expected_count - matched;
+
+    report("cycles", cycles);
+    report("edges", edge_count);
+    report("expected_events", expected_count);
+    report("presses", presses);
+    report("releases", releases);
+    report("press_latency_max_us", press_max_us);
+    report("release_latency_max_us", release_max_us);
+    report("reconcile_latency_max_us", reconcile_max_us);
+    report("overflows", button.overflows());
+    report("errors", errors);
+
+    return errors ? 1 : 0;
+}
+
+// Build the stimulus and the events it should produce
+void generate(uint16_t cycles)
+{
+    uint64_t time_ns = 10 * Sim::NS_PER_MS;
+
+    for (uint16_t cycle = 0; cycle < cycles; ++cycle)
+    {
+        expected[expected_count++] = { Demo::ButtonEvents::BUTTON_PRESSED, (uint32_t)(time_ns / Sim::NS_PER_US),
+                                       false };
+
+        if ((cycle % GLITCH_EVERY) == (GLITCH_EVERY - 1))
+        {
+            // Press edge, then back to released for good; service() reports the release
+            edges[edge_count++] = { time_ns, LOW };
+            time_ns += (uint64_t)nextRandom(BOUNCE_MIN_US, BOUNCE_MAX_US) * Sim::NS_PER_US;
+            edges[edge_count++] = { time_ns, HIGH };
+            expected[expected_count++] = { Demo::ButtonEvents::BUTTON_RELEASED,
+                                           (uint32_t)(time_ns / Sim::NS_PER_US), true };
+            time_ns += IDLE_NS;
+            continue;
+        }
+
+        time_ns = burst(time_ns, LOW) + HOLD_NS;
+        expected[expected_count++] = { Demo::ButtonEvents::BUTTON_RELEASED, (uint32_t)(time_ns / Sim::NS_PER_US),
+                                       false };
+        time_ns = burst(time_ns, HIGH) + IDLE_NS;
+    }
+}
+
+// First edge to a level, 6-7 bounces, then settled at that level; returns the time of the last edge
+uint64_t burst(uint64_t time_ns, uint8_t level)
+{
+    uint8_t bounces = (uint8_t)nextRandom(6, 7);
+    uint8_t current = level;
+
+    edges[edge_count++] = { time_ns, current };
+
+    for (uint8_t iter = 0; iter < bounces; ++iter)
+    {
+        time_ns += (uint64_t)nextRandom(BOUNCE_MIN_US, BOUNCE_MAX_US) * Sim::NS_PER_US;
+        current  = (LOW == current) ? HIGH : LOW;
+        edges[edge_count++] = { time_ns, current };
+    }
+
+    if (current != level)
+    {
+        time_ns += (uint64_t)nextRandom(BOUNCE_MIN_US, BOUNCE_MAX_US) * Sim::NS_PER_US;
+        edges[edge_count++] = { time_ns, level };
+    }
+
+    return time_ns;
+}
+
+// Apply the next stimulus edge and schedule the one after it; released means left to the pull-up
+void applyEdge(void * ctx)
+{
+    static uint32_t index = 0;
+
+    (void)ctx;
+
+    if (LOW == edges[index].level)
+        Sim::pinDrive(Sim::BOARD_BUTTON_PIN, LOW);
+    else
+        Sim::pinRelease(Sim::BOARD_BUTTON_PIN);
+
+    if (++index < edge_count)
+        Sim::schedule(edges[index].time_ns, applyEdge, nullptr);
+}
+
+// Uniform value in [lo, hi] from a linear congruential generator
+uint32_t nextRandom(uint32_t lo, uint32_t hi)
+{
+    random_state = (random_state * 1103515245u) + 12345u;
+
+    return lo + ((random_state >> 16) % (hi - lo + 1));
+}
+
+// Parse "--name value" from the command line
+uint32_t option(int argc, char ** argv, const char * name, uint32_t fallback)
+{
+    for (int iter = 1; iter + 1 < argc; ++iter)
+    {
+        if (0 == strcmp(argv[iter], name))
+            return (uint32_t)strtoul(argv[iter + 1], nullptr, 0);
+    }
+
+    return fallback;
+}
+
+// Print one result
+void report(const char * key, uint64_t val)
+{
+    printf("%s=%llu\n", key, (unsigned long long)val);
+}
+
+// EOF
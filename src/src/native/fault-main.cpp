@@ -0,0 +1,173 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : fault-main.cpp
+// Purpose     : Native I2C Fault Recovery Scenarios
+// Description : This main source file injects I2C bus faults on the simulated board and measures how long the HAL
+//               takes to detect and recover from each, in virtual time:
+//
+//                 sda_*     a slave holding SDA low mid-byte; recovered by the bus clear after the failed transaction
+//                 scl_*     a slave holding SCL low for --scl-hold-ms; each transaction ends at the SCL low timeout
+//                 absent_*  the HTU21D detached while the loop keeps polling it every --loop-ms, then reattached;
+//                           bus time spent on it is compared with one NACKed attempt per loop, as before backoff
+//
+//               Options: --loops N        loop iterations with the device absent (default 100)
+//                        --loop-ms N      loop period (default 100)
+//                        --scl-hold-ms N  SCL hold time (default 60)
+//
+//               Results are printed one key=value pair per line, as by the native workload. Build and run with
+//               `pio run -e native_faults -t exec`.
+// Platform    : Native
+// Framework   : Simulation
+// Language    : C++
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hal.h"
+#include "sim.h"
+#include "sim-board.h"
+
+// Baud settings, as on target
+const uint32_t I2C_BAUDRATE = 100000;
+
+// Registers read by each scenario: DS3232 seconds, HTU21D user register
+const uint8_t RTC_SECONDS_REG   = 0x00;
+const uint8_t SENSOR_USER_REG   = 0xE7;
+
+// Clock pulses the interrupted slave needs to finish its byte
+const uint8_t SDA_HOLD_PULSES   = 5;
+
+// Transactions attempted before a scenario is reported as unrecovered
+const uint16_t MAX_ATTEMPTS     = 1000;
+
+// Simulated board
+Sim::Board board;
+
+// Peripheral buses
+HAL::I2C& i2c_bus = HAL::i2cBus(0);
+
+// Function prototypes
+uint64_t elapsedUs(uint64_t start_ns);
+uint32_t option(int argc, char ** argv, const char * name, uint32_t fallback);
+void     report(const char * key, uint64_t val);
+
+int main(int argc, char ** argv)
+{
+    uint32_t loops       = option(argc, argv, "--loops", 100);
+    uint32_t loop_ms     = option(argc, argv, "--loop-ms", 100);
+    uint32_t scl_hold_ms = option(argc, argv, "--scl-hold-ms", 60);
+    uint64_t start;
+    uint64_t attempt;
+    uint64_t absent_ns   = 0;
+    uint64_t attempt_ns  = 0;
+    uint32_t attempts    = 0;
+    uint32_t skipped     = 0;
+    uint32_t failures    = 0;
+    uint8_t  error       = 0;
+    uint8_t  val         = 0;
+
+    board.attach();
+    Sim::uart().setEcho(false);
+    i2c_bus.init(I2C_BAUDRATE);
+
+    // Stuck SDA: the first transaction fails with a bus error and triggers the bus clear
+    Sim::i2c().holdSDA(SDA_HOLD_PULSES);
+    start = Sim::now();
+    error = i2c_bus.writeRead(Sim::BOARD_RTC_ADDR, RTC_SECONDS_REG, &val);
+    report("sda_error", error);
+    report("sda_detect_us", elapsedUs(start));
+
+    for (failures = 0; (failures < MAX_ATTEMPTS) && i2c_bus.writeRead(Sim::BOARD_RTC_ADDR, RTC_SECONDS_REG, &val);)
+        ++failures;
+
+    report("sda_recovery_us", elapsedUs(start));
+    report("sda_failed_retries", failures);
+    report("sda_recoveries", i2c_bus.recoveries());
+
+    // Stuck SCL: each transaction runs to the SCL low timeout until the slave lets go
+    Sim::i2c().holdSCL((uint64_t)scl_hold_ms * Sim::NS_PER_MS);
+    start = Sim::now();
+    error = i2c_bus.writeRead(Sim::BOARD_RTC_ADDR, RTC_SECONDS_REG, &val);
+    report("scl_error", error);
+    report("scl_detect_us", elapsedUs(start));
+
+    for (failures = 0; (failures < MAX_ATTEMPTS) && i2c_bus.writeRead(Sim::BOARD_RTC_ADDR, RTC_SECONDS_REG, &val);)
+        ++failures;
+
+    report("scl_recovery_us", elapsedUs(start));
+    report("scl_failed_retries", failures);
+    report("scl_recoveries", i2c_bus.recoveries());
+
+    // Absent device: polled once per loop; backed off attempts return without touching the bus
+    Sim::i2c().detach(board.sensor);
+
+    for (uint32_t iter = 0; iter < loops; ++iter)
+    {
+        attempt = Sim::now();
+        error   = i2c_bus.writeRead(Sim::BOARD_HTU21D_ADDR, SENSOR_USER_REG, &val);
+        attempt = Sim::now() - attempt;
+
+        if (HAL::I2C_ERROR_BACKOFF == error)
+        {
+            ++skipped;
+        }
+        else
+        {
+            ++attempts;
+            absent_ns  += attempt;
+            attempt_ns  = attempt;
+        }
+
+        HAL::delay_ms(loop_ms);
+    }
+
+    report("absent_loops", loops);
+    report("absent_attempts", attempts);
+    report("absent_skipped", skipped);
+    report("absent_attempt_us", attempt_ns / Sim::NS_PER_US);
+    report("absent_bus_us", absent_ns / Sim::NS_PER_US);
+    report("absent_bus_us_without_backoff", ((uint64_t)loops * attempt_ns) / Sim::NS_PER_US);
+
+    // Device returns: time until the loop reaches it again, bounded by the backoff interval in force
+    Sim::i2c().attach(board.sensor);
+    start = Sim::now();
+
+    for (failures = 0; failures < MAX_ATTEMPTS; ++failures)
+    {
+        if (0 == i2c_bus.writeRead(Sim::BOARD_HTU21D_ADDR, SENSOR_USER_REG, &val)) break;
+
+        HAL::delay_ms(loop_ms);
+    }
+
+    report("absent_reacquire_ms", elapsedUs(start) / 1000);
+    report("absent_reacquire_loops", failures);
+
+    return 0;
+}
+
+// Virtual time since a start point in microseconds
+uint64_t elapsedUs(uint64_t start_ns)
+{
+    return (Sim::now() - start_ns) / Sim::NS_PER_US;
+}
+
+// Parse "--name value" from the command line
+uint32_t option(int argc, char ** argv, const char * name, uint32_t fallback)
+{
+    for (int iter = 1; iter + 1 < argc; ++iter)
+    {
+        if (0 == strcmp(argv[iter], name))
+            return (uint32_t)strtoul(argv[iter + 1], nullptr, 0);
+    }
+
+    return fallback;
+}
+
+// Print one result
+void report(const char * key, uint64_t val)
+{
+    printf("%s=%llu\n", key, (unsigned long long)val);
+}
+
+// EOF
@@ -0,0 +1,106 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-dma-hw.cpp
+// Purpose     : Hardware Abstraction Layer DMA Scheduler Backend
+// Description : This source file implements header file hal-dma-hw.h for the native simulator backend. A job's
+//               bytes are moved to the simulated bus of its request between Sim::deferBegin() and deferEnd(), and
+//               its completion is scheduled as far ahead in virtual time as the bus time they collected. An I2C job
+//               completes with the result the simulated bus gave, for the I2C backend to report. The DMAC trigger
+//               and destination of a request are not used.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "Arduino.h"
+#include "hal.h"
+#include "hal-dma-hw.h"
+#include "sim.h"
+
+namespace HAL
+{
+
+// Gather buffer of an I2C job, whose length the SERCOM length counter bounds on target
+static const uint32_t DMA_I2C_LENGTH_MAX = 0xFF;
+
+// Simulated transfer per DMAC channel
+struct Transfer
+{
+    uint8_t  dma_channel;
+    uint8_t  result;
+    uint64_t end_ns;
+};
+
+static Transfer transfers[HAL_DMA_CHANNELS];
+
+static void complete(void * ctx)
+{
+    Transfer& transfer = *(Transfer *)ctx;
+
+    dmaComplete(transfer.dma_channel, transfer.result);
+}
+
+// Move the request's bytes to its bus; returns the bus result
+static uint8_t move(const DMARequest& request)
+{
+    uint8_t  staged[DMA_I2C_LENGTH_MAX];
+    uint32_t offset = 0;
+
+    for (uint8_t seg = 0; seg < request.count; ++seg)
+    {
+        const DMASegment& segment = request.segs[seg];
+
+        if (BUS_SPI == request.bus)
+        {
+            for (uint32_t iter = 0; iter < segment.len; ++iter)
+                Sim::spi(request.channel).transfer(segment.data[iter]);
+        }
+        else if (BUS_UART == request.bus)
+        {
+            Sim::uart(request.channel).write((const char *)segment.data, segment.len);
+        }
+        else
+        {
+            for (uint32_t iter = 0; (iter < segment.len) && (offset < DMA_I2C_LENGTH_MAX); ++iter)
+                staged[offset++] = segment.data[iter];
+        }
+    }
+
+    if (BUS_I2C != request.bus) return 0;
+
+    return Sim::i2c(request.channel).write(request.addr, nullptr, 0, staged, offset);
+}
+
+void dmaHwStart(uint8_t dma_channel, const DMARequest& request)
+{
+    Transfer& transfer = transfers[dma_channel];
+
+    Sim::deferBegin();
+    transfer.dma_channel = dma_channel;
+    transfer.result      = move(request);
+    transfer.end_ns      = Sim::now() + Sim::deferEnd();
+
+    // With the event table full the job ends at once rather than never
+    if (!Sim::schedule(transfer.end_ns, complete, &transfer))
+    {
+        CriticalSection lock;
+        complete(&transfer);
+    }
+}
+
+void dmaHwStop(uint8_t dma_channel)
+{
+    Sim::cancel(complete, &transfers[dma_channel]);
+}
+
+// Virtual time is moved on to the job's end, which delivers its completion
+void dmaHwService(uint8_t dma_channel)
+{
+    uint64_t now = Sim::now();
+
+    Sim::advance((transfers[dma_channel].end_ns > now) ? (transfers[dma_channel].end_ns - now) : 0);
+}
+
+}
+
+// EOF
@@ -0,0 +1,88 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-i2c-hw.cpp
+// Purpose     : Hardware Abstraction Layer I2C Backend
+// Description : This source file implements header file hal-i2c-hw.h for the native simulator backend. Each
+//               channel's TwoWire makes its transactions on the simulated bus of that channel; a DMA write reaches
+//               the bus through the DMA scheduler backend, which completes it with the bus result.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "hal-i2c.h"
+#include "hal-i2c-hw.h"
+#include "sim.h"
+
+namespace HAL
+{
+
+// Bus clear: at most one byte and an acknowledge clocked out
+static const uint8_t I2C_CLEAR_PULSES = 9;
+
+#if defined(HAL_I2C1_SERCOM)
+static TwoWire Wire1(Sim::i2c(1));
+#endif
+
+static TwoWire * const wires[I2C_CHANNELS] = {
+    &::Wire,
+#if defined(HAL_I2C1_SERCOM)
+    &Wire1,
+#endif
+};
+
+TwoWire& i2cHwWire(uint8_t channel)
+{
+    return *wires[channel];
+}
+
+void i2cHwBegin(uint8_t channel)
+{
+    wires[channel]->begin();
+}
+
+// The simulated bus has no timeouts to set; it models the SCL low timeout itself
+void i2cHwClock(uint8_t channel, uint32_t hz)
+{
+    wires[channel]->setClock(hz);
+}
+
+uint8_t i2cHwClear(uint8_t channel, uint32_t hz)
+{
+    bool released = Sim::i2c(channel).busClear(I2C_CLEAR_PULSES);
+
+    i2cHwBegin(channel);
+    i2cHwClock(channel, hz);
+
+    return released ? 0 : I2C_ERROR_BUS;
+}
+
+void i2cHwWriteRequest(uint8_t channel, DMARequest& request)
+{
+    (void) channel;
+
+    request.trigger = 0;
+    request.dest    = nullptr;
+}
+
+// The bytes went out with the address when the job was started
+void i2cHwWriteStart(uint8_t channel, uint8_t addr, uint32_t len)
+{
+    (void) channel;
+    (void) addr;
+    (void) len;
+}
+
+// The completion carries the simulated bus result, already an I2C_ERROR_* code
+uint8_t i2cHwWriteEnd(uint8_t channel, uint8_t error)
+{
+    (void) channel;
+
+    return error;
+}
+
+}
+
+// EOF
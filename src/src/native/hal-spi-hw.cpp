@@ -0,0 +1,54 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-spi-hw.cpp
+// Purpose     : Hardware Abstraction Layer SPI Backend
+// Description : This source file implements header file hal-spi-hw.h for the native simulator backend. Each
+//               channel's SPIClass exchanges bytes on the simulated bus of that channel; a DMA write reaches the
+//               bus through the DMA scheduler backend.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "hal-spi-hw.h"
+#include "sim.h"
+
+namespace HAL
+{
+
+#if defined(HAL_SPI1_SERCOM)
+static SPIClass SPI1(Sim::spi(1));
+#endif
+
+static SPIClass * const ports[SPI_CHANNELS] = {
+    &::SPI,
+#if defined(HAL_SPI1_SERCOM)
+    &SPI1,
+#endif
+};
+
+SPIClass& spiHwPort(uint8_t channel)
+{
+    return *ports[channel];
+}
+
+void spiHwBegin(uint8_t channel)
+{
+    ports[channel]->begin();
+}
+
+void spiHwWriteRequest(uint8_t channel, DMARequest& request)
+{
+    (void) channel;
+
+    request.trigger = 0;
+    request.dest    = nullptr;
+    request.done    = nullptr;
+    request.ctx     = nullptr;
+}
+
+}
+
+// EOF
@@ -0,0 +1,82 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal-uart-hw.cpp
+// Purpose     : Hardware Abstraction Layer UART Backend
+// Description : This source file implements header file hal-uart-hw.h for the native simulator backend. Each
+//               channel's Stream writes to the simulated port of that channel, which echoes it to host stdout;
+//               there is no input. A DMA write reaches the port through the DMA scheduler backend.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "Arduino.h"
+#include "hal-uart-hw.h"
+#include "sim.h"
+
+namespace HAL
+{
+
+// Stream on a simulated port
+class Port : public Stream
+{
+    public:
+        Port(Sim::UARTPort& port) : _port(port) { }
+
+        size_t write(uint8_t data) { return _port.write((const char *)&data, 1); }
+        size_t write(const uint8_t * data, size_t len) { return _port.write((const char *)data, len); }
+        int    available() { return 0; }
+        int    read() { return -1; }
+        void   flush() { }
+
+        void   begin(uint32_t baud) { _port.setBaud(baud); }
+
+    private:
+        Sim::UARTPort& _port;
+};
+
+static Port port0(Sim::uart(0));
+#if defined(HAL_UART1_PORT)
+static Port port1(Sim::uart(1));
+#endif
+
+static Port * const ports[UART_CHANNELS] = {
+    &port0,
+#if defined(HAL_UART1_PORT)
+    &port1,
+#endif
+};
+
+Stream& uartHwPort(uint8_t channel)
+{
+    return *ports[channel];
+}
+
+void uartHwBegin(uint8_t channel, uint32_t baud)
+{
+    ports[channel]->begin(baud);
+}
+
+// Channel 0 stands for USB CDC, which has no SERCOM
+bool uartHwWriteRequest(uint8_t channel, DMARequest& request)
+{
+#if defined(HAL_UART1_SERCOM)
+    if (0 == channel) return false;
+
+    request.trigger = 0;
+    request.dest    = nullptr;
+    request.done    = nullptr;
+    request.ctx     = nullptr;
+
+    return true;
+#else
+    (void) channel;
+    (void) request;
+
+    return false;
+#endif
+}
+
+}
+
+// EOF
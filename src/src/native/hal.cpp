@@ -0,0 +1,65 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : hal.cpp
+// Purpose     : Hardware Abstraction Layer
+// Description : This source file implements header file hal.h for the native simulator backend.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "Arduino.h"
+#include "hal.h"
+#include "sim.h"
+
+namespace HAL
+{
+
+void delay_s(uint32_t time_s)
+{
+    Sim::advance((uint64_t)time_s * Sim::NS_PER_S);
+}
+
+void delay_ms(uint32_t time_ms)
+{
+    Sim::advance((uint64_t)time_ms * Sim::NS_PER_MS);
+}
+
+void delay_us(uint32_t time_us)
+{
+    Sim::advance((uint64_t)time_us * Sim::NS_PER_US);
+}
+
+uint32_t millis()
+{
+    return (uint32_t)(Sim::now() / Sim::NS_PER_MS);
+}
+
+uint32_t micros()
+{
+    return (uint32_t)(Sim::now() / Sim::NS_PER_US);
+}
+
+uint32_t cycles()
+{
+    return (uint32_t)((Sim::now() * (Sim::CPU_FREQUENCY / 1000000)) / Sim::NS_PER_US);
+}
+
+uint32_t cpuFrequency()
+{
+    return Sim::CPU_FREQUENCY;
+}
+
+uint32_t disableInterrupts()
+{
+    return Sim::disableInterrupts();
+}
+
+void restoreInterrupts(uint32_t state)
+{
+    Sim::restoreInterrupts(state);
+}
+
+}
+
+// EOF
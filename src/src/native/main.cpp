@@ -0,0 +1,484 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : main.cpp
+// Purpose     : Native Simulation Workload
+// Description : This main source file runs the application loop on the native HAL backend against the simulated
+//               board and reports loop timing and bus occupancy. It exercises the portable modules with the bus
+//               traffic of the target main loop: sensor pipeline, EEPROM log, OLED field updates, 7-segment refresh
+//               from the timer ISR, debounced button events and the RTC square wave tick. Drivers from lib/ and
+//               TimeLib are not built natively, so their traffic is issued directly where it matters.
+//
+//               Options: --seconds N   simulated run time (default 60)
+//                        --i2c-hz N    I2C clock for devices without a clock of their own (default 100000)
+//                        --oled-hz N, --eeprom-hz N, --device-hz N   SSD1306, AT24C256 and other device clocks
+//                                      (defaults as on target; 0 runs the device at the bus clock)
+//                        --i2c-txn-ns N, --i2c-byte-ns N, --i2c-switch-ns N   I2C software overheads and clock
+//                                      switch cost (default 0)
+//                        --ticker-lines N  lines streamed per ticker run (default 64)
+//
+//               After the loop, OLEDTicker streams --ticker-lines lines of text with the OLED clock at 100 kHz and
+//               at 400 kHz, and the rate is reported as ticker_*_lines_per_s beside the rate of pushing the whole
+//               frame for each line instead. The timer is stopped by then, so the ticker has the bus to itself.
+//
+//               Results are printed one key=value pair per line so that runs can be compared by a script. Built
+//               with HAL_BUS_STATS or HAL_TRACE, per-device bus statistics or the bus trace ring are dumped after
+//               the results.
+//
+//               Built with HAL_I2C1_SERCOM, the OLED moves to I2C channel 1 as on target and its bus is reported
+//               as i2c1_*; the i2c_* results then cover channel 0 only. Likewise HAL_SPI1_SERCOM moves the shift
+//               register to SPI channel 1 (spi1_*), and HAL_UART1_PORT moves the instrumentation dumps to UART
+//               channel 1.
+// Platform    : Native
+// Framework   : Simulation
+// Language    : C++
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "hal.h"
+#include "hal-trace.h"
+#include "hal-busstats.h"
+#include "sim.h"
+#include "sim-board.h"
+#include "fixed-format.h"
+#include "htu21d-fixed.h"
+#include "eeprom-cache.h"
+#include "eeprom-log.h"
+#include "oled-io.h"
+#include "oled-ticker.h"
+#include "ssd1306.h"
+#include "seg-frames.h"
+#include "button-events.h"
+
+// Baud and timer settings, as on target
+const uint32_t SERIAL_BAUDRATE = 1000000;
+const uint32_t I2C_BAUDRATE    = 100000;
+const uint32_t SPI_BAUDRATE    = 1000000;
+const uint32_t TIMER_PERIOD_US = 2500;
+
+// OLED on a channel of its own, as on target when HAL_I2C1_SERCOM maps one; otherwise the timer ISR, whose
+// expander traffic shares channel 0, is held off while the panel is pushed
+const bool     OLED_SHARES_BUS = (0 == Sim::BOARD_OLED_CHANNEL);
+
+#if defined(HAL_UART1_PORT)
+const uint8_t  TELEMETRY_UART_CHANNEL = 1;
+#else
+const uint8_t  TELEMETRY_UART_CHANNEL = 0;
+#endif
+
+// OLED clocks of the ticker runs
+const uint32_t TICKER_CLOCKS[] = { 100000, 400000 };
+
+// Per-device maximum I2C clocks, as on target
+const uint32_t OLED_I2C_CLOCK   = 400000;
+const uint32_t EEPROM_I2C_CLOCK = 1000000;
+const uint32_t DEVICE_I2C_CLOCK = 400000;
+
+// Board wiring, as on target
+const uint8_t  RTC_SQW_PIN            = Sim::BOARD_RTC_SQW_PIN;
+const uint8_t  EEPROM_WP_PIN          = Sim::BOARD_EEPROM_WP_PIN;
+const uint8_t  BUTTON_PIN             = Sim::BOARD_BUTTON_PIN;
+const uint8_t  OLED_SCREEN_WIDTH      = 128;
+const uint8_t  OLED_SCREEN_HEIGHT     = 64;
+const uint8_t  OLED_SCREEN_ADDRESS    = Sim::BOARD_OLED_ADDR;
+const uint8_t  EEPROM_ADDRESS         = Sim::BOARD_EEPROM_ADDR;
+const uint8_t  RTC_ADDRESS            = Sim::BOARD_RTC_ADDR;
+const uint16_t EEPROM_LOG_FIRST_PAGE  = 4;
+const uint16_t EEPROM_LOG_PAGE_COUNT  = 508;
+const uint32_t RTC_START_EPOCH        = Sim::BOARD_RTC_EPOCH;
+
+// Dummy pin numbers for 7-seg display (8 segments then 4 digit selects); actual arrangement handled in the HAL
+const uint8_t DISPLAY_PINS[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+
+// Simulated board
+Sim::Board board;
+
+// HAL-mediated utility
+HAL::Timer timer;
+
+// Peripheral buses, shared with the HAL's own drivers through the registry; the OLED and the instrumentation dumps
+// have channels of their own when the build maps them, as on target
+HAL::I2C&  i2c_bus       = HAL::i2cBus(0);
+HAL::SPI&  spi_bus       = HAL::spiBus(0);
+HAL::UART& serial_bus    = HAL::uartBus(0);
+HAL::I2C&  oled_bus      = HAL::i2cBus(Sim::BOARD_OLED_CHANNEL);
+HAL::UART& telemetry_bus = HAL::uartBus(TELEMETRY_UART_CHANNEL);
+
+// Peripheral objects
+HAL::GPIO               rtc_sqw(RTC_SQW_PIN);
+Demo::ButtonEvents      button(BUTTON_PIN);
+HAL::GPIOPort           display_port(DISPLAY_PINS, sizeof(DISPLAY_PINS));
+Demo::SegmentFrames     segments(display_port);
+Demo::HTU21DFixed       sensor(i2c_bus);
+Demo::EEPROMWriteCache  eeprom_cache(i2c_bus, EEPROM_ADDRESS, EEPROM_WP_PIN);
+Demo::EEPROMLog         sensor_log(eeprom_cache, EEPROM_LOG_FIRST_PAGE, EEPROM_LOG_PAGE_COUNT);
+Demo::OLEDIO            oled(oled_bus, OLED_SCREEN_ADDRESS, OLED_SCREEN_WIDTH);
+PeripheralIO::SSD1306   display(oled_bus, OLED_SCREEN_WIDTH, OLED_SCREEN_HEIGHT);
+Demo::OLEDTicker        ticker(display, oled);
+
+// Local frame buffer standing in for the SSD1306 driver buffer
+uint8_t frame[OLED_SCREEN_WIDTH * 8];
+
+// Seconds counted from RTC square wave falling edges
+volatile uint32_t rtc_seconds = 0;
+
+// Scripted button stimulus: a bouncing press every ten seconds, released 400 ms later
+struct Stimulus
+{
+    uint64_t offset_ns;
+    uint8_t  level;
+};
+
+const Stimulus BUTTON_SCRIPT[] = {
+    { 3000000000ULL, LOW  }, { 3000300000ULL, HIGH }, { 3000800000ULL, LOW  },
+    { 3001500000ULL, HIGH }, { 3002000000ULL, LOW  },
+    { 3400000000ULL, HIGH }, { 3400400000ULL, LOW  }, { 3401000000ULL, HIGH },
+};
+const uint8_t  BUTTON_SCRIPT_LEN    = sizeof(BUTTON_SCRIPT) / sizeof(BUTTON_SCRIPT[0]);
+const uint64_t BUTTON_SCRIPT_PERIOD = 10 * Sim::NS_PER_S;
+
+// Function prototypes
+void     rtcISR();
+void     timerISR();
+void     buttonStimulus(void * ctx);
+void     drawText(uint8_t col, uint8_t page, const char * str, uint8_t * dirty_start, uint8_t * dirty_end);
+void     tickerRun(uint32_t hz, uint32_t lines);
+uint32_t option(int argc, char ** argv, const char * name, uint32_t fallback);
+void     report(const char * key, uint64_t val);
+
+int main(int argc, char ** argv)
+{
+    uint32_t seconds        = option(argc, argv, "--seconds", 60);
+    uint32_t i2c_hz         = option(argc, argv, "--i2c-hz", I2C_BAUDRATE);
+    uint32_t previous_tick  = 0;
+    uint32_t loops          = 0;
+    uint32_t loop_min_us    = 0xFFFFFFFF;
+    uint32_t loop_max_us    = 0;
+    uint64_t loop_total_us  = 0;
+    uint32_t button_events  = 0;
+    uint32_t eeprom_read_us = 0;
+    uint64_t oled_push_us   = 0;
+    uint32_t oled_pushes    = 0;
+    uint16_t val            = 0;
+    char     text[22];
+
+    // Board assembly
+    board.attach();
+    Sim::uart().setEcho(false);
+    Sim::schedule(BUTTON_SCRIPT[0].offset_ns, buttonStimulus, nullptr);
+
+    // Bus initialization
+    serial_bus.init(SERIAL_BAUDRATE);
+#if defined(HAL_UART1_PORT)
+    telemetry_bus.init(SERIAL_BAUDRATE);
+#endif
+    i2c_bus.init(i2c_hz);
+#if defined(HAL_I2C1_SERCOM)
+    oled_bus.init(i2c_hz);
+#endif
+    spi_bus.init(SPI_BAUDRATE);
+
+    for (uint8_t channel = 0; channel < Sim::I2C_CHANNELS; ++channel)
+    {
+        Sim::BusTiming timing = Sim::i2c(channel).timing();
+
+        timing.transaction_ns = option(argc, argv, "--i2c-txn-ns", timing.transaction_ns);
+        timing.byte_ns        = option(argc, argv, "--i2c-byte-ns", timing.byte_ns);
+        timing.switch_ns      = option(argc, argv, "--i2c-switch-ns", timing.switch_ns);
+        Sim::i2c(channel).setTiming(timing);
+    }
+
+    {
+        uint32_t device_hz = option(argc, argv, "--device-hz", DEVICE_I2C_CLOCK);
+
+        oled_bus.setDeviceClock(OLED_SCREEN_ADDRESS, option(argc, argv, "--oled-hz", OLED_I2C_CLOCK));
+        i2c_bus.setDeviceClock(EEPROM_ADDRESS, option(argc, argv, "--eeprom-hz", EEPROM_I2C_CLOCK));
+        i2c_bus.setDeviceClock(RTC_ADDRESS, device_hz);
+        i2c_bus.setDeviceClock(Sim::BOARD_HTU21D_ADDR, device_hz);
+        i2c_bus.setDeviceClock(Sim::BOARD_EXPANDER_ADDR, device_hz);
+    }
+
+    HAL::delay_ms(10);
+
+    // Peripheral initialization
+    button.init();
+    eeprom_cache.init();
+    segments.init();
+
+    // RTC time read once at boot, then 1 Hz square wave enabled and counted
+    {
+        uint8_t regs[7];
+        i2c_bus.writeRead(RTC_ADDRESS, (uint8_t)0x00, regs, (uint32_t)sizeof(regs));
+        i2c_bus.write(RTC_ADDRESS, (uint8_t)0x0E, (uint8_t)0x00);
+    }
+
+    rtc_sqw.pinMode(GPIO_INPUT_PULLUP);
+    rtc_sqw.attachInterrupt(rtcISR, GPIO_FALLING);
+
+    sensor_log.mount();
+
+    // Configuration region read, as the target loads it at boot
+    {
+        uint8_t  config[256];
+        uint32_t start = HAL::micros();
+
+        eeprom_cache.read(0, config, sizeof(config));
+        eeprom_read_us = HAL::micros() - start;
+    }
+
+    // Horizontal addressing, as the SSD1306 driver leaves the panel
+    {
+        const uint8_t mode[] = { 0x20, 0x00 };
+        oled.command(mode, sizeof(mode));
+    }
+
+    Sim::i2c(0).clearStats();
+    Sim::i2c(1).clearStats();
+    Sim::spi(0).clearStats();
+    Sim::spi(1).clearStats();
+
+    // Timer initialization
+    timer.init(TIMER_PERIOD_US);
+    timer.attachInterrupt(timerISR);
+    timer.start();
+
+    while (HAL::millis() < seconds * 1000UL)
+    {
+        uint32_t start = HAL::micros();
+        uint32_t tick  = rtc_seconds;
+        uint32_t elapsed;
+
+        timer.stop();
+        sensor.service();
+        timer.start();
+        HAL::delay_ms(80);
+
+        button.service();
+        segments.write(val);
+
+        if (tick != previous_tick)
+        {
+            uint8_t                   dirty_start[8];
+            uint8_t                   dirty_end[8];
+            Demo::ButtonEvents::Event events[4];
+            uint8_t                   n_events;
+            uint32_t                  push_start;
+            Demo::LogRecord           record = { RTC_START_EPOCH + tick, sensor.getTemperature(),
+                                                 sensor.getHumidity() };
+
+            previous_tick = tick;
+
+            timer.stop();
+            sensor_log.append(record);
+            eeprom_cache.service();
+            timer.start();
+
+            while (0 != (n_events = button.popBatch(events, 4)))
+                button_events += n_events;
+
+            // Time, temperature and humidity fields, pushed as dirty column spans per page
+            memset(dirty_start, 0xFF, sizeof(dirty_start));
+            memset(dirty_end, 0, sizeof(dirty_end));
+
+            Demo::formatUnsigned(text, tick, 8);
+            drawText(72, 1, text, dirty_start, dirty_end);
+            Demo::formatFixed(text, sensor.getTemperature(), 2, 6);
+            drawText(0, 2, text, dirty_start, dirty_end);
+            Demo::formatFixed(text, sensor.getHumidity(), 2, 6);
+            drawText(66, 2, text, dirty_start, dirty_end);
+
+            if (OLED_SHARES_BUS) timer.stop();
+            push_start = HAL::micros();
+            for (uint8_t page = 0; page < 8; ++page)
+            {
+                if (dirty_start[page] <= dirty_end[page])
+                    oled.writeWindow(frame, dirty_start[page], dirty_end[page], page, page);
+            }
+            oled_push_us += HAL::micros() - push_start;
+            ++oled_pushes;
+            if (OLED_SHARES_BUS) timer.start();
+        }
+        else
+        {
+            HAL::delay_ms(20);
+        }
+
+        ++val;
+
+        elapsed        = HAL::micros() - start;
+        loop_total_us += elapsed;
+        loop_min_us    = (elapsed < loop_min_us) ? elapsed : loop_min_us;
+        loop_max_us    = (elapsed > loop_max_us) ? elapsed : loop_max_us;
+        ++loops;
+    }
+
+    timer.stop();
+
+    report("sim_ms", HAL::millis());
+    report("loops", loops);
+    report("loop_min_us", loop_min_us);
+    report("loop_mean_us", loops ? loop_total_us / loops : 0);
+    report("loop_max_us", loop_max_us);
+    report("timer_isrs", Sim::timerCount());
+    report("rtc_ticks", rtc_seconds);
+    report("i2c_hz", i2c_hz);
+    report("i2c_clock_switches", i2c_bus.clockSwitches());
+    report("i2c_switch_us", ((uint64_t)i2c_bus.clockSwitchCycles() * 1000000) / HAL::cpuFrequency());
+    report("i2c_transactions", Sim::i2c().stats().transactions);
+    report("i2c_bytes", Sim::i2c().stats().bytes);
+    report("i2c_nacks", Sim::i2c().stats().nacks);
+    report("i2c_busy_us", Sim::i2c().stats().busy_ns / Sim::NS_PER_US);
+    report("i2c_busy_permille", (Sim::i2c().stats().busy_ns * 1000) / (Sim::now() ? Sim::now() : 1));
+#if defined(HAL_I2C1_SERCOM)
+    report("i2c1_clock_switches", oled_bus.clockSwitches());
+    report("i2c1_transactions", Sim::i2c(1).stats().transactions);
+    report("i2c1_bytes", Sim::i2c(1).stats().bytes);
+    report("i2c1_busy_us", Sim::i2c(1).stats().busy_ns / Sim::NS_PER_US);
+    report("i2c1_busy_permille", (Sim::i2c(1).stats().busy_ns * 1000) / (Sim::now() ? Sim::now() : 1));
+#endif
+    report("spi_bytes", Sim::spi().stats().bytes);
+    report("spi_busy_us", Sim::spi().stats().busy_ns / Sim::NS_PER_US);
+#if defined(HAL_SPI1_SERCOM)
+    report("spi1_bytes", Sim::spi(1).stats().bytes);
+    report("spi1_busy_us", Sim::spi(1).stats().busy_ns / Sim::NS_PER_US);
+#endif
+    report("oled_data_bytes", board.oled.dataBytes());
+    report("oled_push_mean_us", oled_pushes ? oled_push_us / oled_pushes : 0);
+    report("eeprom_read_256_us", eeprom_read_us);
+    report("oled_command_bytes", board.oled.commandBytes());
+    report("eeprom_write_cycles", board.eeprom.writeCycles());
+    report("eeprom_cache_ack_polls", eeprom_cache.stats().ack_polls);
+    report("log_pages", sensor_log.pages());
+    report("sensor_conversions", board.sensor.conversions());
+    report("button_events", button_events);
+    report("button_overflows", button.overflows());
+    report("sreg_latches", board.sreg.latches());
+
+    // Ticker line rate against the OLED clock
+    display.begin(SSD1306_SWITCHCAPVCC, OLED_SCREEN_ADDRESS);
+    display.setTextColor(SSD1306_WHITE);
+
+    for (uint8_t iter = 0; iter < sizeof(TICKER_CLOCKS) / sizeof(TICKER_CLOCKS[0]); ++iter)
+        tickerRun(TICKER_CLOCKS[iter], option(argc, argv, "--ticker-lines", 64));
+
+#if defined(HAL_TRACE) || defined(HAL_BUS_STATS)
+    Sim::uart(TELEMETRY_UART_CHANNEL).setEcho(true);
+#endif
+
+#if defined(HAL_BUS_STATS)
+    // Bus time per device over the run
+    HAL::busStatsDump(telemetry_bus);
+#endif
+
+#if defined(HAL_TRACE)
+    // Most recent bus transactions, for tools/trace-convert.py
+    HAL::traceDump(telemetry_bus);
+#endif
+
+    return 0;
+}
+
+// RTC square wave falling edge callback
+void rtcISR()
+{
+    rtc_seconds = rtc_seconds + 1;
+}
+
+// Timer expiration callback
+void timerISR()
+{
+    segments.refresh();
+}
+
+// Apply the next button script level and schedule the one after it
+void buttonStimulus(void * ctx)
+{
+    static uint8_t  index = 0;
+    static uint64_t base  = 0;
+
+    (void)ctx;
+
+    Sim::pinDrive(BUTTON_PIN, BUTTON_SCRIPT[index].level);
+
+    if (++index == BUTTON_SCRIPT_LEN)
+    {
+        index = 0;
+        base += BUTTON_SCRIPT_PERIOD;
+    }
+
+    Sim::schedule(base + BUTTON_SCRIPT[index].offset_ns, buttonStimulus, nullptr);
+}
+
+// Render text into the frame buffer as one column pattern per character, widening per-page dirty spans
+void drawText(uint8_t col, uint8_t page, const char * str, uint8_t * dirty_start, uint8_t * dirty_end)
+{
+    for (; ('\0' != *str) && (col + 6 <= OLED_SCREEN_WIDTH); ++str, col += 6)
+    {
+        uint8_t * cell = &frame[(uint16_t)page * OLED_SCREEN_WIDTH + col];
+
+        if ((cell[0] == (uint8_t)*str) && (0 == cell[5])) continue;
+
+        memset(cell, (uint8_t)*str, 5);
+        cell[5] = 0;
+
+        if (col < dirty_start[page]) dirty_start[page] = col;
+        if (col + 5 > dirty_end[page]) dirty_end[page] = col + 5;
+    }
+}
+
+// Stream lines through the ticker at one OLED clock, then the same lines as whole frame pushes
+void tickerRun(uint32_t hz, uint32_t lines)
+{
+    char     key[48];
+    char     text[22];
+    uint64_t start;
+    uint64_t ticker_ns;
+    uint64_t frame_ns;
+    uint8_t  errors = 0;
+
+    oled_bus.setDeviceClock(OLED_SCREEN_ADDRESS, hz);
+    errors += (0 != ticker.begin());
+
+    start = Sim::now();
+    for (uint32_t line = 0; line < lines; ++line)
+    {
+        snprintf(text, sizeof(text), "Line %lu", (unsigned long)line);
+        errors += (0 != ticker.println(text));
+    }
+    ticker_ns = Sim::now() - start;
+
+    errors += (0 != ticker.end());
+
+    start = Sim::now();
+    for (uint32_t line = 0; line < lines; ++line)
+    {
+        errors += (0 != oled.writeWindow(display.getBuffer(), 0, OLED_SCREEN_WIDTH - 1, 0,
+                                         OLED_SCREEN_HEIGHT / 8 - 1));
+    }
+    frame_ns = Sim::now() - start;
+
+    snprintf(key, sizeof(key), "ticker_%lu_khz_lines_per_s", (unsigned long)(hz / 1000));
+    report(key, ticker_ns ? ((uint64_t)lines * Sim::NS_PER_S) / ticker_ns : 0);
+    snprintf(key, sizeof(key), "ticker_%lu_khz_full_frame_lines_per_s", (unsigned long)(hz / 1000));
+    report(key, frame_ns ? ((uint64_t)lines * Sim::NS_PER_S) / frame_ns : 0);
+    snprintf(key, sizeof(key), "ticker_%lu_khz_errors", (unsigned long)(hz / 1000));
+    report(key, errors);
+}
+
+// Parse "--name value" from the command line
+uint32_t option(int argc, char ** argv, const char * name, uint32_t fallback)
+{
+    for (int iter = 1; iter + 1 < argc; ++iter)
+    {
+        if (0 == strcmp(argv[iter], name))
+            return (uint32_t)strtoul(argv[iter + 1], nullptr, 0);
+    }
+
+    return fallback;
+}
+
+// Print one result
+void report(const char * key, uint64_t val)
+{
+    printf("%s=%llu\n", key, (unsigned long long)val);
+}
+
+// EOF
@@ -0,0 +1,42 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : mcp23008.cpp
+// Purpose     : Native Stand-In for the MCP23008 I/O Expander Driver
+// Description : This source file implements header file mcp23008.h.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "mcp23008.h"
+
+namespace PeripheralIO
+{
+
+MCP23008::MCP23008(HAL::I2C& i2c_bus, uint8_t addr)
+: _i2c(i2c_bus)
+, _addr(addr)
+{ }
+
+uint8_t MCP23008::read(uint8_t reg)
+{
+    uint8_t val = 0;
+
+    _i2c.writeRead(_addr, reg, &val);
+
+    return val;
+}
+
+void MCP23008::write(uint8_t reg, uint8_t val)
+{
+    _i2c.write(_addr, reg, val);
+}
+
+void MCP23008::write(uint8_t val)
+{
+    write(MCP23008_GPIO, val);
+}
+
+}
+
+// EOF
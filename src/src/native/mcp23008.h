@@ -0,0 +1,68 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : mcp23008.h
+// Purpose     : Native Stand-In for the MCP23008 I/O Expander Driver
+// Description :
+//               This header stands in for the mcp23008 library when the HAL is built for the native host backend,
+//               so that hal-gpioport.cpp is compiled unchanged. It makes the same bus traffic as the driver: a
+//               register write is one I2C write of register and value, a register read a write of the register
+//               followed by a repeated start read of one byte.
+//
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : hal.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _NATIVE_MCP23008_H
+#define _NATIVE_MCP23008_H
+
+#include "hal.h"
+
+namespace PeripheralIO
+{
+
+// Registers used by the HAL
+static const uint8_t MCP23008_IODIR = 0x00;
+static const uint8_t MCP23008_GPIO  = 0x09;
+
+class MCP23008
+{
+    public:
+        /**
+         * @brief Constructor for MCP23008 object
+         * @param i2c_bus I2C bus of the expander
+         * @param addr Expander I2C address
+        */
+        MCP23008(HAL::I2C& i2c_bus, uint8_t addr);
+
+        /**
+         * @brief Read a register
+         * @param reg Register address, the port register by default
+         * @return Register value; 0 if the read failed
+        */
+        uint8_t read(uint8_t reg=MCP23008_GPIO);
+
+        /**
+         * @brief Write a register
+         * @param reg Register address
+         * @param val Register value
+        */
+        void write(uint8_t reg, uint8_t val);
+
+        /**
+         * @brief Write the port register
+         * @param val Port value
+        */
+        void write(uint8_t val);
+
+    private:
+        HAL::I2C& _i2c;
+        uint8_t   _addr;
+};
+
+}
+
+#endif // _NATIVE_MCP23008_H
+
+// EOF
@@ -0,0 +1,211 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : samplering-main.cpp
+// Purpose     : Native Sample Ring Scenarios
+// Description : This main source file pushes synthetic data through HAL::SampleRing (hal-samplering.h) and checks
+//               every statistic after every push against a brute-force recomputation over the same samples:
+//
+//                 constant   a single value; the wedges hold one entry each
+//                 ramp_up    rising values; the minimum wedge fills to the window, the maximum holds one entry
+//                 ramp_down  falling values; the converse of ramp_up
+//                 sawtooth   a rise over the window then a drop below it; each drop empties a full wedge, the
+//                            O(N) worst case of a single push
+//                 sine       a slow sine of full 12 bit swing
+//                 noise      uniform pseudo-random values from a linear congruential generator
+//
+//               Each pattern runs with the window of the application (8 samples) and with a longer one (64).
+//
+//               Options: --samples N  samples pushed per pattern and window (default 10000)
+//                        --seed N     noise generator seed (default 1)
+//
+//               Results are printed one key=value pair per line, as by the native workload; any nonzero
+//               *_mismatches count fails the run. Build and run with `pio run -e native_samplering -t exec`.
+// Platform    : Native
+// Framework   : Simulation
+// Language    : C++
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hal-samplering.h"
+
+// Sample ring settings under test: EWMA weight 1/8, history of 8 block means
+const uint8_t  EWMA_SHIFT   = 3;
+const uint16_t HISTORY      = 8;
+
+// Sine pattern: amplitude and period in samples
+const int16_t  SINE_AMPLITUDE = 2047;
+const uint32_t SINE_PERIOD    = 360;
+
+// Samples retained for the brute-force reference
+const uint32_t MAX_SAMPLES  = 100000;
+
+// Synthetic data patterns
+enum Pattern { CONSTANT, RAMP_UP, RAMP_DOWN, SAWTOOTH, SINE, NOISE, PATTERNS };
+
+static const char * const PATTERN_NAMES[PATTERNS] =
+{
+    "constant", "ramp_up", "ramp_down", "sawtooth", "sine", "noise"
+};
+
+// Every sample pushed so far, for the reference
+static int16_t samples[MAX_SAMPLES];
+
+// Noise generator state
+static uint32_t noise_state = 1;
+
+// Function prototypes
+int16_t  sample(Pattern pattern, uint32_t index, uint16_t window);
+uint32_t option(int argc, char ** argv, const char * name, uint32_t fallback);
+void     report(const char * prefix, const char * key, uint64_t val);
+
+template <uint16_t N>
+uint32_t run(Pattern pattern, uint32_t count);
+
+int main(int argc, char ** argv)
+{
+    uint32_t count      = option(argc, argv, "--samples", 10000);
+    uint32_t seed       = option(argc, argv, "--seed", 1);
+    uint32_t mismatches = 0;
+
+    if (count > MAX_SAMPLES) count = MAX_SAMPLES;
+
+    for (uint8_t pattern = 0; pattern < PATTERNS; ++pattern)
+    {
+        noise_state  = seed;
+        mismatches  += run<8>((Pattern)pattern, count);
+        noise_state  = seed;
+        mismatches  += run<64>((Pattern)pattern, count);
+    }
+
+    report("total", "mismatches", mismatches);
+
+    return mismatches ? 1 : 0;
+}
+
+// Push one pattern through a ring of window N, checking each statistic after each push
+template <uint16_t N>
+uint32_t run(Pattern pattern, uint32_t count)
+{
+    HAL::SampleRing<int16_t, N, HISTORY> ring(EWMA_SHIFT);
+    char     prefix[32];
+    uint32_t mean_mismatches    = 0;
+    uint32_t extreme_mismatches = 0;
+    uint32_t ewma_mismatches    = 0;
+    uint32_t history_mismatches = 0;
+    int32_t  ewma               = 0;
+
+    snprintf(prefix, sizeof(prefix), "%s_n%u", PATTERN_NAMES[pattern], (unsigned)N);
+
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        uint32_t first = (index + 1 > N) ? (index + 1 - N) : 0;
+        int32_t  sum   = 0;
+        int16_t  lo;
+        int16_t  hi;
+
+        samples[index] = sample(pattern, index, N);
+        ring.push(samples[index]);
+
+        // Window statistics recomputed from scratch
+        lo = hi = samples[first];
+        for (uint32_t iter = first; iter <= index; ++iter)
+        {
+            sum += samples[iter];
+            if (samples[iter] < lo) lo = samples[iter];
+            if (samples[iter] > hi) hi = samples[iter];
+        }
+
+        if ((ring.count() != index + 1 - first) || (ring.sum() != sum) || (ring.latest() != samples[index]) ||
+            (ring.mean() != (int16_t)(sum / (int32_t)(index + 1 - first))))
+            ++mean_mismatches;
+
+        if ((ring.min() != lo) || (ring.max() != hi))
+            ++extreme_mismatches;
+
+        // EWMA scaled by 2^shift and seeded with the first sample, as documented
+        ewma = index ? (ewma + samples[index] - (ewma >> EWMA_SHIFT)) : ((int32_t)samples[index] << EWMA_SHIFT);
+        if (ring.ewma() != (int16_t)(ewma >> EWMA_SHIFT))
+            ++ewma_mismatches;
+
+        // History: the mean of each completed block of N samples, most recent first
+        if (ring.historyCount() != (((index + 1) / N < HISTORY) ? (index + 1) / N : HISTORY))
+        {
+            ++history_mismatches;
+            continue;
+        }
+
+        for (uint16_t age = 0; age < ring.historyCount(); ++age)
+        {
+            uint32_t block = (index + 1) / N - 1 - age;
+            int32_t  total = 0;
+
+            for (uint32_t iter = block * N; iter < (block + 1) * N; ++iter)
+                total += samples[iter];
+
+            if (ring.history(age) != (int16_t)(total / (int32_t)N))
+            {
+                ++history_mismatches;
+                break;
+            }
+        }
+    }
+
+    report(prefix, "samples", count);
+    report(prefix, "mean_mismatches", mean_mismatches);
+    report(prefix, "extreme_mismatches", extreme_mismatches);
+    report(prefix, "ewma_mismatches", ewma_mismatches);
+    report(prefix, "history_mismatches", history_mismatches);
+
+    return mean_mismatches + extreme_mismatches + ewma_mismatches + history_mismatches;
+}
+
+// Sample of a pattern at an index, for a ring of the given window
+int16_t sample(Pattern pattern, uint32_t index, uint16_t window)
+{
+    switch (pattern)
+    {
+        case RAMP_UP:
+            return (int16_t)((index % 4096) - 2048);
+
+        case RAMP_DOWN:
+            return (int16_t)(2047 - (index % 4096));
+
+        case SAWTOOTH:
+            // Rises for a whole window, so both wedges span it, then drops below every queued sample
+            return ((index % (window + 1)) == window) ? -2048 : (int16_t)(index % (window + 1));
+
+        case SINE:
+            return (int16_t)lround(SINE_AMPLITUDE * sin((2.0 * M_PI * (index % SINE_PERIOD)) / SINE_PERIOD));
+
+        case NOISE:
+            noise_state = (noise_state * 1103515245u) + 12345u;
+            return (int16_t)(((noise_state >> 16) % 4096) - 2048);
+
+        case CONSTANT:
+        default:
+            return 1000;
+    }
+}
+
+// Parse "--name value" from the command line
+uint32_t option(int argc, char ** argv, const char * name, uint32_t fallback)
+{
+    for (int iter = 1; iter + 1 < argc; ++iter)
+    {
+        if (0 == strcmp(argv[iter], name))
+            return (uint32_t)strtoul(argv[iter + 1], nullptr, 0);
+    }
+
+    return fallback;
+}
+
+// Print one result
+void report(const char * prefix, const char * key, uint64_t val)
+{
+    printf("%s_%s=%llu\n", prefix, key, (unsigned long long)val);
+}
+
+// EOF
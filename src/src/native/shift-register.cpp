@@ -0,0 +1,36 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : shift-register.cpp
+// Purpose     : Native Stand-In for the 74HC595 Shift Register Driver
+// Description : This source file implements header file shift-register.h.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "shift-register.h"
+
+namespace PeripheralIO
+{
+
+ShiftRegister::ShiftRegister(HAL::SPI& spi_bus, uint8_t latch_pin)
+: _spi(spi_bus)
+, _latch(latch_pin)
+{ }
+
+void ShiftRegister::init()
+{
+    _latch.pinMode(GPIO_OUTPUT);
+    _latch.digitalWrite(HIGH);
+}
+
+void ShiftRegister::write(uint8_t val)
+{
+    _latch.digitalWrite(LOW);
+    _spi.transfer(val);
+    _latch.digitalWrite(HIGH);
+}
+
+}
+
+// EOF
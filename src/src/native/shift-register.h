@@ -0,0 +1,54 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : shift-register.h
+// Purpose     : Native Stand-In for the 74HC595 Shift Register Driver
+// Description :
+//               This header stands in for the shift-register library when the HAL is built for the native host
+//               backend, so that hal-gpioport.cpp is compiled unchanged. It makes the same bus traffic as the
+//               driver: each write is one SPI byte framed by the latch pin.
+//
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : hal.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _NATIVE_SHIFT_REGISTER_H
+#define _NATIVE_SHIFT_REGISTER_H
+
+#include "hal.h"
+
+namespace PeripheralIO
+{
+
+class ShiftRegister
+{
+    public:
+        /**
+         * @brief Constructor for ShiftRegister object
+         * @param spi_bus SPI bus of the register
+         * @param latch_pin Storage register clock pin
+        */
+        ShiftRegister(HAL::SPI& spi_bus, uint8_t latch_pin);
+
+        /**
+         * @brief Configure the latch pin, idle high
+        */
+        void init();
+
+        /**
+         * @brief Shift a byte in and latch it to the outputs
+         * @param val Output value
+        */
+        void write(uint8_t val);
+
+    private:
+        HAL::SPI& _spi;
+        HAL::GPIO _latch;
+};
+
+}
+
+#endif // _NATIVE_SHIFT_REGISTER_H
+
+// EOF
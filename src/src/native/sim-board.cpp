@@ -0,0 +1,40 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : sim-board.cpp
+// Purpose     : Native Board Simulator Assembly
+// Description : This source file implements header file sim-board.h.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "sim-board.h"
+
+namespace Sim
+{
+
+Board::Board(uint32_t rtc_epoch)
+: eeprom(BOARD_EEPROM_ADDR, BOARD_EEPROM_WP_PIN)
+, rtc(BOARD_RTC_ADDR, BOARD_RTC_SQW_PIN, rtc_epoch)
+, sensor(BOARD_HTU21D_ADDR)
+, oled(BOARD_OLED_ADDR)
+, expander(BOARD_EXPANDER_ADDR)
+, sreg(BOARD_SREG_LATCH_PIN, BOARD_SREG_CHAIN)
+{ }
+
+void Board::attach()
+{
+    i2c().attach(eeprom);
+    i2c().attach(rtc);
+    i2c().attach(sensor);
+    i2c(BOARD_OLED_CHANNEL).attach(oled);
+    i2c().attach(expander);
+    spi(BOARD_SREG_CHANNEL).attach(sreg);
+
+    // External pull-up on the active low button
+    pinDrive(BOARD_BUTTON_PIN, HIGH);
+}
+
+}
+
+// EOF
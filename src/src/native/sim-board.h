@@ -0,0 +1,82 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : sim-board.h
+// Purpose     : Native Board Simulator Assembly
+// Description :
+//               This board assembles the simulated devices as they are wired on the reference schematic, so that
+//               every native program (application workload, benchmarks) runs against the same hardware.
+//
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : sim.h, sim-devices.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _SIM_BOARD_H
+#define _SIM_BOARD_H
+
+#include "Arduino.h"
+#include "sim.h"
+#include "sim-devices.h"
+
+namespace Sim
+{
+
+// Board wiring
+static const uint8_t  BOARD_RTC_SQW_PIN     = PIN_A0;
+static const uint8_t  BOARD_SREG_LATCH_PIN  = PIN_A2;
+static const uint8_t  BOARD_EEPROM_WP_PIN   = PIN_A6;
+static const uint8_t  BOARD_BUTTON_PIN      = PIN_A7;
+static const uint8_t  BOARD_EXPANDER_ADDR   = 0x20;
+static const uint8_t  BOARD_OLED_ADDR       = 0x3C;
+static const uint8_t  BOARD_HTU21D_ADDR     = 0x40;
+static const uint8_t  BOARD_EEPROM_ADDR     = 0x50;
+static const uint8_t  BOARD_RTC_ADDR        = 0x68;
+static const uint32_t BOARD_RTC_EPOCH       = 1704067200; // 2024-01-01 00:00:00
+
+// OLED bus: the second I2C channel when the build maps one (HAL_I2C1_SERCOM), as on target
+#if defined(HAL_I2C1_SERCOM)
+static const uint8_t  BOARD_OLED_CHANNEL    = 1;
+#else
+static const uint8_t  BOARD_OLED_CHANNEL    = 0;
+#endif
+
+// Shift register bus: the second SPI channel when the build maps one (HAL_SPI1_SERCOM), as on target
+#if defined(HAL_SPI1_SERCOM)
+static const uint8_t  BOARD_SREG_CHANNEL    = 1;
+#else
+static const uint8_t  BOARD_SREG_CHANNEL    = 0;
+#endif
+
+#if defined(HAL_SEG_SELECT_SR)
+static const uint8_t  BOARD_SREG_CHAIN      = 2;
+#else
+static const uint8_t  BOARD_SREG_CHAIN      = 1;
+#endif
+
+struct Board
+{
+    /**
+     * @brief Constructor for Board object
+     * @param rtc_epoch Unix time of the RTC at virtual time zero
+    */
+    Board(uint32_t rtc_epoch=BOARD_RTC_EPOCH);
+
+    /**
+     * @brief Attach devices to the simulated buses and apply board-level pull-ups
+    */
+    void attach();
+
+    EEPROM24         eeprom;
+    DS3232           rtc;
+    HTU21D           sensor;
+    SSD1306          oled;
+    MCP23008         expander;
+    ShiftRegister595 sreg;
+};
+
+}
+
+#endif // _SIM_BOARD_H
+
+// EOF
@@ -0,0 +1,695 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : sim-devices.cpp
+// Purpose     : Native Board Simulator Devices
+// Description : This source file implements header file sim-devices.h.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <string.h>
+#include "Arduino.h"
+#include "sim-devices.h"
+
+namespace Sim
+{
+
+// DS3232 registers
+static const uint8_t  DS3232_CONTROL      = 0x0E;
+static const uint8_t  DS3232_STATUS       = 0x0F;
+static const uint8_t  DS3232_TEMP_MSB     = 0x11;
+static const uint8_t  DS3232_TEMP_LSB     = 0x12;
+static const uint8_t  DS3232_SQW_MASK     = 0x1C; // INTCN, RS2, RS1 all clear selects 1 Hz square wave
+static const uint64_t DS3232_HALF_PERIOD  = NS_PER_S / 2;
+
+// HTU21D commands
+static const uint8_t  HTU21D_TEMP_HOLD    = 0xE3;
+static const uint8_t  HTU21D_HUMID_HOLD   = 0xE5;
+static const uint8_t  HTU21D_TEMP_NOHOLD  = 0xF3;
+static const uint8_t  HTU21D_HUMID_NOHOLD = 0xF5;
+static const uint8_t  HTU21D_READ_USER    = 0xE7;
+static const uint8_t  HTU21D_SOFT_RESET   = 0xFE;
+static const uint64_t HTU21D_RESET_TIME   = 15 * NS_PER_MS;
+
+// MCP23008 registers
+static const uint8_t  MCP23008_IODIR      = 0x00;
+static const uint8_t  MCP23008_GPIO       = 0x09;
+static const uint8_t  MCP23008_OLAT       = 0x0A;
+
+static uint8_t toBCD(uint8_t val)
+{
+    return (uint8_t)(((val / 10) << 4) | (val % 10));
+}
+
+static uint8_t fromBCD(uint8_t val)
+{
+    return (uint8_t)((val >> 4) * 10 + (val & 0x0F));
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date, and its inverse
+static int32_t daysFromCivil(int32_t year, uint32_t month, uint32_t day)
+{
+    year -= (month <= 2);
+
+    int32_t  era = (year >= 0 ? year : year - 399) / 400;
+    uint32_t yoe = (uint32_t)(year - era * 400);
+    uint32_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+static void civilFromDays(int32_t days, int32_t * year, uint32_t * month, uint32_t * day)
+{
+    days += 719468;
+
+    int32_t  era = (days >= 0 ? days : days - 146096) / 146097;
+    uint32_t doe = (uint32_t)(days - era * 146097);
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp  = (5 * doy + 2) / 153;
+
+    *day   = doy - (153 * mp + 2) / 5 + 1;
+    *month = (mp < 10) ? mp + 3 : mp - 9;
+    *year  = (int32_t)yoe + era * 400 + (*month <= 2);
+}
+
+static uint8_t crc8(const uint8_t * data, uint8_t len)
+{
+    uint8_t crc = 0;
+
+    for (uint8_t iter = 0; iter < len; ++iter)
+    {
+        crc ^= data[iter];
+        for (uint8_t bit = 0; bit < 8; ++bit)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+    }
+
+    return crc;
+}
+
+EEPROM24::EEPROM24(uint8_t address, uint8_t wp_pin)
+: I2CDevice(address)
+, _memory()
+, _page()
+, _page_mask(0)
+, _wp_pin(wp_pin)
+, _pointer(0)
+, _rx_count(0)
+, _ready_ns(0)
+, _write_cycles(0)
+{
+    memset(_memory, 0xFF, sizeof(_memory));
+}
+
+bool EEPROM24::start(bool read)
+{
+    // Address is not acknowledged during the internal write cycle
+    if (now() < _ready_ns) return false;
+
+    if (!read)
+    {
+        _rx_count  = 0;
+        _page_mask = 0;
+    }
+
+    return true;
+}
+
+bool EEPROM24::write(uint8_t val)
+{
+    if (0 == _rx_count)
+    {
+        _pointer = (uint16_t)((val << 8) & (SIZE - 1));
+    }
+    else if (1 == _rx_count)
+    {
+        _pointer |= val;
+    }
+    else
+    {
+        // Data rolls over within the addressed page
+        uint8_t offset = (uint8_t)((_pointer + _rx_count - 2) & (PAGE_SIZE - 1));
+
+        _page[offset]  = val;
+        _page_mask    |= (1ULL << offset);
+    }
+
+    ++_rx_count;
+
+    return true;
+}
+
+uint8_t EEPROM24::read()
+{
+    uint8_t val = _memory[_pointer];
+
+    _pointer = (uint16_t)((_pointer + 1) & (SIZE - 1));
+
+    return val;
+}
+
+void EEPROM24::stop()
+{
+    uint16_t base = _pointer & ~(uint16_t)(PAGE_SIZE - 1);
+
+    if ((0 != _page_mask) && (LOW == pinRead(_wp_pin)))
+    {
+        for (uint8_t offset = 0; offset < PAGE_SIZE; ++offset)
+        {
+            if (_page_mask & (1ULL << offset))
+                _memory[base + offset] = _page[offset];
+        }
+
+        _ready_ns = now() + WRITE_CYCLE;
+        ++_write_cycles;
+    }
+
+    _rx_count  = 0;
+    _page_mask = 0;
+}
+
+uint8_t * EEPROM24::memory()
+{
+    return _memory;
+}
+
+uint32_t EEPROM24::writeCycles() const
+{
+    return _write_cycles;
+}
+
+DS3232::DS3232(uint8_t address, uint8_t sqw_pin, uint32_t epoch)
+: I2CDevice(address)
+, _regs()
+, _sqw_pin(sqw_pin)
+, _epoch(epoch)
+, _epoch_ns(0)
+, _pointer(0)
+, _rx_count(0)
+, _time_written(false)
+{
+    _regs[DS3232_CONTROL] = 0x1C;
+    _regs[DS3232_STATUS]  = 0x88;
+    setTemperature(2500);
+}
+
+DS3232::~DS3232()
+{
+    cancel(edge, this);
+}
+
+bool DS3232::start(bool read)
+{
+    // Time registers are copied to the user buffer on every start
+    latch();
+
+    if (!read)
+    {
+        _rx_count     = 0;
+        _time_written = false;
+    }
+
+    return true;
+}
+
+bool DS3232::write(uint8_t val)
+{
+    if (0 == _rx_count)
+    {
+        _pointer = val;
+    }
+    else
+    {
+        _regs[_pointer] = val;
+        _time_written  |= (_pointer <= 6);
+        ++_pointer;
+    }
+
+    ++_rx_count;
+
+    return true;
+}
+
+uint8_t DS3232::read()
+{
+    return _regs[_pointer++];
+}
+
+void DS3232::stop()
+{
+    if (_time_written)
+    {
+        uint8_t  hour_reg = _regs[2];
+        uint32_t hour     = (hour_reg & 0x40) ? (fromBCD(hour_reg & 0x1F) % 12) + ((hour_reg & 0x20) ? 12 : 0)
+                                              : fromBCD(hour_reg & 0x3F);
+        int32_t  year     = 2000 + fromBCD(_regs[6]) + ((_regs[5] & 0x80) ? 100 : 0);
+        int32_t  days     = daysFromCivil(year, fromBCD(_regs[5] & 0x1F), fromBCD(_regs[4] & 0x3F));
+
+        // Writing the time resets the countdown chain, so the next second is a full second away
+        _epoch    = (uint32_t)days * 86400UL + hour * 3600UL + fromBCD(_regs[1] & 0x7F) * 60UL
+                    + fromBCD(_regs[0] & 0x7F);
+        _epoch_ns = now();
+        _time_written = false;
+    }
+
+    _rx_count = 0;
+    squareWave();
+}
+
+uint32_t DS3232::time() const
+{
+    return _epoch + (uint32_t)((now() - _epoch_ns) / NS_PER_S);
+}
+
+void DS3232::setTemperature(int16_t centi_c)
+{
+    int16_t quarters = (int16_t)(centi_c / 25);
+
+    _regs[DS3232_TEMP_MSB] = (uint8_t)(quarters >> 2);
+    _regs[DS3232_TEMP_LSB] = (uint8_t)((quarters & 0x03) << 6);
+}
+
+void DS3232::latch()
+{
+    uint32_t t    = time();
+    uint32_t secs = t % 86400UL;
+    int32_t  days = (int32_t)(t / 86400UL);
+    int32_t  year;
+    uint32_t month;
+    uint32_t day;
+
+    civilFromDays(days, &year, &month, &day);
+
+    _regs[0] = toBCD(secs % 60);
+    _regs[1] = toBCD((secs / 60) % 60);
+    _regs[2] = toBCD(secs / 3600);
+    _regs[3] = (uint8_t)(((days + 4) % 7) + 1); // 1970-01-01 was a Thursday; Sunday is 1
+    _regs[4] = toBCD(day);
+    _regs[5] = toBCD(month) | ((year >= 2100) ? 0x80 : 0);
+    _regs[6] = toBCD(year % 100);
+}
+
+void DS3232::squareWave()
+{
+    uint64_t elapsed;
+    uint64_t phase;
+
+    cancel(edge, this);
+
+    if (0 != (_regs[DS3232_CONTROL] & DS3232_SQW_MASK))
+    {
+        pinRelease(_sqw_pin);
+        return;
+    }
+
+    // Output falls as the seconds register increments and is released half a period later
+    elapsed = now() - _epoch_ns;
+    phase   = elapsed % NS_PER_S;
+
+    if (phase < DS3232_HALF_PERIOD)
+    {
+        pinDrive(_sqw_pin, LOW);
+        schedule(now() - phase + DS3232_HALF_PERIOD, edge, this);
+    }
+    else
+    {
+        pinRelease(_sqw_pin);
+        schedule(now() - phase + NS_PER_S, edge, this);
+    }
+}
+
+void DS3232::edge(void * ctx)
+{
+    static_cast<DS3232 *>(ctx)->squareWave();
+}
+
+HTU21D::HTU21D(uint8_t address)
+: I2CDevice(address)
+, _temperature(2000)
+, _humidity(5000)
+, _result()
+, _index(0)
+, _ready_ns(0)
+, _hold(false)
+, _converting(false)
+, _conversions(0)
+{ }
+
+bool HTU21D::start(bool read)
+{
+    // Any address is refused while a no-hold conversion is in progress
+    if (_converting && !_hold && (now() < _ready_ns)) return false;
+
+    if (read) _index = 0;
+
+    return true;
+}
+
+bool HTU21D::write(uint8_t val)
+{
+    switch (val)
+    {
+        case HTU21D_TEMP_HOLD:    convert(false, true);  break;
+        case HTU21D_HUMID_HOLD:   convert(true,  true);  break;
+        case HTU21D_TEMP_NOHOLD:  convert(false, false); break;
+        case HTU21D_HUMID_NOHOLD: convert(true,  false); break;
+
+        case HTU21D_READ_USER:
+            _result[0]  = 0x02;
+            _converting = false;
+            break;
+
+        case HTU21D_SOFT_RESET:
+            _converting = true;
+            _hold       = false;
+            _ready_ns   = now() + HTU21D_RESET_TIME;
+            break;
+
+        default:
+            break;
+    }
+
+    return true;
+}
+
+uint8_t HTU21D::read()
+{
+    uint8_t val = (_index < 3) ? _result[_index] : 0xFF;
+
+    if (_index < 3) ++_index;
+    if (3 == _index) _converting = false;
+
+    return val;
+}
+
+uint64_t HTU21D::stretch()
+{
+    // Hold master mode: SCL is held low until the conversion completes
+    if ((0 == _index) && _converting && _hold && (now() < _ready_ns))
+        return _ready_ns - now();
+
+    return 0;
+}
+
+void HTU21D::setConditions(int16_t temperature, int16_t humidity)
+{
+    _temperature = temperature;
+    _humidity    = humidity;
+}
+
+uint32_t HTU21D::conversions() const
+{
+    return _conversions;
+}
+
+void HTU21D::convert(bool humidity, bool hold)
+{
+    // Inverse of the datasheet conversion formulas, status bits identifying the measurement
+    int32_t raw = humidity ? (((int32_t)_humidity + 600) * 65536) / 12500
+                           : (((int32_t)_temperature + 4685) * 65536) / 17572;
+
+    if (raw < 0)      raw = 0;
+    if (raw > 0xFFFF) raw = 0xFFFF;
+
+    raw = (raw & 0xFFFC) | (humidity ? 0x02 : 0x00);
+
+    _result[0]  = (uint8_t)(raw >> 8);
+    _result[1]  = (uint8_t)raw;
+    _result[2]  = crc8(_result, 2);
+    _index      = 0;
+    _hold       = hold;
+    _converting = true;
+    _ready_ns   = now() + (humidity ? HUMID_CONVERSION : TEMP_CONVERSION);
+    ++_conversions;
+}
+
+SSD1306::SSD1306(uint8_t address)
+: I2CDevice(address)
+, _ram()
+, _cmd()
+, _cmd_len(0)
+, _cmd_need(0)
+, _control(0)
+, _expect_control(true)
+, _mode(2)
+, _col(0), _col_start(0), _col_end(WIDTH - 1)
+, _page(0), _page_start(0), _page_end(PAGES - 1)
+, _start_line(0)
+, _command_bytes(0)
+, _data_bytes(0)
+{ }
+
+bool SSD1306::start(bool read)
+{
+    if (!read) _expect_control = true;
+
+    return true;
+}
+
+bool SSD1306::write(uint8_t val)
+{
+    if (_expect_control)
+    {
+        _control        = val;
+        _expect_control = false;
+        return true;
+    }
+
+    if (_control & 0x40)
+        data(val);
+    else
+        command(val);
+
+    // Continuation bit set: a control byte precedes every data byte
+    if (_control & 0x80) _expect_control = true;
+
+    return true;
+}
+
+const uint8_t * SSD1306::ram() const
+{
+    return _ram;
+}
+
+uint8_t SSD1306::startLine() const
+{
+    return _start_line;
+}
+
+uint32_t SSD1306::commandBytes() const
+{
+    return _command_bytes;
+}
+
+uint32_t SSD1306::dataBytes() const
+{
+    return _data_bytes;
+}
+
+void SSD1306::command(uint8_t val)
+{
+    ++_command_bytes;
+
+    if (0 == _cmd_len)
+    {
+        switch (val)
+        {
+            case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+            case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+                _cmd_need = 1;
+                break;
+            case 0x21: case 0x22: case 0xA3:
+                _cmd_need = 2;
+                break;
+            case 0x29: case 0x2A:
+                _cmd_need = 5;
+                break;
+            case 0x26: case 0x27:
+                _cmd_need = 6;
+                break;
+            default:
+                _cmd_need = 0;
+                break;
+        }
+    }
+
+    _cmd[_cmd_len++] = val;
+
+    if (_cmd_len > _cmd_need) execute();
+}
+
+void SSD1306::execute()
+{
+    uint8_t op = _cmd[0];
+
+    if (0x20 == op)
+    {
+        _mode = _cmd[1] & 0x03;
+    }
+    else if (0x21 == op)
+    {
+        _col_start = _cmd[1] & 0x7F;
+        _col_end   = _cmd[2] & 0x7F;
+        _col       = _col_start;
+    }
+    else if (0x22 == op)
+    {
+        _page_start = _cmd[1] & 0x07;
+        _page_end   = _cmd[2] & 0x07;
+        _page       = _page_start;
+    }
+    else if (op <= 0x0F)
+    {
+        _col = (_col & 0xF0) | op;
+    }
+    else if (op <= 0x1F)
+    {
+        _col = (uint8_t)((_col & 0x0F) | ((op & 0x07) << 4));
+    }
+    else if ((op >= 0x40) && (op <= 0x7F))
+    {
+        _start_line = op & 0x3F;
+    }
+    else if ((op >= 0xB0) && (op <= 0xB7))
+    {
+        _page = op & 0x07;
+    }
+
+    _cmd_len  = 0;
+    _cmd_need = 0;
+}
+
+void SSD1306::data(uint8_t val)
+{
+    _ram[(uint16_t)_page * WIDTH + _col] = val;
+    ++_data_bytes;
+
+    if (0 == _mode) // Horizontal: column first, wrapping within the window
+    {
+        if (_col < _col_end)
+        {
+            ++_col;
+        }
+        else
+        {
+            _col  = _col_start;
+            _page = (_page < _page_end) ? _page + 1 : _page_start;
+        }
+    }
+    else if (1 == _mode) // Vertical: page first, wrapping within the window
+    {
+        if (_page < _page_end)
+        {
+            ++_page;
+        }
+        else
+        {
+            _page = _page_start;
+            _col  = (_col < _col_end) ? _col + 1 : _col_start;
+        }
+    }
+    else // Page: column only, wrapping within the page
+    {
+        _col = (_col + 1) & (WIDTH - 1);
+    }
+}
+
+MCP23008::MCP23008(uint8_t address)
+: I2CDevice(address)
+, _regs()
+, _pointer(0)
+, _pointer_set(false)
+{
+    _regs[MCP23008_IODIR] = 0xFF;
+}
+
+bool MCP23008::start(bool read)
+{
+    if (!read) _pointer_set = false;
+
+    return true;
+}
+
+bool MCP23008::write(uint8_t val)
+{
+    if (!_pointer_set)
+    {
+        _pointer     = val % REGISTERS;
+        _pointer_set = true;
+        return true;
+    }
+
+    // Writing GPIO writes the output latch
+    _regs[(MCP23008_GPIO == _pointer) ? MCP23008_OLAT : _pointer] = val;
+    _pointer = (_pointer + 1) % REGISTERS;
+
+    return true;
+}
+
+uint8_t MCP23008::read()
+{
+    uint8_t val = _regs[_pointer];
+
+    // Output pins read back their latch; inputs are not driven in the simulation
+    if (MCP23008_GPIO == _pointer)
+        val = _regs[MCP23008_OLAT] & ~_regs[MCP23008_IODIR];
+
+    _pointer = (_pointer + 1) % REGISTERS;
+
+    return val;
+}
+
+uint8_t MCP23008::outputs() const
+{
+    return _regs[MCP23008_OLAT];
+}
+
+ShiftRegister595::ShiftRegister595(uint8_t latch_pin, uint8_t chain)
+: _latch_pin(latch_pin)
+, _mask((chain >= 4) ? 0xFFFFFFFFUL : ((1UL << (8 * chain)) - 1))
+, _shift(0)
+, _outputs(0)
+, _latches(0)
+{
+    pinWatch(_latch_pin, this);
+}
+
+ShiftRegister595::~ShiftRegister595()
+{
+    pinWatch(_latch_pin, nullptr);
+}
+
+uint8_t ShiftRegister595::transfer(uint8_t val)
+{
+    // QH' of the last register is not wired back to MISO
+    _shift = ((_shift << 8) | val) & _mask;
+
+    return 0;
+}
+
+void ShiftRegister595::pinChanged(uint8_t pin, uint8_t level)
+{
+    (void)pin;
+
+    if (HIGH == level)
+    {
+        _outputs = _shift;
+        ++_latches;
+    }
+}
+
+uint32_t ShiftRegister595::outputs() const
+{
+    return _outputs;
+}
+
+uint32_t ShiftRegister595::latches() const
+{
+    return _latches;
+}
+
+}
+
+// EOF
@@ -0,0 +1,286 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : sim-devices.h
+// Purpose     : Native Board Simulator Devices
+// Description :
+//               These device models populate the simulated board beneath the native HAL backend. Each reproduces
+//               the bus-visible behavior of its part closely enough for drivers to run unmodified, including the
+//               timing that matters to the application:
+//
+//               AT24C256 EEPROM  - 64-byte page write buffer with rollover, WP pin, 5 ms write cycle during which
+//                                  the address is not acknowledged.
+//               DS3232 RTC       - BCD time registers running from virtual time, 1 Hz open drain square wave on
+//                                  SQW when enabled in the control register, temperature registers.
+//               HTU21D sensor    - hold (clock stretching) and no-hold (address NACK) conversions with datasheet
+//                                  maximum conversion times and CRC.
+//               SSD1306 OLED     - command parser and GDDRAM with horizontal and page addressing windows.
+//               MCP23008         - sequential register file.
+//               74HC595          - SPI shift register chain latched on a GPIO rising edge.
+//
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : sim.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _SIM_DEVICES_H
+#define _SIM_DEVICES_H
+
+#include <stdint.h>
+#include "sim.h"
+
+namespace Sim
+{
+
+class EEPROM24 : public I2CDevice
+{
+    public:
+        static const uint32_t SIZE        = 32768;
+        static const uint8_t  PAGE_SIZE   = 64;
+        static const uint64_t WRITE_CYCLE = 5 * NS_PER_MS;
+
+        /**
+         * @brief Constructor for EEPROM24 object; memory starts erased (0xFF)
+         * @param address Device address
+         * @param wp_pin Write protect pin; writes are accepted while it reads low
+        */
+        EEPROM24(uint8_t address, uint8_t wp_pin);
+
+        bool    start(bool read) override;
+        bool    write(uint8_t val) override;
+        uint8_t read() override;
+        void    stop() override;
+
+        /**
+         * @brief Direct access to memory contents
+         * @return Memory array of SIZE bytes
+        */
+        uint8_t * memory();
+
+        /**
+         * @brief Number of completed page write cycles
+         * @return Write cycles
+        */
+        uint32_t writeCycles() const;
+
+    private:
+        uint8_t  _memory[SIZE];
+        uint8_t  _page[PAGE_SIZE];
+        uint64_t _page_mask;
+        uint8_t  _wp_pin;
+        uint16_t _pointer;
+        uint32_t _rx_count;
+        uint64_t _ready_ns;
+        uint32_t _write_cycles;
+};
+
+class DS3232 : public I2CDevice
+{
+    public:
+        /**
+         * @brief Constructor for DS3232 object; oscillator runs from virtual time zero
+         * @param address Device address
+         * @param sqw_pin Pin to which the open drain SQW/INT output is wired
+         * @param epoch Unix time at virtual time zero
+        */
+        DS3232(uint8_t address, uint8_t sqw_pin, uint32_t epoch);
+        ~DS3232();
+
+        bool    start(bool read) override;
+        bool    write(uint8_t val) override;
+        uint8_t read() override;
+        void    stop() override;
+
+        /**
+         * @brief Current device time
+         * @return Unix time
+        */
+        uint32_t time() const;
+
+        /**
+         * @brief Set die temperature reported in the temperature registers
+         * @param centi_c Temperature in hundredths of a degree Celsius
+        */
+        void setTemperature(int16_t centi_c);
+
+    private:
+        void        latch();
+        void        squareWave();
+        static void edge(void * ctx);
+
+        uint8_t  _regs[256];
+        uint8_t  _sqw_pin;
+        uint32_t _epoch;
+        uint64_t _epoch_ns;
+        uint8_t  _pointer;
+        uint8_t  _rx_count;
+        bool     _time_written;
+};
+
+class HTU21D : public I2CDevice
+{
+    public:
+        static const uint64_t TEMP_CONVERSION  = 50 * NS_PER_MS;
+        static const uint64_t HUMID_CONVERSION = 16 * NS_PER_MS;
+
+        /**
+         * @brief Constructor for HTU21D object
+         * @param address Device address
+        */
+        HTU21D(uint8_t address);
+
+        bool     start(bool read) override;
+        bool     write(uint8_t val) override;
+        uint8_t  read() override;
+        uint64_t stretch() override;
+
+        /**
+         * @brief Set ambient conditions returned by subsequent conversions
+         * @param temperature Temperature in hundredths of a degree Celsius
+         * @param humidity Relative humidity in hundredths of a percent
+        */
+        void setConditions(int16_t temperature, int16_t humidity);
+
+        /**
+         * @brief Number of conversions started
+         * @return Conversion count
+        */
+        uint32_t conversions() const;
+
+    private:
+        void convert(bool humidity, bool hold);
+
+        int16_t  _temperature;
+        int16_t  _humidity;
+        uint8_t  _result[3];
+        uint8_t  _index;
+        uint64_t _ready_ns;
+        bool     _hold;
+        bool     _converting;
+        uint32_t _conversions;
+};
+
+class SSD1306 : public I2CDevice
+{
+    public:
+        static const uint8_t WIDTH = 128;
+        static const uint8_t PAGES = 8;
+
+        /**
+         * @brief Constructor for SSD1306 object
+         * @param address Device address
+        */
+        SSD1306(uint8_t address);
+
+        bool start(bool read) override;
+        bool write(uint8_t val) override;
+
+        /**
+         * @brief Display RAM, one byte per column per page
+         * @return GDDRAM array of WIDTH * PAGES bytes
+        */
+        const uint8_t * ram() const;
+
+        /**
+         * @brief Display start line set by command 0x40-0x7F
+         * @return Start line
+        */
+        uint8_t startLine() const;
+
+        /**
+         * @brief Number of command and argument bytes received
+         * @return Byte count
+        */
+        uint32_t commandBytes() const;
+
+        /**
+         * @brief Number of GDDRAM bytes received
+         * @return Byte count
+        */
+        uint32_t dataBytes() const;
+
+    private:
+        void command(uint8_t val);
+        void execute();
+        void data(uint8_t val);
+
+        uint8_t  _ram[WIDTH * PAGES];
+        uint8_t  _cmd[8];
+        uint8_t  _cmd_len;
+        uint8_t  _cmd_need;
+        uint8_t  _control;
+        bool     _expect_control;
+        uint8_t  _mode;
+        uint8_t  _col, _col_start, _col_end;
+        uint8_t  _page, _page_start, _page_end;
+        uint8_t  _start_line;
+        uint32_t _command_bytes;
+        uint32_t _data_bytes;
+};
+
+class MCP23008 : public I2CDevice
+{
+    public:
+        static const uint8_t REGISTERS = 11;
+
+        /**
+         * @brief Constructor for MCP23008 object
+         * @param address Device address
+        */
+        MCP23008(uint8_t address);
+
+        bool    start(bool read) override;
+        bool    write(uint8_t val) override;
+        uint8_t read() override;
+
+        /**
+         * @brief Output latch
+         * @return OLAT register
+        */
+        uint8_t outputs() const;
+
+    private:
+        uint8_t _regs[REGISTERS];
+        uint8_t _pointer;
+        bool    _pointer_set;
+};
+
+class ShiftRegister595 : public SPIDevice, public PinWatcher
+{
+    public:
+        /**
+         * @brief Constructor for ShiftRegister595 object
+         * @param latch_pin Storage register clock pin; outputs update on its rising edge
+         * @param chain Number of daisy chained registers (1 to 4)
+        */
+        ShiftRegister595(uint8_t latch_pin, uint8_t chain=1);
+        ~ShiftRegister595();
+
+        uint8_t transfer(uint8_t val) override;
+        void    pinChanged(uint8_t pin, uint8_t level) override;
+
+        /**
+         * @brief Latched outputs; first register in the chain in the least significant byte
+         * @return Output register contents
+        */
+        uint32_t outputs() const;
+
+        /**
+         * @brief Number of latch events
+         * @return Latch count
+        */
+        uint32_t latches() const;
+
+    private:
+        uint8_t  _latch_pin;
+        uint32_t _mask;
+        uint32_t _shift;
+        uint32_t _outputs;
+        uint32_t _latches;
+};
+
+}
+
+#endif // _SIM_DEVICES_H
+
+// EOF
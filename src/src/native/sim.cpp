@@ -0,0 +1,706 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : sim.cpp
+// Purpose     : Native Board Simulator
+// Description : This source file implements header file sim.h.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include "Arduino.h"
+#include "sim.h"
+
+namespace Sim
+{
+
+// Default timing; software overheads are zero until calibrated against target benchmark results
+static const BusTiming I2C_DEFAULT_TIMING  = { 100000,  0, 0, 0 };
+static const BusTiming SPI_DEFAULT_TIMING  = { 4000000, 0, 0, 0 };
+static const uint32_t  UART_DEFAULT_BAUD   = 115200;
+
+// SAMD21 SERCOM SCL low timeout (LOWTOUT), and the period of one bus clear pulse at roughly 100 kHz
+static const uint64_t  I2C_LOW_TIMEOUT_NS  = 25 * NS_PER_MS;
+static const uint64_t  I2C_CLEAR_PULSE_NS  = 10 * NS_PER_US;
+
+struct Pin
+{
+    uint8_t      mode;
+    uint8_t      out;
+    uint8_t      ext;
+    bool         driven;
+    uint8_t      level;
+    void       (*isr)();
+    uint8_t      isr_mode;
+    bool         pending;
+    PinWatcher * watcher;
+};
+
+struct Event
+{
+    uint64_t at;
+    EventFn  fn;
+    void *   ctx;
+    bool     used;
+};
+
+struct Timer
+{
+    uint64_t period_ns;
+    uint64_t next_ns;
+    bool     running;
+    bool     pending;
+    void   (*isr)();
+    uint32_t count;
+};
+
+static uint64_t s_now      = 0;
+static bool     s_masked   = false;
+static bool     s_defer    = false;
+static uint64_t s_deferred = 0;
+static Pin      s_pins[MAX_PINS];
+static Event    s_events[MAX_EVENTS];
+static Timer    s_timer;
+static I2CBus   s_i2c[I2C_CHANNELS];
+static SPIBus   s_spi[SPI_CHANNELS];
+static UARTPort s_uart[UART_CHANNELS];
+
+static void deliver()
+{
+    bool again = true;
+
+    if (s_masked) return;
+
+    // Handlers run with interrupts masked, as a single priority level would on target
+    s_masked = true;
+
+    while (again)
+    {
+        again = false;
+
+        if (s_timer.pending)
+        {
+            s_timer.pending = false;
+            ++s_timer.count;
+            if (s_timer.isr) s_timer.isr();
+            again = true;
+        }
+
+        for (uint8_t pin = 0; pin < MAX_PINS; ++pin)
+        {
+            if (s_pins[pin].pending)
+            {
+                s_pins[pin].pending = false;
+                if (s_pins[pin].isr) s_pins[pin].isr();
+                again = true;
+            }
+        }
+    }
+
+    s_masked = false;
+}
+
+static void update(uint8_t pin)
+{
+    Pin&    state = s_pins[pin];
+    uint8_t level = LOW;
+
+    if (OUTPUT == state.mode)
+        level = state.out;
+    else if (state.driven)
+        level = state.ext;
+    else if (INPUT_PULLUP == state.mode)
+        level = HIGH;
+
+    if (level == state.level) return;
+
+    state.level = level;
+
+    if (state.watcher)
+        state.watcher->pinChanged(pin, level);
+
+    if (state.isr && ((CHANGE == state.isr_mode) ||
+                      ((RISING == state.isr_mode) && (HIGH == level)) ||
+                      ((FALLING == state.isr_mode) && (LOW == level))))
+        state.pending = true;
+}
+
+uint64_t now()
+{
+    return s_now;
+}
+
+void advance(uint64_t ns)
+{
+    uint64_t target = s_now + ns;
+
+    if (s_defer)
+    {
+        s_deferred += ns;
+        return;
+    }
+
+    while (true)
+    {
+        uint64_t next = target;
+        bool     due  = false;
+
+        if (s_timer.running && (s_timer.next_ns <= next))
+        {
+            next = s_timer.next_ns;
+            due  = true;
+        }
+
+        for (uint8_t iter = 0; iter < MAX_EVENTS; ++iter)
+        {
+            if (s_events[iter].used && (s_events[iter].at <= next))
+            {
+                next = s_events[iter].at;
+                due  = true;
+            }
+        }
+
+        if (!due) break;
+        if (next > s_now) s_now = next;
+
+        // Missed periods coalesce into one pending interrupt, as the hardware flag does
+        if (s_timer.running && (s_timer.next_ns <= s_now))
+        {
+            s_timer.pending = true;
+            while (s_timer.next_ns <= s_now)
+                s_timer.next_ns += s_timer.period_ns;
+        }
+
+        for (uint8_t iter = 0; iter < MAX_EVENTS; ++iter)
+        {
+            if (s_events[iter].used && (s_events[iter].at <= s_now))
+            {
+                s_events[iter].used = false;
+                s_events[iter].fn(s_events[iter].ctx);
+            }
+        }
+
+        deliver();
+    }
+
+    if (target > s_now) s_now = target;
+}
+
+void reset()
+{
+    s_now      = 0;
+    s_masked   = false;
+    s_defer    = false;
+    s_deferred = 0;
+
+    for (uint8_t pin = 0; pin < MAX_PINS; ++pin)
+    {
+        PinWatcher * watcher = s_pins[pin].watcher;
+
+        s_pins[pin]         = Pin();
+        s_pins[pin].watcher = watcher;
+    }
+
+    for (uint8_t iter = 0; iter < MAX_EVENTS; ++iter)
+        s_events[iter].used = false;
+
+    s_timer = Timer();
+    for (uint8_t iter = 0; iter < I2C_CHANNELS; ++iter)
+    {
+        s_i2c[iter].clearStats();
+        s_i2c[iter].clearFaults();
+    }
+
+    for (uint8_t iter = 0; iter < SPI_CHANNELS; ++iter)
+        s_spi[iter].clearStats();
+
+    for (uint8_t iter = 0; iter < UART_CHANNELS; ++iter)
+        s_uart[iter].clearStats();
+}
+
+void deferBegin()
+{
+    s_defer    = true;
+    s_deferred = 0;
+}
+
+uint64_t deferEnd()
+{
+    s_defer = false;
+
+    return s_deferred;
+}
+
+bool schedule(uint64_t at, EventFn fn, void * ctx)
+{
+    for (uint8_t iter = 0; iter < MAX_EVENTS; ++iter)
+    {
+        if (!s_events[iter].used)
+        {
+            s_events[iter].at   = at;
+            s_events[iter].fn   = fn;
+            s_events[iter].ctx  = ctx;
+            s_events[iter].used = true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void cancel(EventFn fn, void * ctx)
+{
+    for (uint8_t iter = 0; iter < MAX_EVENTS; ++iter)
+    {
+        if (s_events[iter].used && (s_events[iter].fn == fn) && (s_events[iter].ctx == ctx))
+            s_events[iter].used = false;
+    }
+}
+
+uint32_t disableInterrupts()
+{
+    uint32_t state = s_masked ? 1 : 0;
+    s_masked = true;
+    return state;
+}
+
+void restoreInterrupts(uint32_t state)
+{
+    s_masked = (0 != state);
+    deliver();
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin >= MAX_PINS) return;
+
+    s_pins[pin].mode = mode;
+    update(pin);
+}
+
+void pinWrite(uint8_t pin, uint8_t level)
+{
+    if (pin >= MAX_PINS) return;
+
+    s_pins[pin].out = level ? HIGH : LOW;
+    update(pin);
+}
+
+uint8_t pinRead(uint8_t pin)
+{
+    return (pin < MAX_PINS) ? s_pins[pin].level : LOW;
+}
+
+void pinDrive(uint8_t pin, uint8_t level)
+{
+    if (pin >= MAX_PINS) return;
+
+    s_pins[pin].ext    = level ? HIGH : LOW;
+    s_pins[pin].driven = true;
+    update(pin);
+}
+
+void pinRelease(uint8_t pin)
+{
+    if (pin >= MAX_PINS) return;
+
+    s_pins[pin].driven = false;
+    update(pin);
+}
+
+void pinAttachInterrupt(uint8_t pin, void (*isr)(), uint8_t mode)
+{
+    if (pin >= MAX_PINS) return;
+
+    s_pins[pin].isr      = isr;
+    s_pins[pin].isr_mode = mode;
+    s_pins[pin].pending  = false;
+}
+
+void pinDetachInterrupt(uint8_t pin)
+{
+    if (pin >= MAX_PINS) return;
+
+    s_pins[pin].isr     = nullptr;
+    s_pins[pin].pending = false;
+}
+
+void pinWatch(uint8_t pin, PinWatcher * watcher)
+{
+    if (pin >= MAX_PINS) return;
+
+    s_pins[pin].watcher = watcher;
+}
+
+void timerInit(uint32_t period_us)
+{
+    s_timer.period_ns = (uint64_t)period_us * NS_PER_US;
+}
+
+void timerAttach(void (*isr)())
+{
+    s_timer.isr = isr;
+}
+
+void timerRun(bool run)
+{
+    s_timer.running = run && (0 != s_timer.period_ns);
+
+    if (s_timer.running)
+        s_timer.next_ns = s_now + s_timer.period_ns;
+}
+
+uint32_t timerCount()
+{
+    return s_timer.count;
+}
+
+I2CBus::I2CBus()
+: _devices()
+, _n_devices(0)
+, _held(nullptr)
+, _sda_pulses(0)
+, _scl_release(0)
+, _error(I2C_OK)
+, _timing(I2C_DEFAULT_TIMING)
+, _stats()
+{ }
+
+bool I2CBus::attach(I2CDevice& device)
+{
+    if (_n_devices >= MAX_DEVICES) return false;
+
+    _devices[_n_devices++] = &device;
+
+    return true;
+}
+
+bool I2CBus::detach(I2CDevice& device)
+{
+    for (uint8_t iter = 0; iter < _n_devices; ++iter)
+    {
+        if (_devices[iter] == &device)
+        {
+            if (_held == &device) _held = nullptr;
+            _devices[iter] = _devices[--_n_devices];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void I2CBus::setTiming(const BusTiming& timing)
+{
+    _timing = timing;
+}
+
+void I2CBus::setClock(uint32_t clock_hz)
+{
+    if ((0 == clock_hz) || (clock_hz == _timing.clock_hz)) return;
+
+    advance(_timing.switch_ns);
+    _timing.clock_hz = clock_hz;
+}
+
+const BusTiming& I2CBus::timing() const
+{
+    return _timing;
+}
+
+uint8_t I2CBus::write(uint8_t addr, const uint8_t * head, uint32_t head_len,
+                      const uint8_t * data, uint32_t len, bool stop)
+{
+    I2CDevice * device = find(addr);
+    uint32_t    bits   = 1 + 9; // (Repeated) start and address
+    uint32_t    bytes  = 1;
+    uint8_t     result = held();
+
+    if (I2C_OK != result) return (_error = result);
+
+    // Repeated start to another device ends the held transaction for that device
+    if (_held && (_held != device)) _held->stop();
+    _held = nullptr;
+
+    if (!device || !device->start(false))
+    {
+        result = I2C_NACK_ADDR;
+    }
+    else
+    {
+        for (uint32_t iter = 0; (iter < head_len + len) && (I2C_OK == result); ++iter)
+        {
+            bits  += 9;
+            bytes += 1;
+            if (!device->write((iter < head_len) ? head[iter] : data[iter - head_len]))
+                result = I2C_NACK_DATA;
+        }
+    }
+
+    // A NACK always ends with stop
+    stop = stop || (I2C_OK != result);
+    if (stop) bits += 1;
+    if (I2C_OK != result) ++_stats.nacks;
+
+    spend(bitsNs(bits) + _timing.transaction_ns + (uint64_t)bytes * _timing.byte_ns, bytes);
+
+    if (device && (I2C_NACK_ADDR != result)) release(device, stop);
+
+    return (_error = result);
+}
+
+uint32_t I2CBus::read(uint8_t addr, uint8_t * data, uint32_t len, bool stop)
+{
+    I2CDevice * device  = find(addr);
+    uint32_t    bits    = 1 + 9;
+    uint64_t    stretch = 0;
+
+    if (I2C_OK != (_error = held())) return 0;
+
+    if (_held && (_held != device)) _held->stop();
+    _held = nullptr;
+
+    if (!device || !device->start(true))
+    {
+        ++_stats.nacks;
+        spend(bitsNs(bits + 1) + _timing.transaction_ns + _timing.byte_ns, 1);
+        _error = I2C_NACK_ADDR;
+        return 0;
+    }
+
+    for (uint32_t iter = 0; iter < len; ++iter)
+    {
+        stretch   += device->stretch();
+        data[iter] = device->read();
+        bits      += 9;
+    }
+
+    if (stop) bits += 1;
+
+    spend(bitsNs(bits) + stretch + _timing.transaction_ns + (uint64_t)(len + 1) * _timing.byte_ns, len + 1);
+    release(device, stop);
+
+    return len;
+}
+
+uint8_t I2CBus::error() const
+{
+    return _error;
+}
+
+void I2CBus::holdSDA(uint8_t pulses)
+{
+    _sda_pulses = pulses ? pulses : 1;
+}
+
+void I2CBus::holdSCL(uint64_t ns)
+{
+    _scl_release = now() + ns;
+}
+
+void I2CBus::clearFaults()
+{
+    _sda_pulses  = 0;
+    _scl_release = 0;
+    _error       = I2C_OK;
+}
+
+bool I2CBus::busClear(uint8_t max_pulses)
+{
+    uint64_t ns = 0;
+
+    // With SCL held the pulses are lost; SDA is released only by clocking the slave through its byte
+    for (uint8_t iter = 0; (iter < max_pulses) && (_sda_pulses > 0); ++iter)
+    {
+        ns += I2C_CLEAR_PULSE_NS;
+        if (now() + ns >= _scl_release) --_sda_pulses;
+    }
+
+    // Stop condition
+    ns += I2C_CLEAR_PULSE_NS;
+
+    if (_held) _held->stop();
+    _held = nullptr;
+
+    spend(ns, 0);
+
+    return (0 == _sda_pulses) && (now() >= _scl_release);
+}
+
+const BusStats& I2CBus::stats() const
+{
+    return _stats;
+}
+
+void I2CBus::clearStats()
+{
+    _stats = BusStats();
+}
+
+I2CDevice * I2CBus::find(uint8_t addr) const
+{
+    for (uint8_t iter = 0; iter < _n_devices; ++iter)
+    {
+        if (_devices[iter]->address() == addr) return _devices[iter];
+    }
+
+    return nullptr;
+}
+
+uint8_t I2CBus::held()
+{
+    uint64_t wait;
+
+    // SDA low: the start condition is lost to arbitration at the cost of the address byte
+    if (_sda_pulses > 0)
+    {
+        ++_stats.nacks;
+        spend(bitsNs(1 + 9) + _timing.transaction_ns, 1);
+        return I2C_ERROR;
+    }
+
+    if (now() >= _scl_release) return I2C_OK;
+
+    // SCL low: the master waits for release as for clock stretching, up to the SCL low timeout
+    wait = _scl_release - now();
+
+    if (wait >= I2C_LOW_TIMEOUT_NS)
+    {
+        ++_stats.nacks;
+        spend(I2C_LOW_TIMEOUT_NS + _timing.transaction_ns, 0);
+        return I2C_ERROR;
+    }
+
+    _stats.busy_ns += wait;
+    advance(wait);
+
+    return I2C_OK;
+}
+
+void I2CBus::release(I2CDevice * device, bool stop)
+{
+    if (stop)
+        device->stop();
+    else
+        _held = device;
+}
+
+uint64_t I2CBus::bitsNs(uint32_t bits) const
+{
+    return ((uint64_t)bits * NS_PER_S) / _timing.clock_hz;
+}
+
+void I2CBus::spend(uint64_t ns, uint32_t bytes)
+{
+    ++_stats.transactions;
+    _stats.bytes   += bytes;
+    _stats.busy_ns += ns;
+    advance(ns);
+}
+
+SPIBus::SPIBus()
+: _devices()
+, _n_devices(0)
+, _timing(SPI_DEFAULT_TIMING)
+, _stats()
+{ }
+
+bool SPIBus::attach(SPIDevice& device)
+{
+    if (_n_devices >= MAX_DEVICES) return false;
+
+    _devices[_n_devices++] = &device;
+
+    return true;
+}
+
+void SPIBus::setTiming(const BusTiming& timing)
+{
+    _timing = timing;
+}
+
+uint8_t SPIBus::transfer(uint8_t val)
+{
+    uint8_t  miso = 0;
+    uint64_t ns   = (8 * NS_PER_S) / _timing.clock_hz + _timing.transaction_ns + _timing.byte_ns;
+
+    for (uint8_t iter = 0; iter < _n_devices; ++iter)
+        miso |= _devices[iter]->transfer(val);
+
+    ++_stats.transactions;
+    ++_stats.bytes;
+    _stats.busy_ns += ns;
+    advance(ns);
+
+    return miso;
+}
+
+const BusStats& SPIBus::stats() const
+{
+    return _stats;
+}
+
+void SPIBus::clearStats()
+{
+    _stats = BusStats();
+}
+
+UARTPort::UARTPort()
+: _baud(UART_DEFAULT_BAUD)
+, _echo(true)
+, _stats()
+{ }
+
+void UARTPort::setBaud(uint32_t baud)
+{
+    if (0 != baud) _baud = baud;
+}
+
+void UARTPort::setEcho(bool echo)
+{
+    _echo = echo;
+}
+
+uint32_t UARTPort::write(const char * data, uint32_t len)
+{
+    uint64_t ns = ((uint64_t)len * 10 * NS_PER_S) / _baud;
+
+    if (_echo) fwrite(data, 1, len, stdout);
+
+    ++_stats.transactions;
+    _stats.bytes   += len;
+    _stats.busy_ns += ns;
+    advance(ns);
+
+    return len;
+}
+
+const BusStats& UARTPort::stats() const
+{
+    return _stats;
+}
+
+void UARTPort::clearStats()
+{
+    _stats = BusStats();
+}
+
+I2CBus& i2c(uint8_t channel)
+{
+    return s_i2c[(channel < I2C_CHANNELS) ? channel : 0];
+}
+
+SPIBus& spi(uint8_t channel)
+{
+    return s_spi[(channel < SPI_CHANNELS) ? channel : 0];
+}
+
+UARTPort& uart(uint8_t channel)
+{
+    return s_uart[(channel < UART_CHANNELS) ? channel : 0];
+}
+
+}
+
+// EOF
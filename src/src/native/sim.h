@@ -0,0 +1,535 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : sim.h
+// Purpose     : Native Board Simulator
+// Description :
+//               This simulator is the hardware beneath the native HAL backend. It models a virtual clock, interrupt
+//               masking, GPIO pins with edge interrupts, a periodic timer, and I2C, SPI and UART buses with devices
+//               attached to them.
+//
+//               Virtual time advances only when the HAL spends it: bus transactions cost the time their bits take
+//               at the configured clock plus a fixed per-transaction and per-byte software overhead and any clock
+//               stretching by the addressed device; delays cost their argument. Time spent executing host code is
+//               not counted, so runs are deterministic and comparable across machines. The result is the bus and
+//               delay bound of the loop, which on this board dominates its execution time.
+//
+//               Interrupts (timer period, pin edges) are delivered when virtual time reaches them and interrupts
+//               are not masked. A bus transaction is atomic with respect to interrupts; on hardware an ISR may
+//               preempt between bytes, which only shifts its entry by at most one transaction.
+//
+//               Devices implement I2CDevice or SPIDevice and are attached to a bus. Devices needing internal
+//               timing (conversion times, square wave outputs, scripted stimulus) use schedule()/cancel().
+//
+//               A DMA transfer is modelled by making it between deferBegin() and deferEnd(): its bytes reach the
+//               devices at once, and the bus time it collected is then scheduled as the job's completion.
+//
+//               The I2C bus injects the faults a recovery path must handle: a device detached mid-run, a slave
+//               holding SDA low until enough clock pulses are issued, and a slave holding SCL low. A held SCL ends
+//               each transaction with a bus error after the SAMD21 SCL low timeout, as the SERCOM does when that
+//               timeout is enabled.
+//
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : N/A
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _SIM_H
+#define _SIM_H
+
+#include <stdint.h>
+
+namespace Sim
+{
+
+static const uint64_t NS_PER_US = 1000ULL;
+static const uint64_t NS_PER_MS = 1000000ULL;
+static const uint64_t NS_PER_S  = 1000000000ULL;
+
+// Nominal core clock against which virtual time is reported as cycles
+static const uint32_t CPU_FREQUENCY = 48000000;
+
+static const uint8_t  MAX_PINS    = 32;
+static const uint8_t  MAX_DEVICES = 8;
+static const uint8_t  MAX_EVENTS  = 16;
+
+// Buses and ports: the variant's own, and a further SERCOM one that HAL channel 1 maps to when configured
+static const uint8_t  I2C_CHANNELS  = 2;
+static const uint8_t  SPI_CHANNELS  = 2;
+static const uint8_t  UART_CHANNELS = 2;
+
+// Wire-compatible transaction results
+static const uint8_t  I2C_OK        = 0;
+static const uint8_t  I2C_NACK_ADDR = 2;
+static const uint8_t  I2C_NACK_DATA = 3;
+static const uint8_t  I2C_ERROR     = 4;
+
+typedef void (*EventFn)(void * ctx);
+
+struct BusTiming
+{
+    uint32_t clock_hz;          // Bus clock
+    uint32_t transaction_ns;    // Fixed software cost per transaction (driver setup, completion)
+    uint32_t byte_ns;           // Software cost per byte beyond its bit time
+    uint32_t switch_ns;         // Cost of changing the bus clock (peripheral disable, reconfigure, enable)
+};
+
+struct BusStats
+{
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t nacks;
+    uint64_t busy_ns;
+};
+
+/**
+ * @brief Current virtual time
+ * @return Nanoseconds since simulation start
+*/
+uint64_t now();
+
+/**
+ * @brief Advance virtual time, delivering events and unmasked interrupts as they fall due
+ * @param ns Nanoseconds to advance
+*/
+void advance(uint64_t ns);
+
+/**
+ * @brief Start collecting the time advance() is asked for instead of spending it, so that a bus transfer made
+ *        now can complete in the background, as a DMA transfer does on target
+*/
+void deferBegin();
+
+/**
+ * @brief Stop collecting time; advance() spends it again
+ * @return Nanoseconds collected since deferBegin()
+*/
+uint64_t deferEnd();
+
+/**
+ * @brief Reset virtual time, events, pins, timer, bus statistics and bus faults; attached devices are kept
+*/
+void reset();
+
+/**
+ * @brief Schedule a callback at an absolute virtual time; callbacks run regardless of interrupt masking
+ * @param at Virtual time in nanoseconds
+ * @param fn Callback
+ * @param ctx Callback argument
+ * @return False if the event table is full
+*/
+bool schedule(uint64_t at, EventFn fn, void * ctx);
+
+/**
+ * @brief Remove all scheduled occurrences of a callback
+ * @param fn Callback
+ * @param ctx Callback argument
+*/
+void cancel(EventFn fn, void * ctx);
+
+/**
+ * @brief Mask interrupts
+ * @return Prior mask state
+*/
+uint32_t disableInterrupts();
+
+/**
+ * @brief Restore mask state, delivering any interrupts that became pending while masked
+ * @param state Prior mask state
+*/
+void restoreInterrupts(uint32_t state);
+
+class PinWatcher
+{
+    public:
+        virtual ~PinWatcher() { }
+
+        /**
+         * @brief Called when the level of a watched pin changes
+         * @param pin Pin number
+         * @param level New level
+        */
+        virtual void pinChanged(uint8_t pin, uint8_t level) = 0;
+};
+
+/**
+ * @brief Set pin mode as the MCU would
+ * @param pin Pin number
+ * @param mode Arduino pin mode
+*/
+void pinMode(uint8_t pin, uint8_t mode);
+
+/**
+ * @brief Drive an output pin as the MCU would
+ * @param pin Pin number
+ * @param level Logic level
+*/
+void pinWrite(uint8_t pin, uint8_t level);
+
+/**
+ * @brief Effective pin level: MCU output, else external drive, else pull resistor, else low
+ * @param pin Pin number
+ * @return Logic level
+*/
+uint8_t pinRead(uint8_t pin);
+
+/**
+ * @brief Drive a pin from outside the MCU (device output, stimulus)
+ * @param pin Pin number
+ * @param level Logic level
+*/
+void pinDrive(uint8_t pin, uint8_t level);
+
+/**
+ * @brief Stop driving a pin from outside the MCU (open drain release)
+ * @param pin Pin number
+*/
+void pinRelease(uint8_t pin);
+
+/**
+ * @brief Attach pin edge interrupt
+ * @param pin Pin number
+ * @param isr Interrupt handler
+ * @param mode Arduino edge mode
+*/
+void pinAttachInterrupt(uint8_t pin, void (*isr)(), uint8_t mode);
+
+/**
+ * @brief Detach pin edge interrupt
+ * @param pin Pin number
+*/
+void pinDetachInterrupt(uint8_t pin);
+
+/**
+ * @brief Register a device to be told of level changes on a pin; one watcher per pin
+ * @param pin Pin number
+ * @param watcher Watcher, or nullptr to remove
+*/
+void pinWatch(uint8_t pin, PinWatcher * watcher);
+
+/**
+ * @brief Configure periodic timer
+ * @param period_us Period in microseconds
+*/
+void timerInit(uint32_t period_us);
+
+/**
+ * @brief Set periodic timer interrupt handler
+ * @param isr Interrupt handler
+*/
+void timerAttach(void (*isr)());
+
+/**
+ * @brief Start (from zero count) or stop periodic timer
+ * @param run True to start
+*/
+void timerRun(bool run);
+
+/**
+ * @brief Number of timer interrupts delivered
+ * @return Interrupt count
+*/
+uint32_t timerCount();
+
+class I2CDevice
+{
+    public:
+        /**
+         * @brief Constructor for I2CDevice object
+         * @param address 7-bit address to which the device responds
+        */
+        I2CDevice(uint8_t address) : _address(address) { }
+        virtual ~I2CDevice() { }
+
+        /**
+         * @brief Device address
+         * @return 7-bit address
+        */
+        uint8_t address() const { return _address; }
+
+        /**
+         * @brief Address phase of a (repeated) start
+         * @param read True for a read transaction
+         * @return True to acknowledge
+        */
+        virtual bool start(bool read) { (void)read; return true; }
+
+        /**
+         * @brief Byte written by master
+         * @param val Byte value
+         * @return True to acknowledge
+        */
+        virtual bool write(uint8_t val) { (void)val; return true; }
+
+        /**
+         * @brief Byte read by master
+         * @return Byte value
+        */
+        virtual uint8_t read() { return 0xFF; }
+
+        /**
+         * @brief Time the device holds SCL low before the next byte it returns
+         * @return Nanoseconds of clock stretching
+        */
+        virtual uint64_t stretch() { return 0; }
+
+        /**
+         * @brief Stop condition ending a transaction addressed to this device
+        */
+        virtual void stop() { }
+
+    private:
+        uint8_t _address;
+};
+
+class SPIDevice
+{
+    public:
+        virtual ~SPIDevice() { }
+
+        /**
+         * @brief Byte clocked on the bus
+         * @param val Byte shifted in on MOSI
+         * @return Byte driven on MISO
+        */
+        virtual uint8_t transfer(uint8_t val) = 0;
+};
+
+class I2CBus
+{
+    public:
+        /**
+         * @brief Constructor for I2CBus object
+        */
+        I2CBus();
+
+        /**
+         * @brief Attach device to bus
+         * @param device Device; must outlive the bus
+         * @return False if the device table is full
+        */
+        bool attach(I2CDevice& device);
+
+        /**
+         * @brief Detach device from bus, as if it lost power; it no longer acknowledges its address
+         * @param device Device
+         * @return False if the device was not attached
+        */
+        bool detach(I2CDevice& device);
+
+        /**
+         * @brief Set timing model
+         * @param timing Bus clock and software overheads
+        */
+        void setTiming(const BusTiming& timing);
+
+        /**
+         * @brief Set bus clock only; a change of clock costs switch_ns of virtual time
+         * @param clock_hz Bus clock
+        */
+        void setClock(uint32_t clock_hz);
+
+        /**
+         * @brief Current timing model
+         * @return Timing model
+        */
+        const BusTiming& timing() const;
+
+        /**
+         * @brief Write transaction: address, then head bytes, then data bytes
+         * @param addr Target address
+         * @param head Leading bytes (e.g. register address), may be nullptr
+         * @param head_len Number of leading bytes
+         * @param data Payload, may be nullptr
+         * @param len Number of payload bytes
+         * @param stop True to end with stop, false to hold the bus for a repeated start
+         * @return I2C_OK or a Wire-compatible error code
+        */
+        uint8_t write(uint8_t addr, const uint8_t * head, uint32_t head_len,
+                      const uint8_t * data, uint32_t len, bool stop=true);
+
+        /**
+         * @brief Read transaction
+         * @param addr Target address
+         * @param data Buffer into which to read
+         * @param len Number of bytes to read
+         * @param stop True to end with stop, false to hold the bus for a repeated start
+         * @return Number of bytes read; zero if the address was not acknowledged
+        */
+        uint32_t read(uint8_t addr, uint8_t * data, uint32_t len, bool stop=true);
+
+        /**
+         * @brief Result of the last write or read transaction
+         * @return I2C_OK or a Wire-compatible error code
+        */
+        uint8_t error() const;
+
+        /**
+         * @brief Hold SDA low, as a slave interrupted mid-byte does; transactions fail with I2C_ERROR until cleared
+         * @param pulses Clock pulses busClear() must issue before the slave releases SDA
+        */
+        void holdSDA(uint8_t pulses);
+
+        /**
+         * @brief Hold SCL low; transactions wait for its release, failing with I2C_ERROR after the SCL low timeout
+         * @param ns Nanoseconds from now until release
+        */
+        void holdSCL(uint64_t ns);
+
+        /**
+         * @brief Remove any held lines
+        */
+        void clearFaults();
+
+        /**
+         * @brief Bus clear: pulse SCL until SDA is released or the pulse limit is reached, then generate a stop
+         * @param max_pulses Pulse limit
+         * @return True if both lines are released afterwards
+        */
+        bool busClear(uint8_t max_pulses);
+
+        /**
+         * @brief Accumulated statistics
+         * @return Statistics
+        */
+        const BusStats& stats() const;
+
+        /**
+         * @brief Clear accumulated statistics
+        */
+        void clearStats();
+
+    private:
+        I2CDevice * find(uint8_t addr) const;
+        uint8_t     held();
+        void        release(I2CDevice * device, bool stop);
+        uint64_t    bitsNs(uint32_t bits) const;
+        void        spend(uint64_t ns, uint32_t bytes);
+
+        I2CDevice * _devices[MAX_DEVICES];
+        uint8_t     _n_devices;
+        I2CDevice * _held;
+        uint8_t     _sda_pulses;
+        uint64_t    _scl_release;
+        uint8_t     _error;
+        BusTiming   _timing;
+        BusStats    _stats;
+};
+
+class SPIBus
+{
+    public:
+        /**
+         * @brief Constructor for SPIBus object
+        */
+        SPIBus();
+
+        /**
+         * @brief Attach device to bus; every device sees every byte and decodes its own select line
+         * @param device Device; must outlive the bus
+         * @return False if the device table is full
+        */
+        bool attach(SPIDevice& device);
+
+        /**
+         * @brief Set timing model
+         * @param timing Bus clock and software overheads
+        */
+        void setTiming(const BusTiming& timing);
+
+        /**
+         * @brief Single byte transfer as one transaction
+         * @param val Byte to write
+         * @return Byte read; devices' MISO outputs are wire-ORed
+        */
+        uint8_t transfer(uint8_t val);
+
+        /**
+         * @brief Accumulated statistics
+         * @return Statistics
+        */
+        const BusStats& stats() const;
+
+        /**
+         * @brief Clear accumulated statistics
+        */
+        void clearStats();
+
+    private:
+        SPIDevice * _devices[MAX_DEVICES];
+        uint8_t     _n_devices;
+        BusTiming   _timing;
+        BusStats    _stats;
+};
+
+class UARTPort
+{
+    public:
+        /**
+         * @brief Constructor for UARTPort object
+        */
+        UARTPort();
+
+        /**
+         * @brief Set line rate; each byte costs ten bit times
+         * @param baud Bits per second
+        */
+        void setBaud(uint32_t baud);
+
+        /**
+         * @brief Enable or disable echo of transmitted bytes to host stdout
+         * @param echo True to echo
+        */
+        void setEcho(bool echo);
+
+        /**
+         * @brief Transmit bytes
+         * @param data Bytes to transmit
+         * @param len Number of bytes
+         * @return Number of bytes transmitted
+        */
+        uint32_t write(const char * data, uint32_t len);
+
+        /**
+         * @brief Accumulated statistics
+         * @return Statistics
+        */
+        const BusStats& stats() const;
+
+        /**
+         * @brief Clear accumulated statistics
+        */
+        void clearStats();
+
+    private:
+        uint32_t _baud;
+        bool     _echo;
+        BusStats _stats;
+};
+
+/**
+ * @brief One of the board's I2C buses
+ * @param channel Bus index; out of range selects bus 0
+ * @return Bus
+*/
+I2CBus& i2c(uint8_t channel=0);
+
+/**
+ * @brief One of the board's SPI buses
+ * @param channel Bus index; out of range selects bus 0
+ * @return Bus
+*/
+SPIBus& spi(uint8_t channel=0);
+
+/**
+ * @brief One of the board's serial ports
+ * @param channel Port index; out of range selects port 0
+ * @return Port
+*/
+UARTPort& uart(uint8_t channel=0);
+
+}
+
+#endif // _SIM_H
+
+// EOF
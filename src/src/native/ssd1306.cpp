@@ -0,0 +1,86 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : ssd1306.cpp
+// Purpose     : Native Stand-In for the SSD1306 OLED Driver
+// Description : This source file implements header file ssd1306.h.
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include "ssd1306.h"
+
+namespace PeripheralIO
+{
+
+// Text size 1 cell: five glyph columns and a blank one, one page high
+static const uint8_t CHAR_WIDTH  = 6;
+static const uint8_t LINE_HEIGHT = 8;
+
+SSD1306::SSD1306(HAL::I2C& i2c_bus, uint8_t width, uint8_t height)
+: _i2c(i2c_bus)
+, _buffer()
+, _width(width)
+, _height(height)
+, _cursor_x(0)
+, _cursor_y(0)
+, _color(SSD1306_WHITE)
+{ }
+
+bool SSD1306::begin(uint8_t vcc, uint8_t addr)
+{
+    (void)vcc;
+    (void)addr;
+
+    clearDisplay();
+
+    return true;
+}
+
+void SSD1306::clearDisplay()
+{
+    memset(_buffer, 0, sizeof(_buffer));
+}
+
+void SSD1306::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    for (int16_t row = (y < 0) ? 0 : y; (row < y + h) && (row < _height); ++row)
+    {
+        uint8_t * page = &_buffer[(uint16_t)(row / 8) * _width];
+        uint8_t   mask = (uint8_t)(1 << (row & 7));
+
+        for (int16_t col = (x < 0) ? 0 : x; (col < x + w) && (col < _width); ++col)
+            page[col] = (SSD1306_BLACK == color) ? (page[col] & ~mask) : (page[col] | mask);
+    }
+}
+
+void SSD1306::setCursor(int16_t x, int16_t y)
+{
+    _cursor_x = x;
+    _cursor_y = y;
+}
+
+size_t SSD1306::write(uint8_t data)
+{
+    uint8_t * cell;
+
+    if ('\n' == data)
+    {
+        _cursor_x  = 0;
+        _cursor_y += LINE_HEIGHT;
+        return 1;
+    }
+
+    if ((_cursor_x + CHAR_WIDTH > _width) || (_cursor_y + LINE_HEIGHT > _height)) return 1;
+
+    cell = &_buffer[(uint16_t)(_cursor_y / 8) * _width + _cursor_x];
+    memset(cell, (SSD1306_BLACK == _color) ? (uint8_t)~data : data, CHAR_WIDTH - 1);
+    cell[CHAR_WIDTH - 1] = (SSD1306_BLACK == _color) ? 0xFF : 0;
+    _cursor_x += CHAR_WIDTH;
+
+    return 1;
+}
+
+}
+
+// EOF
@@ -0,0 +1,75 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : ssd1306.h
+// Purpose     : Native Stand-In for the SSD1306 OLED Driver
+// Description :
+//               This header stands in for the ssd1306 library when portable modules drawing through it are built
+//               for the native host backend, so that oled-ticker.cpp is compiled unchanged. It keeps the driver's
+//               frame buffer layout (one byte per column per 8 pixel page) and the calls the ticker makes; text is
+//               rendered at size 1 with each character drawn as five columns of its code, as by the native
+//               workload's own text, and the cursor is expected on a page boundary. Display RAM is written by
+//               the caller through OLEDIO, so begin() makes no bus traffic.
+//
+// Language    : C++
+// Platform    : Native
+// Framework   : Simulation
+// Copyright   : MIT License 2024, John Greenwell
+// Requires    : External : N/A
+//               Custom   : hal.h
+//--------------------------------------------------------------------------------------------------------------------
+#ifndef _NATIVE_SSD1306_H
+#define _NATIVE_SSD1306_H
+
+#include "hal.h"
+
+#define SSD1306_BLACK        0
+#define SSD1306_WHITE        1
+#define SSD1306_SWITCHCAPVCC 0x02
+
+namespace PeripheralIO
+{
+
+class SSD1306 : public Print
+{
+    public:
+        /**
+         * @brief Constructor for SSD1306 object
+         * @param i2c_bus I2C bus of the panel
+         * @param width Panel width in pixels, up to 128
+         * @param height Panel height in pixels, up to 64
+        */
+        SSD1306(HAL::I2C& i2c_bus, uint8_t width, uint8_t height);
+
+        /**
+         * @brief Clear the frame buffer; the panel is left to the caller
+         * @param vcc Supply mode, as in the driver
+         * @param addr Panel I2C address, as in the driver
+         * @return True
+        */
+        bool begin(uint8_t vcc, uint8_t addr);
+
+        int16_t   width() const { return _width; }
+        int16_t   height() const { return _height; }
+        uint8_t * getBuffer() { return _buffer; }
+
+        void clearDisplay();
+        void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+        void setCursor(int16_t x, int16_t y);
+        void setTextColor(uint16_t color) { _color = color; }
+
+        size_t write(uint8_t data);
+
+    private:
+        HAL::I2C& _i2c;
+        uint8_t   _buffer[128 * 64 / 8];
+        uint8_t   _width;
+        uint8_t   _height;
+        int16_t   _cursor_x;
+        int16_t   _cursor_y;
+        uint16_t  _color;
+};
+
+}
+
+#endif // _NATIVE_SSD1306_H
+
+// EOF
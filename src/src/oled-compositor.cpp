@@ -0,0 +1,165 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : oled-compositor.cpp
+// Purpose     : Retained-Mode OLED Field Compositor
+// Description : This source file implements header file oled-compositor.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "oled-compositor.h"
+
+namespace Demo
+{
+
+// Default font cell size at text size 1
+static const uint8_t FONT_WIDTH  = 6;
+static const uint8_t FONT_HEIGHT = 8;
+
+// Marks a page with no pending columns
+static const uint8_t PAGE_CLEAN  = 0xFF;
+
+OLEDCompositor::OLEDCompositor(PeripheralIO::SSD1306& display, OLEDIO& oled)
+: _display(display)
+, _oled(oled)
+, _fields()
+, _n_fields(0)
+, _flush_us(0)
+{
+    memset(_dirty_col_start, PAGE_CLEAN, sizeof(_dirty_col_start));
+    memset(_dirty_col_end, 0, sizeof(_dirty_col_end));
+}
+
+uint8_t OLEDCompositor::addField(const char * name, uint8_t x, uint8_t y, uint8_t width, const char * format)
+{
+    if (_n_fields >= MAX_FIELDS) return INVALID_FIELD;
+
+    Field& field = _fields[_n_fields];
+    field.name      = name;
+    field.format    = format;
+    field.x         = x;
+    field.y         = y;
+    field.width     = (width > MAX_FIELD_CHARS) ? MAX_FIELD_CHARS : width;
+    field.dirty     = true;
+    field.render_us = 0;
+    field.value[0]  = '\0';
+
+    return _n_fields++;
+}
+
+uint8_t OLEDCompositor::find(const char * name) const
+{
+    for (uint8_t iter = 0; iter < _n_fields; ++iter)
+    {
+        if (0 == strcmp(_fields[iter].name, name))
+            return iter;
+    }
+
+    return INVALID_FIELD;
+}
+
+bool OLEDCompositor::set(uint8_t field, const char * text)
+{
+    if (field >= _n_fields) return false;
+
+    Field& f = _fields[field];
+
+    if (0 == strncmp(f.value, text, f.width)) return false;
+
+    strncpy(f.value, text, f.width);
+    f.value[f.width] = '\0';
+    f.dirty = true;
+
+    return true;
+}
+
+bool OLEDCompositor::update(unsigned field, ...)
+{
+    char text[MAX_FIELD_CHARS + 1];
+
+    if ((field >= _n_fields) || (nullptr == _fields[field].format)) return false;
+
+    va_list args;
+    va_start(args, field);
+    vsnprintf(text, sizeof(text), _fields[field].format, args);
+    va_end(args);
+
+    return set((uint8_t)field, text);
+}
+
+void OLEDCompositor::invalidate()
+{
+    for (uint8_t iter = 0; iter < _n_fields; ++iter)
+        _fields[iter].dirty = true;
+}
+
+uint8_t OLEDCompositor::render()
+{
+    uint8_t  redrawn = 0;
+    uint32_t start;
+
+    for (uint8_t iter = 0; iter < _n_fields; ++iter)
+    {
+        Field& f = _fields[iter];
+
+        if (!f.dirty) continue;
+
+        start = HAL::micros();
+        _display.fillRect(f.x, f.y, f.width * FONT_WIDTH, FONT_HEIGHT, SSD1306_BLACK);
+        _display.setCursor(f.x, f.y);
+        _display.print(f.value);
+        f.render_us = HAL::micros() - start;
+
+        markDirty(f.x, f.y, f.width * FONT_WIDTH, FONT_HEIGHT);
+        f.dirty = false;
+        ++redrawn;
+    }
+
+    start = HAL::micros();
+
+    for (uint8_t page = 0; page < MAX_PAGES; ++page)
+    {
+        if (PAGE_CLEAN == _dirty_col_start[page]) continue;
+
+        _oled.writeWindow(_display.getBuffer(), _dirty_col_start[page], _dirty_col_end[page], page, page);
+        _dirty_col_start[page] = PAGE_CLEAN;
+        _dirty_col_end[page]   = 0;
+    }
+
+    _flush_us = HAL::micros() - start;
+
+    return redrawn;
+}
+
+uint32_t OLEDCompositor::renderTime(uint8_t field) const
+{
+    return (field < _n_fields) ? _fields[field].render_us : 0;
+}
+
+uint32_t OLEDCompositor::flushTime() const
+{
+    return _flush_us;
+}
+
+void OLEDCompositor::markDirty(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
+{
+    uint16_t x_end    = (uint16_t)x + w - 1;
+    uint8_t  page_end = (uint8_t)(((uint16_t)y + h - 1) / 8);
+
+    if (x_end >= (uint16_t)_display.width()) x_end = _display.width() - 1;
+    if (page_end >= MAX_PAGES) page_end = MAX_PAGES - 1;
+
+    for (uint8_t page = y / 8; page <= page_end; ++page)
+    {
+        if ((PAGE_CLEAN == _dirty_col_start[page]) || (x < _dirty_col_start[page]))
+            _dirty_col_start[page] = x;
+        if (x_end > _dirty_col_end[page])
+            _dirty_col_end[page] = (uint8_t)x_end;
+    }
+}
+
+}
+
+// EOF
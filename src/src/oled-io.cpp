@@ -0,0 +1,71 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : oled-io.cpp
+// Purpose     : SSD1306 Partial Addressing
+// Description : This source file implements header file oled-io.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "oled-io.h"
+
+namespace Demo
+{
+
+// SSD1306 control bytes and commands
+static const uint8_t OLED_CONTROL_CMD    = 0x00;
+static const uint8_t OLED_CONTROL_DATA   = 0x40;
+static const uint8_t OLED_SET_COL_ADDR   = 0x21;
+static const uint8_t OLED_SET_PAGE_ADDR  = 0x22;
+
+OLEDIO::OLEDIO(HAL::I2C& i2c_bus, uint8_t address, uint8_t width)
+: _i2c_bus(i2c_bus)
+, _address(address)
+, _width(width)
+, _bytes_sent(0)
+{ }
+
+uint8_t OLEDIO::command(const uint8_t * cmds, uint32_t len)
+{
+    _bytes_sent += len + 2; // Address and control bytes
+    return _i2c_bus.write(_address, OLED_CONTROL_CMD, const_cast<uint8_t *>(cmds), len);
+}
+
+uint8_t OLEDIO::writeWindow(const uint8_t * buffer, uint8_t col_start, uint8_t col_end,
+                            uint8_t page_start, uint8_t page_end)
+{
+    uint8_t window[6] = { OLED_SET_COL_ADDR, col_start, col_end, OLED_SET_PAGE_ADDR, page_start, page_end };
+    uint8_t span      = col_end - col_start + 1;
+    uint8_t error     = command(window, sizeof(window));
+
+    // Address pointer wraps within the window, so rows are sent back to back
+    for (uint8_t page = page_start; (page <= page_end) && (0 == error); ++page)
+    {
+        const uint8_t * row = &buffer[(uint32_t)page * _width + col_start];
+
+        for (uint8_t offset = 0; (offset < span) && (0 == error); offset += OLED_DATA_CHUNK)
+        {
+            uint8_t chunk = ((span - offset) < OLED_DATA_CHUNK) ? (span - offset) : OLED_DATA_CHUNK;
+            error = _i2c_bus.write(_address, OLED_CONTROL_DATA, const_cast<uint8_t *>(&row[offset]), chunk);
+            _bytes_sent += chunk + 2;
+        }
+    }
+
+    return error;
+}
+
+uint32_t OLEDIO::bytesSent() const
+{
+    return _bytes_sent;
+}
+
+void OLEDIO::clearBytesSent()
+{
+    _bytes_sent = 0;
+}
+
+}
+
+// EOF
@@ -0,0 +1,96 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : oled-ticker.cpp
+// Purpose     : Streaming Text Ticker for SSD1306
+// Description : This source file implements header file oled-ticker.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "oled-ticker.h"
+
+namespace Demo
+{
+
+// SSD1306 scroll and start line commands
+static const uint8_t OLED_DEACTIVATE_SCROLL = 0x2E;
+static const uint8_t OLED_SET_START_LINE    = 0x40;
+
+// Default font height at text size 1, equal to one page
+static const uint8_t LINE_HEIGHT = 8;
+static const uint8_t CHAR_WIDTH  = 6;
+static const uint8_t MAX_CHARS   = 21;
+
+OLEDTicker::OLEDTicker(PeripheralIO::SSD1306& display, OLEDIO& oled)
+: _display(display)
+, _oled(oled)
+, _pages(0)
+, _head(0)
+{ }
+
+uint8_t OLEDTicker::begin()
+{
+    uint8_t cmd   = OLED_DEACTIVATE_SCROLL;
+    uint8_t error = _oled.command(&cmd, 1);
+
+    _pages = _display.height() / LINE_HEIGHT;
+    _head  = 0;
+
+    _display.clearDisplay();
+
+    if (0 == error)
+        error = _oled.writeWindow(_display.getBuffer(), 0, _display.width() - 1, 0, _pages - 1);
+
+    if (0 == error)
+        error = setStartLine(0);
+
+    return error;
+}
+
+uint8_t OLEDTicker::println(const char * str)
+{
+    char    line[MAX_CHARS + 1];
+    uint8_t y     = _head * LINE_HEIGHT;
+    uint8_t chars = _display.width() / CHAR_WIDTH;
+    uint8_t error = 0;
+
+    if (0 == _pages) return 1; // Not begun
+
+    // Truncate rather than let the driver wrap text into the next page
+    if (chars > MAX_CHARS) chars = MAX_CHARS;
+    strncpy(line, str, chars);
+    line[chars] = '\0';
+
+    // Oldest page is overwritten with the new line
+    _display.fillRect(0, y, _display.width(), LINE_HEIGHT, SSD1306_BLACK);
+    _display.setCursor(0, y);
+    _display.print(line);
+
+    error = _oled.writeWindow(_display.getBuffer(), 0, _display.width() - 1, _head, _head);
+
+    _head = (_head + 1) % _pages;
+
+    // Top of panel now shows the page following the newest line, i.e. the oldest
+    if (0 == error)
+        error = setStartLine(_head * LINE_HEIGHT);
+
+    return error;
+}
+
+uint8_t OLEDTicker::end()
+{
+    _head = 0;
+    return setStartLine(0);
+}
+
+uint8_t OLEDTicker::setStartLine(uint8_t line)
+{
+    uint8_t cmd = OLED_SET_START_LINE | (line & 0x3F);
+    return _oled.command(&cmd, 1);
+}
+
+}
+
+// EOF
@@ -0,0 +1,106 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : rtc-tick.cpp
+// Purpose     : RTC Square-Wave Second Tick
+// Description : This source file implements header file rtc-tick.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "rtc-tick.h"
+
+namespace Demo
+{
+
+// DS3232 control register; all bits clear selects 1 Hz on INT/SQW (INTCN=0, RS2:RS1=00) with oscillator enabled
+static const uint8_t DS3232_CONTROL     = 0x0E;
+static const uint8_t DS3232_CONTROL_1HZ = 0x00;
+
+volatile uint32_t RTCTick::_ticks   = 0;
+volatile uint32_t RTCTick::_edge_ms = 0;
+
+RTCTick::RTCTick(HAL::I2C& i2c_bus, uint8_t sqw_pin, uint8_t address)
+: _i2c_bus(i2c_bus)
+, _sqw_pin(sqw_pin)
+, _address(address)
+, _base_time(0)
+, _base_ticks(0)
+, _aligned(false)
+{ }
+
+uint8_t RTCTick::begin(time_t t)
+{
+    uint8_t error;
+
+    // Time runs from here even if the square wave cannot be enabled
+    sync(t, false);
+
+    error = _i2c_bus.write(_address, DS3232_CONTROL, DS3232_CONTROL_1HZ);
+
+    if (0 != error) return error;
+
+    _sqw_pin.pinMode(GPIO_INPUT_PULLUP);
+    _sqw_pin.attachInterrupt(tickISR, GPIO_FALLING);
+
+    return 0;
+}
+
+void RTCTick::sync(time_t t, bool aligned)
+{
+    {
+        HAL::CriticalSection lock;
+
+        _base_ticks = _ticks;
+        _edge_ms    = HAL::millis();
+    }
+
+    _base_time = t;
+    _aligned   = aligned;
+}
+
+bool RTCTick::aligned() const
+{
+    return _aligned;
+}
+
+time_t RTCTick::now() const
+{
+    return _base_time + (time_t)elapsed();
+}
+
+uint32_t RTCTick::sinceSync() const
+{
+    return elapsed();
+}
+
+// Seconds since sync: square wave edges, plus whole seconds of millis() once the edges have stopped
+uint32_t RTCTick::elapsed() const
+{
+    uint32_t ticks;
+    uint32_t gap_ms;
+
+    {
+        HAL::CriticalSection lock;
+
+        ticks  = _ticks;
+        gap_ms = HAL::millis() - _edge_ms;
+    }
+
+    return (ticks - _base_ticks) + ((gap_ms > RTC_EDGE_TIMEOUT_MS) ? (gap_ms / 1000) : 0);
+}
+
+// An edge after a gap counts the seconds of the gap, rounded, so time continues from the millis() count
+void RTCTick::tickISR()
+{
+    uint32_t ms     = HAL::millis();
+    uint32_t gap_ms = ms - _edge_ms;
+
+    _ticks   = _ticks + ((gap_ms > RTC_EDGE_TIMEOUT_MS) ? ((gap_ms + 500) / 1000) : 1);
+    _edge_ms = ms;
+}
+
+}
+
+// EOF
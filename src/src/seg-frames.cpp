@@ -0,0 +1,71 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : seg-frames.cpp
+// Purpose     : Precomputed 7-Segment Multiplex Frames
+// Description : This source file implements header file seg-frames.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "seg-frames.h"
+
+namespace Demo
+{
+
+// Segment patterns for digits 0-9; bit 0 is segment A through bit 6 segment G
+static const uint8_t SEGMENT_DIGITS[10] =
+{
+    0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F
+};
+
+SegmentFrames::SegmentFrames(HAL::GPIOPort& port)
+: _port(port)
+, _frames()
+, _active(_frames[0])
+, _back(1)
+, _digit(0)
+, _value(0xFFFF)
+{ }
+
+void SegmentFrames::init()
+{
+    _port.init();
+    _port.portMode(GPIO_OUTPUT);
+    write(0);
+}
+
+void SegmentFrames::write(uint16_t val)
+{
+    uint16_t * frames = _frames[_back];
+
+    if (val > MAX_VALUE) val = MAX_VALUE;
+    if (val == _value) return;
+
+    _value = val;
+
+    // Fill from rightmost digit; leading zeros blank but the last digit always shows
+    for (int8_t digit = DIGITS - 1; digit >= 0; --digit)
+    {
+        uint8_t pattern = ((val > 0) || (DIGITS - 1 == digit)) ? SEGMENT_DIGITS[val % 10] : 0;
+
+        frames[digit] = ((uint16_t)(1 << digit) << 8) | pattern;
+        val /= 10;
+    }
+
+    // The encoded frames must be in memory before the ISR can see them
+    HAL::compilerBarrier();
+    _active = frames;
+    _back  ^= 1;
+}
+
+void SegmentFrames::refresh()
+{
+    _port.write(_active[_digit]);
+    _digit = (_digit + 1) & (DIGITS - 1);
+}
+
+}
+
+// EOF
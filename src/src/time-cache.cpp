@@ -0,0 +1,100 @@
+//--------------------------------------------------------------------------------------------------------------------
+// Name        : time-cache.cpp
+// Purpose     : Cached Broken-Down Time
+// Description : This source file implements header file time-cache.h.
+// Language    : C++
+// Platform    : Portable
+// Framework   : Portable
+// Copyright   : MIT License 2024, John Greenwell
+//--------------------------------------------------------------------------------------------------------------------
+
+#include <Arduino.h>
+#include "time-cache.h"
+
+namespace Demo
+{
+
+// Days per month for a non-leap year, January first
+static const uint8_t DAYS_IN_MONTH[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+static uint8_t daysInMonth(uint8_t month, uint8_t tm_year)
+{
+    uint16_t year = tmYearToCalendar(tm_year);
+    bool     leap = (0 == (year % 4)) && ((0 != (year % 100)) || (0 == (year % 400)));
+
+    return ((2 == month) && leap) ? 29 : DAYS_IN_MONTH[month - 1];
+}
+
+TimeCache::TimeCache()
+: _tm()
+, _time(0)
+, _valid(false)
+, _full_updates(0)
+, _incremental_updates(0)
+{ }
+
+bool TimeCache::update(time_t t)
+{
+    if (_valid && (t == _time)) return false;
+
+    if (_valid && (t == _time + 1))
+    {
+        advance();
+        ++_incremental_updates;
+    }
+    else
+    {
+        breakTime(t, _tm);
+        ++_full_updates;
+    }
+
+    _time  = t;
+    _valid = true;
+
+    return true;
+}
+
+const tmElements_t& TimeCache::fields() const
+{
+    return _tm;
+}
+
+time_t TimeCache::time() const
+{
+    return _time;
+}
+
+uint32_t TimeCache::fullUpdates() const
+{
+    return _full_updates;
+}
+
+uint32_t TimeCache::incrementalUpdates() const
+{
+    return _incremental_updates;
+}
+
+void TimeCache::advance()
+{
+    if (++_tm.Second < 60) return;
+    _tm.Second = 0;
+
+    if (++_tm.Minute < 60) return;
+    _tm.Minute = 0;
+
+    if (++_tm.Hour < 24) return;
+    _tm.Hour = 0;
+
+    _tm.Wday = (_tm.Wday % 7) + 1; // Sunday is day 1
+
+    if (++_tm.Day <= daysInMonth(_tm.Month, _tm.Year)) return;
+    _tm.Day = 1;
+
+    if (++_tm.Month <= 12) return;
+    _tm.Month = 1;
+    ++_tm.Year;
+}
+
+}
+
+// EOF
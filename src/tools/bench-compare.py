@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+#----------------------------------------------------------------------------------------------------------------------
+# Name        : bench-compare.py
+# Purpose     : HAL Microbenchmark Comparison
+# Description : This script compares two captures of HAL microbenchmark output (see include/hal-bench.h). Lines
+#               other than BENCH records are ignored, so raw serial logs can be used directly. Cases are matched
+#               on name and size and the change in mean cycles is reported; cases whose mean grew by more than the
+#               threshold are flagged and make the script exit with status 1.
+#
+#               Usage: bench-compare.py BASELINE CURRENT [--threshold PERCENT]
+#
+# Language    : Python 3
+# Platform    : Host
+# Copyright   : MIT License 2024, John Greenwell
+#----------------------------------------------------------------------------------------------------------------------
+
+import argparse
+import sys
+
+
+def parse(path):
+    """Return {(case, size): (samples, min, mean, max)} from a capture."""
+    results = {}
+    with open(path, errors='replace') as capture:
+        for line in capture:
+            fields = line.strip().split(',')
+            if len(fields) != 7 or fields[0] != 'BENCH':
+                continue
+            try:
+                values = tuple(int(field) for field in fields[2:])
+            except ValueError:
+                continue
+            results[(fields[1], values[0])] = values[1:]
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare two HAL microbenchmark captures')
+    parser.add_argument('baseline')
+    parser.add_argument('current')
+    parser.add_argument('--threshold', type=float, default=5.0, help='regression threshold in percent (default 5)')
+    args = parser.parse_args()
+
+    baseline = parse(args.baseline)
+    current = parse(args.current)
+    regressions = 0
+
+    print('%-28s %6s %12s %12s %8s' % ('case', 'size', 'baseline', 'current', 'change'))
+    for key in sorted(set(baseline) | set(current)):
+        name, size = key
+        if key not in baseline or key not in current:
+            side = 'baseline' if key in baseline else 'current'
+            print('%-28s %6d   only in %s' % (name, size, side))
+            continue
+
+        before = baseline[key][2]
+        after = current[key][2]
+        change = ((after - before) * 100.0 / before) if before else (0.0 if after == 0 else float('inf'))
+        flag = ''
+        if change > args.threshold:
+            flag = '  REGRESSION'
+            regressions += 1
+        print('%-28s %6d %12d %12d %+7.1f%%%s' % (name, size, before, after, change, flag))
+
+    print('%d regression(s) above %.1f%%' % (regressions, args.threshold))
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+#----------------------------------------------------------------------------------------------------------------------
+# Name        : trace-convert.py
+# Purpose     : HAL Bus Trace Conversion
+# Description : This script converts bus trace dumps (see include/hal-trace.h) to Chrome trace JSON, viewable in
+#               chrome://tracing or Perfetto, or to VCD, viewable in GTKWave. Lines other than TRACE records are
+#               ignored, so raw serial logs can be used directly, and consecutive dumps are joined. Timestamps are
+#               32-bit microseconds on target and are unwrapped across rollover.
+#
+#               Chrome trace: one track per bus and channel, one slice per transaction named by address and
+#               lengths, with the error code in the slice arguments.
+#               VCD: per bus and channel, a busy wire plus address and error vectors.
+#
+#               Usage: trace-convert.py DUMP [-f chrome|vcd] [-o OUTPUT]
+#
+# Language    : Python 3
+# Platform    : Host
+# Copyright   : MIT License 2024, John Greenwell
+#----------------------------------------------------------------------------------------------------------------------
+
+import argparse
+import json
+import sys
+
+WRAP = 1 << 32
+
+
+def parse(path):
+    """Return records as dicts with unwrapped start and end times, in dump order."""
+    records = []
+    offset = 0
+    previous_end = None
+    with open(path, errors='replace') as dump:
+        for line in dump:
+            fields = line.strip().split(',')
+            if len(fields) != 9 or fields[0] != 'TRACE':
+                continue
+            try:
+                channel, addr, start, end, wr_len, rd_len, error = (int(field, 0) for field in fields[2:])
+            except ValueError:
+                continue
+
+            if previous_end is not None and end + offset < previous_end - WRAP // 2:
+                offset += WRAP
+            end += offset
+            start += offset
+            if start > end:
+                start -= WRAP
+            previous_end = end
+
+            records.append({'bus': fields[1], 'channel': channel, 'addr': addr, 'start': start, 'end': end,
+                            'wr_len': wr_len, 'rd_len': rd_len, 'error': error})
+    return records
+
+
+def track(record):
+    return '%s%d' % (record['bus'], record['channel'])
+
+
+def label(record):
+    text = '0x%02X' % record['addr'] if record['bus'] == 'i2c' else record['bus']
+    if record['wr_len']:
+        text += ' W%d' % record['wr_len']
+    if record['rd_len']:
+        text += ' R%d' % record['rd_len']
+    if record['error']:
+        text += ' ERR%d' % record['error']
+    return text
+
+
+def chrome(records, out):
+    tracks = sorted(set(track(record) for record in records))
+    events = [{'name': 'thread_name', 'ph': 'M', 'pid': 0, 'tid': index, 'args': {'name': name}}
+              for index, name in enumerate(tracks)]
+    for record in records:
+        events.append({
+            'name': label(record),
+            'cat': record['bus'],
+            'ph': 'X',
+            'pid': 0,
+            'tid': tracks.index(track(record)),
+            'ts': record['start'],
+            'dur': record['end'] - record['start'],
+            'args': {'addr': '0x%02X' % record['addr'], 'wr_len': record['wr_len'], 'rd_len': record['rd_len'],
+                     'error': record['error']},
+        })
+    json.dump({'traceEvents': events, 'displayTimeUnit': 'ns'}, out, indent=1)
+    out.write('\n')
+
+
+def vcd(records, out):
+    tracks = sorted(set(track(record) for record in records))
+    ids = {}
+    out.write('$timescale 1us $end\n$scope module hal $end\n')
+    for index, name in enumerate(tracks):
+        ids[name] = (chr(33 + 3 * index), chr(34 + 3 * index), chr(35 + 3 * index))
+        out.write('$var wire 1 %s %s_busy $end\n' % (ids[name][0], name))
+        out.write('$var wire 8 %s %s_addr $end\n' % (ids[name][1], name))
+        out.write('$var wire 8 %s %s_error $end\n' % (ids[name][2], name))
+    out.write('$upscope $end\n$enddefinitions $end\n')
+
+    # Ends sort before starts at the same time so back to back transactions stay distinct
+    changes = []
+    for record in records:
+        busy, addr, error = ids[track(record)]
+        changes.append((record['start'], 1, ['1' + busy, 'b{0:08b} {1}'.format(record['addr'], addr)]))
+        changes.append((record['end'], 0, ['0' + busy, 'b{0:08b} {1}'.format(record['error'], error)]))
+    changes.sort(key=lambda change: (change[0], change[1]))
+
+    origin = changes[0][0] if changes else 0
+    out.write('#0\n$dumpvars\n')
+    for name in tracks:
+        out.write('0%s\nb0 %s\nb0 %s\n' % ids[name])
+    out.write('$end\n')
+
+    time = origin
+    for when, _, values in changes:
+        if when != time:
+            time = when
+            out.write('#%d\n' % (when - origin))
+        for value in values:
+            out.write(value + '\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert HAL bus trace dumps to Chrome trace JSON or VCD')
+    parser.add_argument('dump')
+    parser.add_argument('-f', '--format', choices=('chrome', 'vcd'), default='chrome')
+    parser.add_argument('-o', '--output', help='output file (default stdout)')
+    args = parser.parse_args()
+
+    records = parse(args.dump)
+    if not records:
+        sys.stderr.write('no TRACE records in %s\n' % args.dump)
+        return 1
+
+    out = open(args.output, 'w') if args.output else sys.stdout
+    try:
+        if args.format == 'chrome':
+            chrome(records, out)
+        else:
+            vcd(records, out)
+    finally:
+        if args.output:
+            out.close()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())